@@ -0,0 +1,925 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    benchmarks/canvas_benchmark.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Measures serialization performance of all tCanvas2D and tCanvas3D commands.
+ *
+ * Every Set, Draw, Start and Append method is benchmarked for float and double
+ * (commands with variable payload at several sizes). For each benchmark, the
+ * following is reported:
+ *
+ *   ns/cmd     Time to append one command to a canvas
+ *   bytes/cmd  Size of one serialized command
+ *   draw MB/s  Throughput of appending commands
+ *   <<   MB/s  Throughput of serializing the canvas via operator <<
+ *   App. MB/s  Throughput of copying the canvas via Append()
+ *
+ * Streams of one million small commands with varying coordinates are measured separately.
+ *
+ * Drawing line strips and point clouds with half precision coordinates (see tCanvas::SetCoordinatePrecision())
+ * is measured for float and double input - as well as drawing and decoding delta encoded line strips
+ * (see tCanvas2D::DrawDeltaEncodedLineStrip()) of a planner-like path.
+ *
+ * Compressed serialization (see tCanvas::SetCompression()) of a typical 2D map and a typical
+ * 3D point cloud canvas is measured with all available codecs: compression ratio and throughput
+ * of operator << and operator >> (relative to uncompressed size).
+ *
+ * Finally, rendering a canvas with many small primitives via tCanvasRasterizer - and
+ * a large point cloud via tPointCloudRenderer - is measured (on one thread and on all hardware threads).
+ *
+ * Each measurement is repeated until it ran for at least the minimum time.
+ * All inputs are generated deterministically - so results are reproducible
+ * on the same machine (pin the process to one core, e.g. with taskset, for stable numbers).
+ *
+ * Usage: canvas_benchmark [filter] [--min_time=<seconds>]
+ *   filter  Only run benchmarks whose name contains this string
+ *
+ * Point clouds in std::deque take the element-by-element serialization path -
+ * which is how all point clouds were serialized before contiguous ranges were
+ * written with a single stream write.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rrlib/serialization/tInputStream.h"
+#include "rrlib/serialization/tMemoryBuffer.h"
+#include "rrlib/serialization/tOutputStream.h"
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+#include "rrlib/canvas/tCanvasRasterizer.h"
+#include "rrlib/canvas/tCanvasReader.h"
+#include "rrlib/canvas/tPointCloudRenderer.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Number of commands that are drawn per batch for commands with small payload */
+const size_t cBATCH_SIZE = 1000;
+
+/*! Payload sizes (number of points) of commands with variable payload */
+const size_t cPAYLOAD_SIZES[] = { 4, 64, 1024, 16384 };
+
+/*! Payload sizes of point clouds */
+const size_t cPOINT_CLOUD_SIZES[] = { 64, 4096, 262144 };
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+double min_time = 0.2;
+const char* filter = NULL;
+
+double Now()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * Calls function repeatedly until min_time has passed
+ *
+ * \return Average time per call in seconds
+ */
+template <typename TFunction>
+double Measure(TFunction function)
+{
+  function();  // warm-up
+  size_t iterations = 1;
+  while (true)
+  {
+    double start = Now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+      function();
+    }
+    double elapsed = Now() - start;
+    if (elapsed >= min_time)
+    {
+      return elapsed / iterations;
+    }
+    iterations = elapsed > 0 ? std::max<size_t>(iterations * 2, static_cast<size_t>(iterations * 1.2 * min_time / elapsed)) : iterations * 10;
+  }
+}
+
+/*!
+ * Benchmarks a batch of commands
+ *
+ * \param name Name of benchmark
+ * \param commands Number of commands that draw_batch draws
+ * \param draw_batch Function that draws commands to the canvas passed as argument
+ */
+template <typename TCanvas, typename TDrawFunction>
+void Run(const std::string& name, size_t commands, TDrawFunction draw_batch)
+{
+  if (filter && name.find(filter) == std::string::npos)
+  {
+    return;
+  }
+
+  TCanvas canvas;
+  double draw_time = Measure([&]()
+  {
+    canvas.Clear();
+    draw_batch(canvas);
+  });
+
+  rrlib::serialization::tMemoryBuffer buffer;
+  rrlib::serialization::tOutputStream stream(buffer);
+  stream << canvas;
+  stream.Flush();
+  size_t bytes = stream.GetPosition() - 8;
+  double serialize_time = Measure([&]()
+  {
+    stream.Reset(buffer);
+    stream << canvas;
+    stream.Flush();
+  });
+
+  TCanvas target;
+  double append_time = Measure([&]()
+  {
+    target.Clear();
+    target.Append(canvas);
+  });
+
+  printf("%-52s %10.1f %10.1f %10.1f %10.1f %10.1f\n", name.c_str(), draw_time * 1e9 / commands, static_cast<double>(bytes) / commands,
+         bytes / draw_time / 1e6, bytes / serialize_time / 1e6, bytes / append_time / 1e6);
+}
+
+/*!
+ * Draws the same command cBATCH_SIZE times
+ */
+template <typename TCanvas, typename TDrawFunction>
+void RunRepeated(const std::string& name, TDrawFunction draw)
+{
+  Run<TCanvas>(name, cBATCH_SIZE, [&](TCanvas & canvas)
+  {
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      draw(canvas);
+    }
+  });
+}
+
+std::string Name(const char* method, const char* element_name, size_t size = 0)
+{
+  char name[128];
+  if (size)
+  {
+    snprintf(name, sizeof(name), "%s<%s>/%zu", method, element_name, size);
+  }
+  else
+  {
+    snprintf(name, sizeof(name), "%s<%s>", method, element_name);
+  }
+  return name;
+}
+
+template <size_t Tdimension, typename TElement>
+std::vector<tVector<Tdimension, TElement>> CreatePoints(size_t count)
+{
+  std::vector<tVector<Tdimension, TElement>> points(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    for (size_t j = 0; j < Tdimension; j++)
+    {
+      points[i][j] = static_cast<TElement>(((i * 7919 + j * 104729) % 10007) * 0.01);
+    }
+  }
+  return points;
+}
+
+template <size_t Tdimension, typename TElement>
+std::vector<std::vector<TElement>> CreateChannels(size_t count)
+{
+  std::vector<tVector<Tdimension, TElement>> points = CreatePoints<Tdimension, TElement>(count);
+  std::vector<std::vector<TElement>> channels(Tdimension, std::vector<TElement>(count));
+  for (size_t i = 0; i < count; i++)
+  {
+    for (size_t j = 0; j < Tdimension; j++)
+    {
+      channels[j][i] = points[i][j];
+    }
+  }
+  return channels;
+}
+
+/*!
+ * Benchmarks state commands (identical for tCanvas2D and tCanvas3D)
+ */
+template <typename TCanvas>
+void BenchmarkStateCommands(const char* canvas_name)
+{
+  RunRepeated<TCanvas>(Name("SetColor", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetColor(255, 128, 0);
+  });
+  RunRepeated<TCanvas>(Name("SetColor(rgba)", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetColor(0xFF8000C0u);
+  });
+  RunRepeated<TCanvas>(Name("SetEdgeColor", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetEdgeColor(255, 128, 0);
+  });
+  RunRepeated<TCanvas>(Name("SetFillColor", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetFillColor(255, 128, 0);
+  });
+  RunRepeated<TCanvas>(Name("SetFill", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetFill(true);
+  });
+  RunRepeated<TCanvas>(Name("SetAlpha", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.SetAlpha(128);
+  });
+  RunRepeated<TCanvas>(Name("ResetTransformation", canvas_name), [](TCanvas & canvas)
+  {
+    canvas.ResetTransformation();
+  });
+}
+
+template <typename T>
+void BenchmarkCanvas2D(const char* element_name)
+{
+  typedef tVector<2, T> tPoint;
+  RunRepeated<tCanvas2D>(Name("2D SetDefaultViewport", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.SetDefaultViewport<T>(0, 0, 10, 10);
+  });
+  RunRepeated<tCanvas2D>(Name("2D SetTransformation", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.SetTransformation(rrlib::math::tMatrix<3, 3, T>());
+  });
+  RunRepeated<tCanvas2D>(Name("2D Transform", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.Transform(rrlib::math::tMatrix<3, 3, T>());
+  });
+  RunRepeated<tCanvas2D>(Name("2D Translate", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.Translate<T>(1, 2);
+  });
+  RunRepeated<tCanvas2D>(Name("2D Rotate", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.Rotate<T>(1);
+  });
+  RunRepeated<tCanvas2D>(Name("2D Scale", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.Scale<T>(1, 2);
+  });
+  RunRepeated<tCanvas2D>(Name("2D SetZ", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.SetZ<T>(1);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawPoint", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawPoint<T>(1, 2);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawLine", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawLine<T>(1, 2, 3, 4);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawLineSegment", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawLineSegment<T>(1, 2, 3, 4);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawArrow", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawArrow<T>(1, 2, 3, 4);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawBox", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawBox<T>(1, 2, 3, 4);
+  });
+  RunRepeated<tCanvas2D>(Name("2D DrawEllipsoid", element_name), [](tCanvas2D & canvas)
+  {
+    canvas.DrawEllipsoid<T>(1, 2, 3, 4);
+  });
+  const std::string text = "Robot";
+  RunRepeated<tCanvas2D>(Name("2D DrawText", element_name), [&text](tCanvas2D & canvas)
+  {
+    canvas.DrawText<T>(1, 2, text);
+  });
+  Run<tCanvas2D>(Name("2D StartPath+AppendLineSegment", element_name), cBATCH_SIZE + 2, [](tCanvas2D & canvas)
+  {
+    canvas.StartPath<T>(0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendLineSegment<T>(i, 1);
+    }
+    canvas.ClosePath();
+  });
+  Run<tCanvas2D>(Name("2D StartShape+AppendQuadraticBezierCurve", element_name), cBATCH_SIZE + 2, [](tCanvas2D & canvas)
+  {
+    canvas.StartShape<T>(0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendQuadraticBezierCurve<T>(i, 1, i, 2);
+    }
+    canvas.CloseShape();
+  });
+  Run<tCanvas2D>(Name("2D StartPath+AppendCubicBezierCurve", element_name), cBATCH_SIZE + 2, [](tCanvas2D & canvas)
+  {
+    canvas.StartPath<T>(0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendCubicBezierCurve<T>(i, 1, i, 2, i, 3);
+    }
+    canvas.ClosePath();
+  });
+
+  for (size_t size : cPAYLOAD_SIZES)
+  {
+    std::vector<tPoint> points = CreatePoints<2, T>(size);
+    std::vector<std::vector<T>> channels = CreateChannels<2, T>(size);
+    size_t batch = std::max<size_t>(1, cBATCH_SIZE * 4 / size);
+    Run<tCanvas2D>(Name("2D DrawLineStrip", element_name, size), batch, [&](tCanvas2D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawLineStrip(points.begin(), points.end());
+      }
+    });
+    Run<tCanvas2D>(Name("2D DrawLineStrip(x, y)", element_name, size), batch, [&](tCanvas2D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawLineStrip(channels[0].data(), channels[1].data(), size);
+      }
+    });
+    Run<tCanvas2D>(Name("2D DrawPolygon", element_name, size), batch, [&](tCanvas2D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawPolygon(points.begin(), points.end());
+      }
+    });
+    Run<tCanvas2D>(Name("2D DrawSpline", element_name, size), batch, [&](tCanvas2D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawSpline(points.begin(), points.end(), 0.5f);
+      }
+    });
+    Run<tCanvas2D>(Name("2D DrawBezierCurve", element_name, size), batch, [&](tCanvas2D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawBezierCurve(points.begin(), points.end());
+      }
+    });
+  }
+}
+
+template <typename T>
+void BenchmarkCanvas3D(const char* element_name)
+{
+  typedef tVector<3, T> tPoint;
+  RunRepeated<tCanvas3D>(Name("3D SetTransformation", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.SetTransformation(rrlib::math::tMatrix<4, 4, T>());
+  });
+  RunRepeated<tCanvas3D>(Name("3D Transform", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.Transform(rrlib::math::tMatrix<4, 4, T>());
+  });
+  RunRepeated<tCanvas3D>(Name("3D Translate", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.Translate<T>(1, 2, 3);
+  });
+  RunRepeated<tCanvas3D>(Name("3D Rotate", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.Rotate<T>(1, 2, 3);
+  });
+  RunRepeated<tCanvas3D>(Name("3D Scale", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.Scale<T>(1, 2, 3);
+  });
+  RunRepeated<tCanvas3D>(Name("3D SetZ", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.SetZ<T>(1);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawPoint", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawPoint<T>(1, 2, 3);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawLine", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawLine<T>(1, 2, 3, 4, 5, 6);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawLineSegment", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawLineSegment<T>(1, 2, 3, 4, 5, 6);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawArrow", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawArrow<T>(1, 2, 3, 4, 5, 6);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawBox", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawBox<T>(1, 2, 3, 4, 5, 6);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawEllipsoid", element_name), [](tCanvas3D & canvas)
+  {
+    canvas.DrawEllipsoid<T>(1, 2, 3, 4, 5, 6);
+  });
+  const std::string text = "Robot";
+  RunRepeated<tCanvas3D>(Name("3D DrawText", element_name), [&text](tCanvas3D & canvas)
+  {
+    canvas.DrawText<T>(1, 2, 3, text);
+  });
+  RunRepeated<tCanvas3D>(Name("3D DrawText(2D)", element_name), [&text](tCanvas3D & canvas)
+  {
+    canvas.DrawText<T>(1, 2, text);
+  });
+  Run<tCanvas3D>(Name("3D StartPath+AppendLineSegment", element_name), cBATCH_SIZE + 2, [](tCanvas3D & canvas)
+  {
+    canvas.StartPath<T>(0, 0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendLineSegment<T>(i, 1, 2);
+    }
+    canvas.ClosePath();
+  });
+  Run<tCanvas3D>(Name("3D StartShape+AppendQuadraticBezierCurve", element_name), cBATCH_SIZE + 2, [](tCanvas3D & canvas)
+  {
+    canvas.StartShape<T>(0, 0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendQuadraticBezierCurve<T>(i, 1, 2, i, 2, 3);
+    }
+    canvas.CloseShape();
+  });
+  Run<tCanvas3D>(Name("3D StartPath+AppendCubicBezierCurve", element_name), cBATCH_SIZE + 2, [](tCanvas3D & canvas)
+  {
+    canvas.StartPath<T>(0, 0, 0);
+    for (size_t i = 0; i < cBATCH_SIZE; i++)
+    {
+      canvas.AppendCubicBezierCurve<T>(i, 1, 2, i, 2, 3, i, 3, 4);
+    }
+    canvas.ClosePath();
+  });
+
+  for (size_t size : cPAYLOAD_SIZES)
+  {
+    std::vector<tPoint> points = CreatePoints<3, T>(size);
+    std::vector<std::vector<T>> channels = CreateChannels<3, T>(size);
+    size_t batch = std::max<size_t>(1, cBATCH_SIZE * 4 / size);
+    Run<tCanvas3D>(Name("3D DrawLineStrip", element_name, size), batch, [&](tCanvas3D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawLineStrip(points.begin(), points.end());
+      }
+    });
+    Run<tCanvas3D>(Name("3D DrawLineStrip(x, y, z)", element_name, size), batch, [&](tCanvas3D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawLineStrip(channels[0].data(), channels[1].data(), channels[2].data(), size);
+      }
+    });
+    Run<tCanvas3D>(Name("3D DrawPolygon", element_name, size), batch, [&](tCanvas3D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawPolygon(points.begin(), points.end());
+      }
+    });
+    Run<tCanvas3D>(Name("3D DrawBezierCurve", element_name, size), batch, [&](tCanvas3D & canvas)
+    {
+      for (size_t i = 0; i < batch; i++)
+      {
+        canvas.DrawBezierCurve(points.begin(), points.end());
+      }
+    });
+  }
+
+  for (size_t size : cPOINT_CLOUD_SIZES)
+  {
+    std::vector<tPoint> points = CreatePoints<3, T>(size);
+    std::deque<tPoint> point_deque(points.begin(), points.end());
+    std::vector<std::vector<T>> channels = CreateChannels<3, T>(size);
+    std::vector<tVector<6, T>> colored_points = CreatePoints<6, T>(size);
+    std::vector<uint32_t> colors(size, 0xFF8000FFu);
+    tVoxelGridFilter filter(0.5);
+    tPointCloudLODBuilder builder;
+    builder.Build(points.begin(), points.end());
+    Run<tCanvas3D>(Name("3D DrawPointCloud", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawPointCloud(points.begin(), points.end());
+    });
+    Run<tCanvas3D>(Name("3D DrawPointCloud(std::deque)", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawPointCloud(point_deque.begin(), point_deque.end());
+    });
+    Run<tCanvas3D>(Name("3D DrawPointCloud(x, y, z)", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawPointCloud(channels[0].data(), channels[1].data(), channels[2].data(), size);
+    });
+    Run<tCanvas3D>(Name("3D DrawPointCloud(voxel grid)", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawPointCloud(points.begin(), points.end(), filter);
+    });
+    Run<tCanvas3D>(Name("3D DrawPointCloudLOD", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawPointCloudLOD(points.begin(), points.end(), builder);
+    });
+    Run<tCanvas3D>(Name("3D DrawQuantizedPointCloud", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawQuantizedPointCloud(points.begin(), points.end(), 0.01);
+    });
+    Run<tCanvas3D>(Name("3D DrawColoredPointCloud", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawColoredPointCloud(colored_points.begin(), colored_points.end());
+    });
+    Run<tCanvas3D>(Name("3D DrawRGBPointCloud", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawRGBPointCloud(colored_points.begin(), colored_points.end());
+    });
+    Run<tCanvas3D>(Name("3D DrawRGBPointCloud(colors)", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.DrawRGBPointCloud(points.begin(), points.end(), colors.begin());
+    });
+  }
+}
+
+/*!
+ * Benchmarks a stream of one million small commands with varying coordinates (as drawn by typical visualization code)
+ */
+template <typename T>
+void BenchmarkSmallCommands(const char* element_name)
+{
+  const size_t cCOMMANDS = 1000000;
+  std::vector<tVector<2, T>> points_2d = CreatePoints<2, T>(cCOMMANDS + 1);
+  std::vector<tVector<3, T>> points_3d = CreatePoints<3, T>(cCOMMANDS + 1);
+  Run<tCanvas2D>(Name("Small commands 2D DrawPoint", element_name, cCOMMANDS), cCOMMANDS, [&](tCanvas2D & canvas)
+  {
+    for (size_t i = 0; i < cCOMMANDS; i++)
+    {
+      canvas.DrawPoint(points_2d[i]);
+    }
+  });
+  Run<tCanvas2D>(Name("Small commands 2D mixed", element_name, cCOMMANDS), cCOMMANDS, [&](tCanvas2D & canvas)
+  {
+    for (size_t i = 0; i < cCOMMANDS; i += 4)
+    {
+      canvas.Translate(points_2d[i]);
+      canvas.DrawLineSegment(points_2d[i + 1], points_2d[i + 2]);
+      canvas.DrawBox(points_2d[i + 2], points_2d[i + 3].X(), points_2d[i + 3].Y());
+      canvas.DrawArrow(points_2d[i + 3], points_2d[i + 4]);
+    }
+  });
+  Run<tCanvas3D>(Name("Small commands 3D DrawPoint", element_name, cCOMMANDS), cCOMMANDS, [&](tCanvas3D & canvas)
+  {
+    for (size_t i = 0; i < cCOMMANDS; i++)
+    {
+      canvas.DrawPoint(points_3d[i]);
+    }
+  });
+  Run<tCanvas3D>(Name("Small commands 3D mixed", element_name, cCOMMANDS), cCOMMANDS, [&](tCanvas3D & canvas)
+  {
+    for (size_t i = 0; i < cCOMMANDS; i += 4)
+    {
+      canvas.Translate(points_3d[i]);
+      canvas.DrawLineSegment(points_3d[i + 1], points_3d[i + 2]);
+      canvas.DrawBox(points_3d[i + 2], points_3d[i + 3].X(), points_3d[i + 3].Y(), points_3d[i + 3].Z());
+      canvas.DrawLine(points_3d[i + 3], points_3d[i + 4]);
+    }
+  });
+}
+
+/*!
+ * Benchmarks drawing coordinates with half precision (see tCanvas::SetCoordinatePrecision())
+ */
+template <typename T>
+void BenchmarkHalfPrecision(const char* element_name)
+{
+  const size_t cSIZES[] = { 1024, 16384 };
+  for (size_t size : cSIZES)
+  {
+    std::vector<tVector<2, T>> points_2d = CreatePoints<2, T>(size);
+    std::vector<std::vector<T>> channels_2d = CreateChannels<2, T>(size);
+    std::vector<tVector<3, T>> points_3d = CreatePoints<3, T>(size);
+    Run<tCanvas2D>(Name("Half precision 2D DrawLineStrip", element_name, size), 1, [&](tCanvas2D & canvas)
+    {
+      canvas.SetCoordinatePrecision(eHALF_PRECISION);
+      canvas.DrawLineStrip(points_2d.begin(), points_2d.end());
+    });
+    Run<tCanvas2D>(Name("Half precision 2D DrawLineStrip(x, y)", element_name, size), 1, [&](tCanvas2D & canvas)
+    {
+      canvas.SetCoordinatePrecision(eHALF_PRECISION);
+      canvas.DrawLineStrip(channels_2d[0].data(), channels_2d[1].data(), size);
+    });
+    Run<tCanvas3D>(Name("Half precision 3D DrawPointCloud", element_name, size), 1, [&](tCanvas3D & canvas)
+    {
+      canvas.SetCoordinatePrecision(eHALF_PRECISION);
+      canvas.DrawPointCloud(points_3d.begin(), points_3d.end());
+    });
+  }
+}
+
+/*!
+ * Benchmarks delta encoded line strips of a planner-like path (see tCanvas2D::DrawDeltaEncodedLineStrip())
+ */
+template <typename T>
+void BenchmarkDeltaEncoding(const char* element_name)
+{
+  // Smooth path with 5cm steps
+  const size_t cPOINTS = 16384;
+  std::vector<tVector<2, T>> path;
+  double x = 12.3, y = -4.5, heading = 0;
+  for (size_t i = 0; i < cPOINTS; i++)
+  {
+    heading += 0.02 * std::sin(i * 0.001);
+    x += 0.05 * std::cos(heading);
+    y += 0.05 * std::sin(heading);
+    path.emplace_back(x, y);
+  }
+  Run<tCanvas2D>(Name("Delta encoding 2D DrawLineStrip", element_name, cPOINTS), 1, [&](tCanvas2D & canvas)
+  {
+    canvas.DrawLineStrip(path.begin(), path.end());
+  });
+  Run<tCanvas2D>(Name("Delta encoding 2D DrawDeltaEncodedLineStrip(1mm)", element_name, cPOINTS), 1, [&](tCanvas2D & canvas)
+  {
+    canvas.DrawDeltaEncodedLineStrip(path.begin(), path.end(), 0.001);
+  });
+
+  std::string name = Name("Delta encoding 2D DecodeDeltaEncodedPoints(1mm)", element_name, cPOINTS);
+  if (filter && name.find(filter) == std::string::npos)
+  {
+    return;
+  }
+  tCanvas2D canvas;
+  canvas.DrawDeltaEncodedLineStrip(path.begin(), path.end(), 0.001);
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  reader.Next(command);
+  std::vector<T> decoded(cPOINTS * 2);
+  double decode_time = Measure([&]()
+  {
+    command.DecodeDeltaEncodedPoints(decoded.data());
+  });
+  printf("%-52s %10.1f ns/point %10.1f MB/s (decoded)\n", name.c_str(), decode_time * 1e9 / cPOINTS, decoded.size() * sizeof(T) / decode_time / 1e6);
+}
+
+/*!
+ * Measures compressed serialization of canvas with all available codecs
+ */
+template <typename TCanvas>
+void RunCompression(const std::string& name, TCanvas& canvas)
+{
+  const tCompression cCODECS[] = { eNO_COMPRESSION, eLZ4, eZSTD };
+  const char* cCODEC_NAMES[] = { "none", "LZ4", "zstd" };
+  for (size_t i = 0; i < 3; i++)
+  {
+    std::string full_name = name + " (" + cCODEC_NAMES[i] + ")";
+    if ((filter && full_name.find(filter) == std::string::npos) || (!canvas.SetCompression(cCODECS[i])))
+    {
+      continue;
+    }
+    rrlib::serialization::tMemoryBuffer buffer;
+    rrlib::serialization::tOutputStream stream(buffer);
+    double serialize_time = Measure([&]()
+    {
+      stream.Reset(buffer);
+      stream << canvas;
+      stream.Flush();
+    });
+    size_t bytes = stream.GetPosition() - 8;
+
+    TCanvas target;
+    double deserialize_time = Measure([&]()
+    {
+      rrlib::serialization::tInputStream input(buffer);
+      input >> target;
+    });
+    printf("%-52s %10.2f x %10.1f << MB/s %10.1f >> MB/s\n", full_name.c_str(), static_cast<double>(canvas.GetSize()) / bytes,
+           canvas.GetSize() / serialize_time / 1e6, canvas.GetSize() / deserialize_time / 1e6);
+  }
+  canvas.SetCompression(eNO_COMPRESSION);
+}
+
+void BenchmarkCompression()
+{
+  // Occupancy grid map (occupied cells as boxes) with robot trajectory
+  tCanvas2D map;
+  map.SetDefaultViewport(0.0, 0.0, 50.0, 50.0);
+  map.SetFill(true);
+  for (size_t y = 0; y < 500; y++)
+  {
+    for (size_t x = 0; x < 500; x++)
+    {
+      size_t cell = (x / 7) * 31 + (y / 5) * 17 + (x * y) % 3;
+      if (cell % 4 == 0)
+      {
+        map.SetColor(cell % 8 ? 0 : 128, 0, 0);
+        map.DrawBox(x * 0.1f, y * 0.1f, 0.1f, 0.1f);
+      }
+    }
+  }
+  std::vector<tVector<2, float>> trajectory;
+  for (size_t i = 0; i < 20000; i++)
+  {
+    trajectory.emplace_back(25 + 20 * std::cos(i * 0.001f), 25 + 20 * std::sin(i * 0.0013f));
+  }
+  map.DrawLineStrip(trajectory.begin(), trajectory.end());
+  RunCompression("Compression 2D map", map);
+
+  // Point cloud of a rotating laser scanner (64 rings) in a room
+  tCanvas3D cloud;
+  std::vector<tVector<3, float>> points;
+  for (size_t ring = 0; ring < 64; ring++)
+  {
+    float elevation = -0.4f + ring * 0.0125f;
+    for (size_t i = 0; i < 2048; i++)
+    {
+      float azimuth = i * 6.2831853f / 2048;
+      float distance = std::min(5.0f / std::max(0.05f, std::abs(std::cos(azimuth))), std::min(8.0f, 1.5f / std::max(0.05f, std::abs(std::sin(elevation)))));
+      points.emplace_back(distance * std::cos(elevation) * std::cos(azimuth), distance * std::cos(elevation) * std::sin(azimuth), distance * std::sin(elevation));
+    }
+  }
+  cloud.DrawPointCloud(points.begin(), points.end());
+  RunCompression("Compression 3D cloud", cloud);
+}
+
+/*!
+ * Benchmarks rendering a canvas with many small primitives with tCanvasRasterizer
+ */
+void BenchmarkRasterizer()
+{
+  const size_t cPRIMITIVES = 100000;
+  tCanvas2D canvas;
+  canvas.SetDefaultViewport(0.0, 0.0, 1920.0, 1080.0);
+  canvas.SetFill(true);
+  for (size_t i = 0; i < cPRIMITIVES; i++)
+  {
+    double x = (i * 7919) % 1920, y = (i * 104729) % 1080;
+    canvas.SetColor(i & 0xFF, (i * 7) & 0xFF, (i * 13) & 0xFF);
+    canvas.SetAlpha(i % 3 ? 255 : 160);
+    switch (i % 5)
+    {
+    case 0:
+      canvas.DrawBox(x, y, 20.0, 15.0);
+      break;
+    case 1:
+      canvas.DrawEllipsoid(x, y, 16.0, 16.0);
+      break;
+    case 2:
+      canvas.DrawLineSegment(x, y, x + 30, y + 10);
+      break;
+    case 3:
+      canvas.DrawPolygon(tVector<2, double>(x, y), tVector<2, double>(x + 20, y), tVector<2, double>(x + 10, y + 20));
+      break;
+    default:
+      canvas.DrawPoint(x, y);
+      break;
+    }
+  }
+
+  unsigned int thread_counts[] = { 1, std::max(1u, std::thread::hardware_concurrency()) };
+  for (size_t i = 0; i < (thread_counts[1] > 1 ? 2 : 1); i++)
+  {
+    char name[128];
+    snprintf(name, sizeof(name), "2D Rasterize 1920x1080/%zu (%u threads)", cPRIMITIVES, thread_counts[i]);
+    if (filter && std::string(name).find(filter) == std::string::npos)
+    {
+      continue;
+    }
+    tCanvasRasterizer rasterizer(1920, 1080, thread_counts[i]);
+    double render_time = Measure([&]()
+    {
+      rasterizer.Render(canvas);
+    });
+    printf("%-52s %10.1f ms/frame\n", name, render_time * 1e3);
+  }
+}
+
+void BenchmarkPointCloudRenderer()
+{
+  const size_t cPOINTS = 5000000;
+  std::vector<tVector<3, float>> points;
+  points.reserve(cPOINTS);
+  for (size_t i = 0; i < cPOINTS; i++)
+  {
+    points.emplace_back(((i * 7919) % 10007) / 5003.5f - 1, ((i * 104729) % 10009) / 5004.5f - 1, ((i * 1299709) % 10037) / 5018.5f - 1);
+  }
+  tCanvas3D canvas;
+  canvas.DrawPointCloud(points.begin(), points.end());
+  rrlib::math::tMatrix<4, 4, double> camera_pose;
+  for (size_t i = 0; i < 4; i++)
+  {
+    camera_pose[i][i] = 1;
+  }
+  camera_pose[2][3] = -4;
+
+  unsigned int thread_counts[] = { 1, std::max(1u, std::thread::hardware_concurrency()) };
+  for (size_t i = 0; i < (thread_counts[1] > 1 ? 2 : 1); i++)
+  {
+    char name[128];
+    snprintf(name, sizeof(name), "3D Point splatting 1920x1080/%zu (%u threads)", cPOINTS, thread_counts[i]);
+    if (filter && std::string(name).find(filter) == std::string::npos)
+    {
+      continue;
+    }
+    tPointCloudRenderer renderer(1920, 1080, thread_counts[i]);
+    renderer.SetCamera(camera_pose, 1000, 1000, 960, 540);
+    double render_time = Measure([&]()
+    {
+      renderer.Render(canvas);
+    });
+    printf("%-52s %10.1f ms/frame\n", name, render_time * 1e3);
+  }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strncmp(argv[i], "--min_time=", 11) == 0)
+    {
+      min_time = atof(argv[i] + 11);
+    }
+    else
+    {
+      filter = argv[i];
+    }
+  }
+
+  printf("%-52s %10s %10s %10s %10s %10s\n", "Benchmark", "ns/cmd", "bytes/cmd", "draw MB/s", "<< MB/s", "App. MB/s");
+  BenchmarkStateCommands<tCanvas2D>("2D");
+  BenchmarkStateCommands<tCanvas3D>("3D");
+  BenchmarkCanvas2D<float>("float");
+  BenchmarkCanvas2D<double>("double");
+  BenchmarkCanvas3D<float>("float");
+  BenchmarkCanvas3D<double>("double");
+  BenchmarkSmallCommands<float>("float");
+  BenchmarkSmallCommands<double>("double");
+  BenchmarkHalfPrecision<float>("float");
+  BenchmarkHalfPrecision<double>("double");
+  BenchmarkDeltaEncoding<float>("float");
+  BenchmarkDeltaEncoding<double>("double");
+  BenchmarkCompression();
+  BenchmarkRasterizer();
+  BenchmarkPointCloudRenderer();
+  return 0;
+}
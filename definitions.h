@@ -38,6 +38,8 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
 
 //----------------------------------------------------------------------
 // Internal includes with ""
@@ -65,6 +67,8 @@ namespace canvas
  * [vector] is 2 coordinates in 2D and 3 coordinates in 3D mode.
  * K is 2 in 2D and 3 in 3D mode.
  * Values are encoded as float or double depending on canvas mode.
+ * Each sequence of values (e.g. [vector1]...[vectorN] or [double: ...]) is preceded by
+ * a tNumberTypeEnum byte (uint8) that specifies their type.
  *
  * Important: Any new opcodes must be appended to the back to retain
  *            binary compatibility
@@ -123,7 +127,43 @@ enum tCanvasOpCode
   // ####### Opcodes added after Finroc 13.10 ########
 
   eDEFAULT_VIEWPORT,              // 2d: [left,bottom,width,height]  3d: yet undefined (could be tPose3D)
-  eDEFAULT_VIEWPORT_OFFSET        // [int64 absolute offset]
+  eDEFAULT_VIEWPORT_OFFSET,       // [int64 absolute offset]
+
+  // ####### Compact encodings ########
+
+  eDRAW_QUANTIZED_POINT_CLOUD,    // [number of values: N][double: offset vector][double: step][uint16: vector1]...[vectorN] (point = offset + step * vector)
+  eDRAW_RGB_POINT_CLOUD,          // [number of values: N][bool: alpha][vector1]...[vectorN][RGB(A): 3(4) bytes]...[RGB(A)N]
+  eDRAW_POINT_CLOUD_LOD,          // [number of levels: L][int32: points in level 1]...[points in level L][vector1]...[vectorN] (vectors sorted by level - coarse first)
+
+  // ####### Delta encoding (see tCanvasDelta.h) ########
+
+  eDELTA_KEYFRAME,                // [int32: frame number][int64: default viewport offset] - followed by all commands of frame
+  eDELTA_FRAME,                   // [int32: frame number][int32: number of previous frame][int64: default viewport offset] - followed by new commands and eDELTA_COPY commands
+  eDELTA_COPY,                    // [int32: index of first command in previous frame][int32: number of commands]
+
+  // ####### Compression (see tCanvas::SetCompression()) ########
+
+  eCOMPRESSED,                    // [uint8: tCompression][int64: uncompressed size] - followed by blocks: [uint32: uncompressed size][uint32: compressed size][data] (stored uncompressed if sizes are equal)
+
+  // ####### Compact encodings (continued) ########
+
+  eDRAW_DELTA_ENCODED_POINTS,     // [uint8: eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE][uint32: number of values: N][float: tension (splines only)][uint8: eDOUBLE][double: first point][double: step][zigzag varints: q2 - q1]...[qN - qN-1] (qi = round((vectori - vector1) / step) per coordinate - no number type byte before varints)
+
+  // ####### 32 bit point counts (tCanvas2D - see tCanvas::SetLegacyPointCounts()) ########
+
+  eDRAW_LINE_STRIP_LONG,          // [uint32: number of values: N][vector1]...[vectorN]
+  eDRAW_POLYGON_LONG,             // [uint32: number of values: N][vector1]...[vectorN]
+  eDRAW_SPLINE_LONG               // [float: tension-parameter][uint32: number of values: N][vector1]...[vectorN]
+};
+
+/*!
+ * Codecs for compressed serialization of canvases
+ */
+enum tCompression
+{
+  eNO_COMPRESSION,
+  eLZ4,     // requires liblz4 (_LIB_LZ4_PRESENT_)
+  eZSTD     // requires libzstd (_LIB_ZSTD_PRESENT_)
 };
 
 enum tNumberTypeEnum
@@ -138,7 +178,17 @@ enum tNumberTypeEnum
   eINT32,
   eUINT32,
   eINT64,
-  eUINT64
+  eUINT64,
+  eHALF     // IEEE 754 half precision (binary16) - written for float and double coordinates with eHALF_PRECISION
+};
+
+/*!
+ * Precision with which coordinates of primitives are serialized (see tCanvas::SetCoordinatePrecision())
+ */
+enum tCoordinatePrecision
+{
+  eFULL_PRECISION,  // coordinates are written with the number type they are passed with
+  eHALF_PRECISION   // float and double coordinates are written as eHALF (range +-65504; relative precision about 1/2048)
 };
 
 template <typename T>
@@ -185,6 +235,34 @@ template <> struct tNumberType<uint64_t>
   const static tNumberTypeEnum value = eUINT64;
 };
 
+/*!
+ * \param number_type Number type
+ * \return Size of a single value of the specified number type in bytes (0 for unknown types and eZEROES)
+ */
+inline size_t GetNumberTypeSize(tNumberTypeEnum number_type)
+{
+  switch (number_type)
+  {
+  case eINT8:
+  case eUINT8:
+    return 1;
+  case eINT16:
+  case eUINT16:
+  case eHALF:
+    return 2;
+  case eFLOAT:
+  case eINT32:
+  case eUINT32:
+    return 4;
+  case eDOUBLE:
+  case eINT64:
+  case eUINT64:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
 }
 }
 
@@ -0,0 +1,201 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    internal/byte_order.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains CopyLittleEndian() and SwapByteOrder()
+ *
+ * Canvas data is little endian. On big endian platforms, values are byte-swapped while
+ * they are copied to the output buffer - 16 bytes at a time with SSSE3 or NEON instructions
+ * if available (other platforms use a scalar loop that compilers usually vectorize).
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__internal__byte_order_h__
+#define __rrlib__canvas__internal__byte_order_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+namespace internal
+{
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*!
+ * Reverses bytes of a single value
+ */
+inline uint16_t ByteSwap(uint16_t value)
+{
+  return __builtin_bswap16(value);
+}
+
+inline uint32_t ByteSwap(uint32_t value)
+{
+  return __builtin_bswap32(value);
+}
+
+inline uint64_t ByteSwap(uint64_t value)
+{
+  return __builtin_bswap64(value);
+}
+
+/*!
+ * Unsigned integer type with the specified size
+ */
+template <size_t Tsize>
+struct tUnsigned;
+
+template <>
+struct tUnsigned<2>
+{
+  typedef uint16_t type;
+};
+
+template <>
+struct tUnsigned<4>
+{
+  typedef uint32_t type;
+};
+
+template <>
+struct tUnsigned<8>
+{
+  typedef uint64_t type;
+};
+
+/*!
+ * Copies values of Telement_size bytes - reversing the bytes of each value
+ */
+template <size_t Telement_size>
+inline void SwapValues(const char* source, size_t count, char* destination)
+{
+  typedef typename tUnsigned<Telement_size>::type tValue;
+  for (size_t i = 0; i < count; i++)
+  {
+    tValue value;
+    std::memcpy(&value, source + i * Telement_size, Telement_size);
+    value = ByteSwap(value);
+    std::memcpy(destination + i * Telement_size, &value, Telement_size);
+  }
+}
+
+/*!
+ * Copies values of Telement_size bytes (2, 4 or 8) - reversing the bytes of each value
+ */
+template <size_t Telement_size>
+inline void SwapBlocks(const char* source, size_t count, char* destination)
+{
+  size_t i = 0;
+#if defined(__SSSE3__)
+  const __m128i shuffle = Telement_size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14) :
+                          (Telement_size == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+                           _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+  for (; (i + 1) * 16 <= count * Telement_size; i++)
+  {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 16), _mm_shuffle_epi8(block, shuffle));
+  }
+#elif defined(__ARM_NEON)
+  for (; (i + 1) * 16 <= count * Telement_size; i++)
+  {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(source + i * 16));
+    block = Telement_size == 2 ? vrev16q_u8(block) : (Telement_size == 4 ? vrev32q_u8(block) : vrev64q_u8(block));
+    vst1q_u8(reinterpret_cast<uint8_t*>(destination + i * 16), block);
+  }
+#endif
+  size_t done = i * 16 / Telement_size;
+  SwapValues<Telement_size>(source + done * Telement_size, count - done, destination + done * Telement_size);
+}
+
+/*!
+ * Copies values - reversing the byte order of each value
+ *
+ * \param source Values to copy
+ * \param count Number of values
+ * \param destination Buffer for count * sizeof(T) bytes (may be unaligned - must not overlap source)
+ */
+template <typename T>
+inline void SwapByteOrder(const T* source, size_t count, void* destination)
+{
+  static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "Unsupported value size");
+  if (sizeof(T) == 1)
+  {
+    if (count)
+    {
+      std::memcpy(destination, source, count);
+    }
+    return;
+  }
+  SwapBlocks < sizeof(T) == 1 ? 2 : sizeof(T) > (reinterpret_cast<const char*>(source), count, static_cast<char*>(destination));
+}
+
+/*!
+ * Copies values to buffer in little endian byte order
+ * (plain memcpy on little endian platforms)
+ *
+ * \param source Values to copy
+ * \param count Number of values
+ * \param destination Buffer for count * sizeof(T) bytes (may be unaligned - must not overlap source)
+ */
+template <typename T>
+inline void CopyLittleEndian(const T* source, size_t count, void* destination)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  SwapByteOrder(source, count, destination);
+#else
+  std::memcpy(destination, source, count * sizeof(T));
+#endif
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+}
+
+#endif
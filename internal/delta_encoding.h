@@ -0,0 +1,179 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    internal/delta_encoding.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains Quantize(), ZigZagEncode(), WriteVarint(), their inverses and DecodeDeltaEncodedPoints()
+ *
+ * Helpers for eDRAW_DELTA_ENCODED_POINTS: coordinates are quantized to integers,
+ * differences of consecutive integers are zigzag encoded (small magnitudes - positive or negative -
+ * become small unsigned values) and written as varints (7 bits per byte, high bit set on all but the last byte).
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__internal__delta_encoding_h__
+#define __rrlib__canvas__internal__delta_encoding_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+namespace internal
+{
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Maximum number of bytes of a varint (64 bit value) */
+const size_t cMAX_VARINT_BYTES = 10;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*!
+ * \param value Value in units of quantization step
+ * \return Closest integer (halves are rounded away from zero; clamped to +-2^52 - so that differences cannot overflow; NaN is mapped to the upper limit)
+ */
+inline int64_t Quantize(double value)
+{
+  const double cLIMIT = 4503599627370496.0;
+  value = value < cLIMIT ? value : cLIMIT;
+  value = value > -cLIMIT ? value : -cLIMIT;
+  return static_cast<int64_t>(value + (value >= 0 ? 0.5 : -0.5));
+}
+
+/*!
+ * \return Zigzag encoding of value (0, -1, 1, -2, 2, ... are mapped to 0, 1, 2, 3, 4, ...)
+ */
+inline uint64_t ZigZagEncode(int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/*!
+ * \return Decoded value as two's complement bits (so that sums of decoded values wrap around instead of overflowing)
+ */
+inline uint64_t ZigZagDecode(uint64_t value)
+{
+  return (value >> 1) ^ (0 - (value & 1));
+}
+
+/*!
+ * Writes varint
+ *
+ * \param value Value to write
+ * \param destination Buffer with space for at least cMAX_VARINT_BYTES bytes
+ * \return Number of bytes written
+ */
+inline size_t WriteVarint(uint64_t value, uint8_t* destination)
+{
+  size_t bytes = 0;
+  while (value >= 0x80)
+  {
+    destination[bytes++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  destination[bytes++] = static_cast<uint8_t>(value);
+  return bytes;
+}
+
+/*!
+ * Reads varint and advances data pointer
+ * (the data must contain a terminating byte < 0x80 - bits beyond 64 bits are ignored)
+ *
+ * \param data Pointer to varint
+ * \return Value of varint
+ */
+inline uint64_t ReadVarint(const uint8_t*& data)
+{
+  uint64_t byte = *data++;
+  if (byte < 0x80)
+  {
+    // Most deltas of paths fit into a single byte
+    return byte;
+  }
+  uint64_t result = byte & 0x7F;
+  unsigned int shift = 7;
+  do
+  {
+    byte = *data++;
+    result |= shift < 64 ? (byte & 0x7F) << shift : 0;
+    shift += 7;
+  }
+  while (byte >= 0x80);
+  return result;
+}
+
+/*!
+ * Decodes delta encoded points (see eDRAW_DELTA_ENCODED_POINTS)
+ *
+ * \param data Varints (must contain (count - 1) * Tdimension terminated varints)
+ * \param origin First point
+ * \param step Quantization step
+ * \param count Number of points (> 0)
+ * \param destination Buffer for count * Tdimension coordinates
+ */
+template <size_t Tdimension, typename T>
+void DecodeDeltaEncodedPoints(const uint8_t* data, const double* origin, double step, size_t count, T* destination)
+{
+  uint64_t quantized[Tdimension];
+  for (size_t i = 0; i < Tdimension; i++)
+  {
+    quantized[i] = 0;
+    destination[i] = static_cast<T>(origin[i]);
+  }
+  T* end = destination + count * Tdimension;
+  for (T* point = destination + Tdimension; point != end; point += Tdimension)
+  {
+    for (size_t i = 0; i < Tdimension; i++)
+    {
+      quantized[i] += ZigZagDecode(ReadVarint(data));
+      point[i] = static_cast<T>(origin[i] + step * static_cast<double>(static_cast<int64_t>(quantized[i])));
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+}
+
+#endif
@@ -0,0 +1,222 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    internal/half_precision.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains ConvertToHalf() and ConvertFromHalf()
+ *
+ * Conversion between float/double and half precision values (IEEE 754 binary16 - number type eHALF).
+ * Rounding is to nearest even. Values whose magnitude is too large for half precision (> 65504) become infinity.
+ * Batch conversion uses F16C instructions if available - the scalar code produces identical results.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__internal__half_precision_h__
+#define __rrlib__canvas__internal__half_precision_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+namespace internal
+{
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*!
+ * \param value Single precision value
+ * \return Bits of half precision value closest to value
+ */
+inline uint16_t FloatToHalf(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t magnitude = bits & 0x7FFFFFFF;
+
+  if (magnitude >= 0x7F800000)
+  {
+    // Infinity and NaN (NaNs are quieted)
+    return sign | 0x7C00 | (magnitude > 0x7F800000 ? (0x200 | ((magnitude >> 13) & 0x3FF)) : 0);
+  }
+  if (magnitude >= 0x477FF000)
+  {
+    // Rounds to a value beyond 65504
+    return sign | 0x7C00;
+  }
+  if (magnitude < 0x38800000)
+  {
+    // Subnormal half (or zero)
+    if (magnitude <= 0x33000000)
+    {
+      return sign;
+    }
+    uint32_t shift = 126 - (magnitude >> 23);
+    uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+    uint32_t result = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    result += (remainder > halfway || (remainder == halfway && (result & 1))) ? 1 : 0;
+    return sign | result;
+  }
+
+  // Normal half (a carry from rounding correctly propagates into the exponent)
+  uint32_t result = (magnitude - 0x38000000) >> 13;
+  uint32_t remainder = magnitude & 0x1FFF;
+  result += (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) ? 1 : 0;
+  return sign | result;
+}
+
+/*!
+ * \param half Bits of half precision value
+ * \return Value as single precision value (exact - apart from NaN payloads)
+ */
+inline float HalfToFloat(uint16_t half)
+{
+  uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1F;
+  uint32_t mantissa = half & 0x3FF;
+  uint32_t bits;
+  if (exponent == 0x1F)
+  {
+    // Infinity and NaN (NaNs are quieted)
+    bits = sign | 0x7F800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0);
+  }
+  else if (exponent == 0)
+  {
+    float result = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    return sign ? -result : result;
+  }
+  else
+  {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+/*!
+ * Converts values to half precision
+ * (double values are rounded to float first - as in the F16C code path)
+ *
+ * \param source Values to convert
+ * \param count Number of values
+ * \param destination Buffer for count half precision values
+ */
+template <typename T>
+inline void ConvertToHalf(const T* source, size_t count, uint16_t* destination)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    destination[i] = FloatToHalf(static_cast<float>(source[i]));
+  }
+}
+
+/*!
+ * Converts half precision values to float
+ *
+ * \param source Values to convert (native byte order - not necessarily aligned)
+ * \param count Number of values
+ * \param destination Buffer for count float values
+ */
+inline void ConvertFromHalf(const char* source, size_t count, float* destination)
+{
+  size_t i = 0;
+#ifdef __F16C__
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+    _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(half));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    uint16_t half;
+    std::memcpy(&half, source + i * 2, sizeof(half));
+    destination[i] = HalfToFloat(half);
+  }
+}
+
+#ifdef __F16C__
+
+template <>
+inline void ConvertToHalf<float>(const float* source, size_t count, uint16_t* destination)
+{
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), half);
+  }
+  for (; i < count; i++)
+  {
+    destination[i] = FloatToHalf(source[i]);
+  }
+}
+
+template <>
+inline void ConvertToHalf<double>(const double* source, size_t count, uint16_t* destination)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i half = _mm_cvtps_ph(_mm256_cvtpd_ps(_mm256_loadu_pd(source + i)), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i), half);
+  }
+  for (; i < count; i++)
+  {
+    destination[i] = FloatToHalf(static_cast<float>(source[i]));
+  }
+}
+
+#endif
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+}
+
+#endif
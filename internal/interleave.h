@@ -0,0 +1,207 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    internal/interleave.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains Interleave()
+ *
+ * Kernels that convert structure-of-arrays data (separate x[], y[], z[] arrays)
+ * to the interleaved layout that is serialized to canvases.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__internal__interleave_h__
+#define __rrlib__canvas__internal__interleave_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+namespace internal
+{
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*!
+ * Interleaves channels: destination = { c0[offset], c1[offset], ..., c0[offset + 1], c1[offset + 1], ... }
+ *
+ * \param channels Pointers to channel arrays
+ * \param offset Index of first value to interleave in each channel
+ * \param count Number of values to interleave from each channel
+ * \param destination Buffer with space for Tchannels * count values
+ */
+template <size_t Tchannels, typename T>
+struct tInterleave
+{
+  static void Interleave(const T* const(&channels)[Tchannels], size_t offset, size_t count, T* destination)
+  {
+    for (size_t i = offset; i < offset + count; i++)
+    {
+      for (size_t c = 0; c < Tchannels; c++)
+      {
+        *destination++ = channels[c][i];
+      }
+    }
+  }
+};
+
+#ifdef __SSE2__
+
+template <>
+struct tInterleave<2, float>
+{
+  static void Interleave(const float* const(&channels)[2], size_t offset, size_t count, float* destination)
+  {
+    const float* x = channels[0] + offset;
+    const float* y = channels[1] + offset;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 vx = _mm_loadu_ps(x + i);
+      __m128 vy = _mm_loadu_ps(y + i);
+      _mm_storeu_ps(destination, _mm_unpacklo_ps(vx, vy));
+      _mm_storeu_ps(destination + 4, _mm_unpackhi_ps(vx, vy));
+      destination += 8;
+    }
+    for (; i < count; i++)
+    {
+      *destination++ = x[i];
+      *destination++ = y[i];
+    }
+  }
+};
+
+template <>
+struct tInterleave<3, float>
+{
+  static void Interleave(const float* const(&channels)[3], size_t offset, size_t count, float* destination)
+  {
+    const float* x = channels[0] + offset;
+    const float* y = channels[1] + offset;
+    const float* z = channels[2] + offset;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 vx = _mm_loadu_ps(x + i);
+      __m128 vy = _mm_loadu_ps(y + i);
+      __m128 vz = _mm_loadu_ps(z + i);
+      __m128 xy01 = _mm_unpacklo_ps(vx, vy);                           // x0 y0 x1 y1
+      __m128 xy23 = _mm_unpackhi_ps(vx, vy);                           // x2 y2 x3 y3
+      __m128 z0x1 = _mm_shuffle_ps(vz, xy01, _MM_SHUFFLE(2, 2, 0, 0)); // z0 z0 x1 x1
+      __m128 y1z1 = _mm_shuffle_ps(xy01, vz, _MM_SHUFFLE(1, 1, 3, 3)); // y1 y1 z1 z1
+      __m128 z2x3 = _mm_shuffle_ps(vz, xy23, _MM_SHUFFLE(2, 2, 2, 2)); // z2 z2 x3 x3
+      __m128 y3z3 = _mm_shuffle_ps(xy23, vz, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+      _mm_storeu_ps(destination, _mm_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2, 0, 1, 0)));     // x0 y0 z0 x1
+      _mm_storeu_ps(destination + 4, _mm_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1, 0, 2, 0))); // y1 z1 x2 y2
+      _mm_storeu_ps(destination + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0))); // z2 x3 y3 z3
+      destination += 12;
+    }
+    for (; i < count; i++)
+    {
+      *destination++ = x[i];
+      *destination++ = y[i];
+      *destination++ = z[i];
+    }
+  }
+};
+
+template <>
+struct tInterleave<2, double>
+{
+  static void Interleave(const double* const(&channels)[2], size_t offset, size_t count, double* destination)
+  {
+    const double* x = channels[0] + offset;
+    const double* y = channels[1] + offset;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+      __m128d vx = _mm_loadu_pd(x + i);
+      __m128d vy = _mm_loadu_pd(y + i);
+      _mm_storeu_pd(destination, _mm_unpacklo_pd(vx, vy));
+      _mm_storeu_pd(destination + 2, _mm_unpackhi_pd(vx, vy));
+      destination += 4;
+    }
+    for (; i < count; i++)
+    {
+      *destination++ = x[i];
+      *destination++ = y[i];
+    }
+  }
+};
+
+template <>
+struct tInterleave<3, double>
+{
+  static void Interleave(const double* const(&channels)[3], size_t offset, size_t count, double* destination)
+  {
+    const double* x = channels[0] + offset;
+    const double* y = channels[1] + offset;
+    const double* z = channels[2] + offset;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+      __m128d vx = _mm_loadu_pd(x + i);
+      __m128d vy = _mm_loadu_pd(y + i);
+      __m128d vz = _mm_loadu_pd(z + i);
+      _mm_storeu_pd(destination, _mm_unpacklo_pd(vx, vy));     // x0 y0
+      _mm_storeu_pd(destination + 2, _mm_shuffle_pd(vz, vx, 2)); // z0 x1
+      _mm_storeu_pd(destination + 4, _mm_unpackhi_pd(vy, vz));   // y1 z1
+      destination += 6;
+    }
+    for (; i < count; i++)
+    {
+      *destination++ = x[i];
+      *destination++ = y[i];
+      *destination++ = z[i];
+    }
+  }
+};
+
+#endif
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+}
+
+#endif
@@ -0,0 +1,228 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    internal/tAffineTransformation.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tAffineTransformation
+ *
+ * \b tAffineTransformation
+ *
+ * Affine transformation that canvases accumulate client-side
+ * when transformation folding is enabled.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__internal__tAffineTransformation_h__
+#define __rrlib__canvas__internal__tAffineTransformation_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <array>
+#include <cmath>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+namespace internal
+{
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Affine transformation
+/*!
+ * Homogeneous 4x4 matrix (row-major, double precision).
+ * 2D transformations are stored as 3D transformations that leave z unchanged.
+ *
+ * All operations are applied as the canvas viewer applies them:
+ * the new transformation is multiplied from the right (last-specified-first-applied).
+ */
+class tAffineTransformation
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Row-major 4x4 matrix */
+  typedef std::array<double, 16> tMatrix;
+
+  tAffineTransformation()
+  {
+    SetIdentity();
+  }
+
+  /*!
+   * \return Matrix element in row 'row' and column 'column'
+   */
+  double Get(size_t row, size_t column) const
+  {
+    return matrix[row * 4 + column];
+  }
+
+  /*!
+   * Values of 2D eSET_TRANSFORMATION command: [0][0], [1][0], [0][1], [1][1], [0][2], [1][2] of 3x3 matrix
+   */
+  void Get2DValues(double (&values)[6]) const
+  {
+    values[0] = matrix[0];
+    values[1] = matrix[4];
+    values[2] = matrix[1];
+    values[3] = matrix[5];
+    values[4] = matrix[3];
+    values[5] = matrix[7];
+  }
+
+  /*!
+   * Values of 3D eSET_TRANSFORMATION command (4x4 matrix row by row)
+   */
+  const double* Get3DValues() const
+  {
+    return matrix.data();
+  }
+
+  bool IsIdentity() const
+  {
+    for (size_t i = 0; i < 12; i++)
+    {
+      if (matrix[i] != ((i % 5 == 0) ? 1 : 0))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * Multiplies matrix from the right
+   *
+   * \param other Affine transformation matrix
+   */
+  void Multiply(const tMatrix& other)
+  {
+    for (size_t row = 0; row < 3; row++)
+    {
+      double* r = &matrix[row * 4];
+      double result[4];
+      for (size_t column = 0; column < 4; column++)
+      {
+        result[column] = r[0] * other[column] + r[1] * other[4 + column] + r[2] * other[8 + column] + r[3] * other[12 + column];
+      }
+      r[0] = result[0];
+      r[1] = result[1];
+      r[2] = result[2];
+      r[3] = result[3];
+    }
+  }
+
+  /*!
+   * Applies rotation - with angles as in rrlib::math::tPose3D (roll around x, pitch around y, yaw around z: R = Rz * Ry * Rx)
+   */
+  void Rotate(double roll, double pitch, double yaw)
+  {
+    double cr = std::cos(roll), sr = std::sin(roll);
+    double cp = std::cos(pitch), sp = std::sin(pitch);
+    double cy = std::cos(yaw), sy = std::sin(yaw);
+    const tMatrix rotation =
+    {
+      {
+        cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr, 0,
+        sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr, 0,
+        -sp, cp * sr, cp * cr, 0,
+        0, 0, 0, 1
+      }
+    };
+    Multiply(rotation);
+  }
+
+  /*!
+   * Applies scaling
+   */
+  void Scale(double x, double y, double z)
+  {
+    for (size_t row = 0; row < 3; row++)
+    {
+      matrix[row * 4] *= x;
+      matrix[row * 4 + 1] *= y;
+      matrix[row * 4 + 2] *= z;
+    }
+  }
+
+  /*!
+   * Replaces transformation
+   *
+   * \param other Affine transformation matrix
+   */
+  void Set(const tMatrix& other)
+  {
+    matrix = other;
+  }
+
+  void SetIdentity()
+  {
+    for (size_t i = 0; i < 16; i++)
+    {
+      matrix[i] = (i % 5 == 0) ? 1 : 0;
+    }
+  }
+
+  /*!
+   * Applies translation
+   */
+  void Translate(double x, double y, double z)
+  {
+    for (size_t row = 0; row < 3; row++)
+    {
+      double* r = &matrix[row * 4];
+      r[3] += r[0] * x + r[1] * y + r[2] * z;
+    }
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Last row is always 0, 0, 0, 1 */
+  tMatrix matrix;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+}
+
+#endif
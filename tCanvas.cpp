@@ -33,6 +33,16 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <limits>
+#include <memory>
+
+#ifdef _LIB_LZ4_PRESENT_
+#include <lz4.h>
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+#include <zstd.h>
+#endif
+
 #include "rrlib/logging/messages.h"
 
 //----------------------------------------------------------------------
@@ -56,10 +66,233 @@ using namespace rrlib::canvas;
 // Const values
 //----------------------------------------------------------------------
 
+/*! Maximum number of uncompressed bytes per block of compressed canvases */
+static const size_t cCOMPRESSION_BLOCK_SIZE = 128 * 1024;
+
+/*! Size of eCOMPRESSED header (opcode, codec, uncompressed size) and of block headers */
+static const size_t cCOMPRESSION_HEADER_SIZE = 10;
+static const size_t cCOMPRESSION_BLOCK_HEADER_SIZE = 8;
+
 //----------------------------------------------------------------------
 // Implementation
 //----------------------------------------------------------------------
 
+namespace
+{
+
+/*! Buffer for compressed data of current thread (reused - so that no memory is allocated after warm-up) */
+thread_local std::vector<char> compression_buffer;
+
+#ifdef _LIB_ZSTD_PRESENT_
+struct tZstdContextDeleter
+{
+  void operator()(ZSTD_CCtx* context) const
+  {
+    ZSTD_freeCCtx(context);
+  }
+  void operator()(ZSTD_DCtx* context) const
+  {
+    ZSTD_freeDCtx(context);
+  }
+};
+thread_local std::unique_ptr<ZSTD_CCtx, tZstdContextDeleter> zstd_compression_context;
+thread_local std::unique_ptr<ZSTD_DCtx, tZstdContextDeleter> zstd_decompression_context;
+#endif
+
+template <typename T>
+inline void WriteLittleEndian(char* data, T value)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  std::reverse_copy(bytes, bytes + sizeof(T), data);
+#else
+  std::memcpy(data, &value, sizeof(T));
+#endif
+}
+
+template <typename T>
+inline T ReadLittleEndian(const char* data)
+{
+  T value;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  std::reverse_copy(data, data + sizeof(T), reinterpret_cast<char*>(&value));
+#else
+  std::memcpy(&value, data, sizeof(T));
+#endif
+  return value;
+}
+
+/*!
+ * \return Maximum compressed size of block with the specified size
+ */
+size_t GetCompressionBound(tCompression compression, size_t size)
+{
+  switch (compression)
+  {
+#ifdef _LIB_LZ4_PRESENT_
+  case eLZ4:
+    return LZ4_compressBound(static_cast<int>(size));
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  case eZSTD:
+    return ZSTD_compressBound(size);
+#endif
+  default:
+    return size;
+  }
+}
+
+/*!
+ * Appends compressed block to compression buffer
+ * (data is stored uncompressed if it cannot be compressed to a smaller size)
+ */
+void AppendCompressedBlock(tCompression compression, int level, const char* data, size_t size)
+{
+  size_t offset = compression_buffer.size();
+  compression_buffer.resize(offset + cCOMPRESSION_BLOCK_HEADER_SIZE + GetCompressionBound(compression, size));
+  char* destination = compression_buffer.data() + offset + cCOMPRESSION_BLOCK_HEADER_SIZE;
+  size_t compressed_size = 0;
+  switch (compression)
+  {
+#ifdef _LIB_LZ4_PRESENT_
+  case eLZ4:
+  {
+    int result = LZ4_compress_fast(data, destination, static_cast<int>(size), LZ4_compressBound(static_cast<int>(size)), std::max(1, level));
+    compressed_size = result > 0 ? result : 0;
+    break;
+  }
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  case eZSTD:
+  {
+    if (!zstd_compression_context)
+    {
+      zstd_compression_context.reset(ZSTD_createCCtx());
+    }
+    size_t result = ZSTD_compressCCtx(zstd_compression_context.get(), destination, ZSTD_compressBound(size), data, size, level ? level : 1);
+    compressed_size = ZSTD_isError(result) ? 0 : result;
+    break;
+  }
+#endif
+  default:
+    (void)level; // unused if no codec is available
+    break;
+  }
+  if (compressed_size == 0 || compressed_size >= size)
+  {
+    std::memcpy(destination, data, size);
+    compressed_size = size;
+  }
+  WriteLittleEndian<uint32_t>(&compression_buffer[offset], size);
+  WriteLittleEndian<uint32_t>(&compression_buffer[offset + 4], compressed_size);
+  compression_buffer.resize(offset + cCOMPRESSION_BLOCK_HEADER_SIZE + compressed_size);
+}
+
+/*!
+ * Decompresses block
+ *
+ * \return True if block was decompressed to exactly 'size' bytes
+ */
+bool DecompressBlock(tCompression compression, const char* data, size_t compressed_size, char* destination, size_t size)
+{
+  if (compressed_size == size)
+  {
+    std::memcpy(destination, data, size);
+    return true;
+  }
+  switch (compression)
+  {
+#ifdef _LIB_LZ4_PRESENT_
+  case eLZ4:
+    return LZ4_decompress_safe(data, destination, static_cast<int>(compressed_size), static_cast<int>(size)) == static_cast<int>(size);
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  case eZSTD:
+  {
+    if (!zstd_decompression_context)
+    {
+      zstd_decompression_context.reset(ZSTD_createDCtx());
+    }
+    return ZSTD_decompressDCtx(zstd_decompression_context.get(), destination, size, data, compressed_size) == size;
+  }
+#endif
+  default:
+    return false;
+  }
+}
+
+/*!
+ * Decompresses eCOMPRESSED canvas data from compression buffer
+ *
+ * \param destination Buffer for uncompressed data (called with uncompressed size - returns pointer to buffer with this size)
+ * \return Uncompressed size (0 if data is invalid)
+ */
+template <typename TGetDestination>
+size_t Decompress(TGetDestination get_destination)
+{
+  const char* data = compression_buffer.data();
+  const size_t size = compression_buffer.size();
+  if (size < cCOMPRESSION_HEADER_SIZE)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Compressed canvas data is truncated.");
+    return 0;
+  }
+  tCompression compression = static_cast<tCompression>(data[1]);
+  uint64_t uncompressed_size = ReadLittleEndian<uint64_t>(data + 2);
+  bool available = false;
+#ifdef _LIB_LZ4_PRESENT_
+  available |= compression == eLZ4;
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  available |= compression == eZSTD;
+#endif
+  if (!available)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Canvas is compressed with codec ", static_cast<int>(compression), " which is not available. Canvas is left empty.");
+    return 0;
+  }
+
+  // Check block headers before allocating memory
+  uint64_t total_size = 0;
+  for (size_t offset = cCOMPRESSION_HEADER_SIZE; offset < size;)
+  {
+    if (size - offset < cCOMPRESSION_BLOCK_HEADER_SIZE)
+    {
+      total_size = std::numeric_limits<uint64_t>::max();
+      break;
+    }
+    uint32_t block_size = ReadLittleEndian<uint32_t>(data + offset), compressed_size = ReadLittleEndian<uint32_t>(data + offset + 4);
+    offset += cCOMPRESSION_BLOCK_HEADER_SIZE + compressed_size;
+    if (block_size > cCOMPRESSION_BLOCK_SIZE || compressed_size > block_size || offset > size)
+    {
+      total_size = std::numeric_limits<uint64_t>::max();
+      break;
+    }
+    total_size += block_size;
+  }
+  if (total_size != uncompressed_size)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Compressed canvas data is malformed. Canvas is left empty.");
+    return 0;
+  }
+
+  char* destination = get_destination(uncompressed_size);
+  for (size_t offset = cCOMPRESSION_HEADER_SIZE; offset < size;)
+  {
+    uint32_t block_size = ReadLittleEndian<uint32_t>(data + offset), compressed_size = ReadLittleEndian<uint32_t>(data + offset + 4);
+    if (!DecompressBlock(compression, data + offset + cCOMPRESSION_BLOCK_HEADER_SIZE, compressed_size, destination, block_size))
+    {
+      RRLIB_LOG_PRINT(ERROR, "Compressed canvas data is malformed. Canvas is left empty.");
+      return 0;
+    }
+    destination += block_size;
+    offset += cCOMPRESSION_BLOCK_HEADER_SIZE + compressed_size;
+  }
+  return uncompressed_size;
+}
+
+}
+
 //----------------------------------------------------------------------
 // tCanvas constructors
 //----------------------------------------------------------------------
@@ -68,21 +301,76 @@ tCanvas::tCanvas() :
   in_path_mode(false),
   default_viewport_offset(0),
   buffer(new rrlib::serialization::tMemoryBuffer()),
-  stream(new rrlib::serialization::tOutputStream(*buffer))
-{}
+  stream(new rrlib::serialization::tOutputStream(*buffer)),
+  high_water_mark(0),
+  state_fully_tracked(true),
+  elided_bytes(0),
+  transformation_folding(0),
+  transformation_pending(false),
+  folded_transformation(),
+  transformation_stack(),
+  culling(false),
+  local_culling_frustum_valid(false),
+  culling_frustum(),
+  local_culling_frustum(),
+  culled_count(0),
+  compression(eNO_COMPRESSION),
+  compression_level(0),
+  half_precision(false),
+  half_precision_data(false),
+  legacy_point_counts(false)
+{
+  this->ResetState(true);
+}
 
 tCanvas::tCanvas(tCanvas && o) :
   entering_path_mode(false),
   in_path_mode(false),
   default_viewport_offset(0),
   buffer(),
-  stream()
+  stream(),
+  high_water_mark(0),
+  state_fully_tracked(true),
+  elided_bytes(0),
+  transformation_folding(0),
+  transformation_pending(false),
+  folded_transformation(),
+  transformation_stack(),
+  culling(false),
+  local_culling_frustum_valid(false),
+  culling_frustum(),
+  local_culling_frustum(),
+  culled_count(0),
+  compression(eNO_COMPRESSION),
+  compression_level(0),
+  half_precision(false),
+  half_precision_data(false),
+  legacy_point_counts(false)
 {
+  this->ResetState(true);
   std::swap(entering_path_mode, o.entering_path_mode);
   std::swap(in_path_mode, o.in_path_mode);
   std::swap(default_viewport_offset, o.default_viewport_offset);
   std::swap(buffer, o.buffer);
   std::swap(stream, o.stream);
+  std::swap(high_water_mark, o.high_water_mark);
+  std::swap(state_values, o.state_values);
+  std::swap(state_fully_tracked, o.state_fully_tracked);
+  std::swap(elided_bytes, o.elided_bytes);
+  std::swap(transformation_folding, o.transformation_folding);
+  std::swap(transformation_pending, o.transformation_pending);
+  std::swap(folded_transformation, o.folded_transformation);
+  std::swap(transformation_stack, o.transformation_stack);
+  std::swap(culling, o.culling);
+  std::swap(local_culling_frustum_valid, o.local_culling_frustum_valid);
+  std::swap(culling_frustum, o.culling_frustum);
+  std::swap(local_culling_frustum, o.local_culling_frustum);
+  std::swap(culled_count, o.culled_count);
+  std::swap(compression, o.compression);
+  std::swap(compression_level, o.compression_level);
+  std::swap(half_precision, o.half_precision);
+  std::swap(half_precision_data, o.half_precision_data);
+  std::swap(legacy_point_counts, o.legacy_point_counts);
 }
 
 //----------------------------------------------------------------------
@@ -95,6 +383,24 @@ tCanvas& tCanvas::operator=(tCanvas && o)
   std::swap(default_viewport_offset, o.default_viewport_offset);
   std::swap(buffer, o.buffer);
   std::swap(stream, o.stream);
+  std::swap(high_water_mark, o.high_water_mark);
+  std::swap(state_values, o.state_values);
+  std::swap(state_fully_tracked, o.state_fully_tracked);
+  std::swap(elided_bytes, o.elided_bytes);
+  std::swap(transformation_folding, o.transformation_folding);
+  std::swap(transformation_pending, o.transformation_pending);
+  std::swap(folded_transformation, o.folded_transformation);
+  std::swap(transformation_stack, o.transformation_stack);
+  std::swap(culling, o.culling);
+  std::swap(local_culling_frustum_valid, o.local_culling_frustum_valid);
+  std::swap(culling_frustum, o.culling_frustum);
+  std::swap(local_culling_frustum, o.local_culling_frustum);
+  std::swap(culled_count, o.culled_count);
+  std::swap(compression, o.compression);
+  std::swap(compression_level, o.compression_level);
+  std::swap(half_precision, o.half_precision);
+  std::swap(half_precision_data, o.half_precision_data);
+  std::swap(legacy_point_counts, o.legacy_point_counts);
   return *this;
 }
 
@@ -103,6 +409,20 @@ tCanvas& tCanvas::operator=(tCanvas && o)
 //----------------------------------------------------------------------
 void tCanvas::AppendCommandRaw(tCanvasOpCode opcode, void* buffer, size_t bytes)
 {
+  if (this->transformation_pending && IsTransformed(opcode))
+  {
+    this->WritePendingTransformation();
+  }
+  this->half_precision_data = this->half_precision && IsHalfPrecisionCandidate(opcode);
+  if (buffer && bytes < 16)
+  {
+    // Small payloads (e.g. colors) are written together with opcode
+    char command[16];
+    command[0] = static_cast<char>(opcode);
+    std::memcpy(command + 1, buffer, bytes);
+    this->stream->Write(command, 1 + bytes);
+    return;
+  }
   (*this->stream) << opcode;
   if (buffer)
   {
@@ -115,9 +435,214 @@ void tCanvas::AppendCommandRaw(tCanvasOpCode opcode, void* buffer, size_t bytes)
 //----------------------------------------------------------------------
 void tCanvas::Clear()
 {
+  this->high_water_mark = std::max(this->high_water_mark, this->stream->GetPosition());
   this->buffer->Clear();
   this->stream->Reset(*this->buffer);
   this->default_viewport_offset = 0;
+  this->Reserve(this->high_water_mark);
+  this->ResetState(true);
+  this->folded_transformation.SetIdentity();
+  this->transformation_stack.clear();
+  this->transformation_pending = false;
+  this->local_culling_frustum_valid = false;
+}
+
+//----------------------------------------------------------------------
+// tCanvas MergeState
+//----------------------------------------------------------------------
+void tCanvas::MergeState(const tCanvas& appended)
+{
+  if (!appended.state_fully_tracked)
+  {
+    this->ResetState(false);
+    return;
+  }
+  for (size_t i = 0; i < eSTATE_VARIABLE_COUNT; i++)
+  {
+    if (appended.state_values[i].size)
+    {
+      this->state_values[i] = appended.state_values[i];
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvas SetCulling
+//----------------------------------------------------------------------
+void tCanvas::SetCulling(const tViewFrustum& frustum, uint8_t dimension)
+{
+  this->SetTransformationFolding(dimension);
+  this->culling_frustum = frustum;
+  this->local_culling_frustum_valid = false;
+  this->culling = true;
+}
+
+//----------------------------------------------------------------------
+// tCanvas SetCompression
+//----------------------------------------------------------------------
+bool tCanvas::SetCompression(tCompression compression, int level)
+{
+  bool available = compression == eNO_COMPRESSION;
+#ifdef _LIB_LZ4_PRESENT_
+  available |= compression == eLZ4;
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  available |= compression == eZSTD;
+#endif
+  if (!available)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Compression codec ", static_cast<int>(compression), " is not available (library was not found at build time). Compression is disabled.");
+    this->compression = eNO_COMPRESSION;
+    return false;
+  }
+  this->compression = compression;
+  this->compression_level = level;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvas SetTransformationFolding
+//----------------------------------------------------------------------
+void tCanvas::SetTransformationFolding(uint8_t dimension)
+{
+  if (dimension == this->transformation_folding)
+  {
+    return;
+  }
+  if (this->transformation_pending)
+  {
+    // Following (unfolded) transformation commands are applied on top of folded transformation
+    this->WritePendingTransformation();
+  }
+  this->transformation_folding = dimension;
+  this->transformation_stack.clear();
+  this->folded_transformation.SetIdentity();
+  this->local_culling_frustum_valid = false;
+  if (!dimension)
+  {
+    this->culling = false;
+  }
+
+  // Folded transformation replaces any transformation commands in buffer
+  this->transformation_pending = dimension && this->stream->GetPosition();
+}
+
+//----------------------------------------------------------------------
+// tCanvas ResetAfterLoad
+//----------------------------------------------------------------------
+void tCanvas::ResetAfterLoad()
+{
+  // Restore default viewport offset member variable
+  const size_t size = this->stream->GetPosition();
+  const char* data = this->buffer->GetBufferPointer(0);
+  this->default_viewport_offset = (size >= 9 && *data == static_cast<char>(tCanvasOpCode::eDEFAULT_VIEWPORT_OFFSET)) ? ReadLittleEndian<int64_t>(data + 1) : 0;
+
+  this->ResetState(false);
+  this->folded_transformation.SetIdentity();
+  this->transformation_stack.clear();
+  this->transformation_pending = this->transformation_folding && size;
+  this->local_culling_frustum_valid = false;
+  this->entering_path_mode = false;
+  this->in_path_mode = false;
+}
+
+//----------------------------------------------------------------------
+// tCanvas ResetState
+//----------------------------------------------------------------------
+void tCanvas::ResetState(bool buffer_fully_tracked)
+{
+  std::memset(this->state_values, 0, sizeof(this->state_values));
+  this->state_fully_tracked = buffer_fully_tracked;
+}
+
+//----------------------------------------------------------------------
+// tCanvas RestoreState
+//----------------------------------------------------------------------
+void tCanvas::RestoreState(const tStateValue(&values)[eSTATE_VARIABLE_COUNT])
+{
+  static const tCanvasOpCode cSTATE_OPCODES[eSTATE_VARIABLE_COUNT] = { eSET_EDGE_COLOR, eSET_FILL_COLOR, eSET_ALPHA, eSET_FILL, eSET_Z, eSET_EXTRUSION };
+  for (size_t i = 0; i < eSTATE_VARIABLE_COUNT; i++)
+  {
+    tStateValue& state = this->state_values[i];
+    if (state.size == values[i].size && std::memcmp(state.bytes, values[i].bytes, state.size) == 0)
+    {
+      continue;
+    }
+    state = values[i];
+    if (state.size)
+    {
+      this->AppendCommandRaw(cSTATE_OPCODES[i], state.bytes, state.size);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvas PopTransformation
+//----------------------------------------------------------------------
+void tCanvas::PopTransformation()
+{
+  if (!this->transformation_folding)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Transformation folding is not enabled. Command has no effect.");
+    return;
+  }
+  if (this->transformation_stack.empty())
+  {
+    RRLIB_LOG_PRINT(ERROR, "No transformation has been pushed. Command has no effect.");
+    return;
+  }
+  this->folded_transformation = this->transformation_stack.back();
+  this->transformation_stack.pop_back();
+  this->transformation_pending = true;
+  this->local_culling_frustum_valid = false;
+}
+
+//----------------------------------------------------------------------
+// tCanvas PushTransformation
+//----------------------------------------------------------------------
+void tCanvas::PushTransformation()
+{
+  if (!this->transformation_folding)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Transformation folding is not enabled. Command has no effect.");
+    return;
+  }
+  this->transformation_stack.push_back(this->folded_transformation);
+}
+
+//----------------------------------------------------------------------
+// tCanvas Reserve
+//----------------------------------------------------------------------
+void tCanvas::Reserve(size_t bytes)
+{
+  if (this->buffer->GetCapacity() >= bytes)
+  {
+    return;
+  }
+
+  // Copy current data to larger buffer
+  size_t size = this->stream->GetPosition();
+  std::unique_ptr<rrlib::serialization::tMemoryBuffer> new_buffer(new rrlib::serialization::tMemoryBuffer(bytes));
+  this->stream->Reset(*new_buffer);
+  this->stream->Write(this->buffer->GetBufferPointer(0), size);
+  std::swap(this->buffer, new_buffer);
+}
+
+//----------------------------------------------------------------------
+// tCanvas ResetSettings
+//----------------------------------------------------------------------
+void tCanvas::ResetSettings()
+{
+  this->SetTransformationFolding(0);
+  this->culling = false;
+  this->culling_frustum = tViewFrustum();
+  this->culled_count = 0;
+  this->elided_bytes = 0;
+  this->compression = eNO_COMPRESSION;
+  this->compression_level = 0;
+  this->half_precision = false;
+  this->half_precision_data = false;
+  this->legacy_point_counts = false;
 }
 
 void tCanvas::AppendCanvas(const tCanvas& canvas)
@@ -138,13 +663,76 @@ void tCanvas::AppendCanvas(const tCanvas& canvas)
   {
     this->default_viewport_offset = this->buffer->GetSize() + canvas.default_viewport_offset;
   }
+  if (this->transformation_pending)
+  {
+    this->WritePendingTransformation();
+  }
   this->stream->Write(canvas.buffer->GetBufferPointer(0), canvas.stream->GetPosition());
+  this->MergeState(canvas);
+
+  // Appended canvas may have changed transformation
+  this->transformation_pending = this->transformation_folding != 0;
+}
+
+//----------------------------------------------------------------------
+// tCanvas WritePendingTransformation
+//----------------------------------------------------------------------
+void tCanvas::WritePendingTransformation()
+{
+  this->transformation_pending = false;
+  if (this->folded_transformation.IsIdentity())
+  {
+    this->AppendCommandRaw(eRESET_TRANSFORMATION);
+  }
+  else if (this->transformation_folding == 2)
+  {
+    double values[6];
+    this->folded_transformation.Get2DValues(values);
+    this->AppendCommand(eSET_TRANSFORMATION, values, 6);
+  }
+  else
+  {
+    this->AppendCommand(eSET_TRANSFORMATION, this->folded_transformation.Get3DValues(), 16);
+  }
 }
 
 rrlib::serialization::tOutputStream& rrlib::canvas::operator << (rrlib::serialization::tOutputStream& stream, const tCanvas& canvas)
 {
   canvas.stream->Flush();
-  if (!canvas.default_viewport_offset)
+  if (canvas.compression != eNO_COMPRESSION)
+  {
+    // Blocks are compressed directly from canvas buffer (the default viewport offset - if set - as separate first block)
+    const char* data = canvas.buffer->GetBufferPointer(0);
+    size_t size = canvas.buffer->GetSize();
+    char prefix[9];
+    size_t prefix_size = 0;
+    if (canvas.default_viewport_offset)
+    {
+      if (size && *data == static_cast<char>(tCanvasOpCode::eDEFAULT_VIEWPORT_OFFSET))
+      {
+        data += 9;
+        size -= 9;
+      }
+      prefix[0] = static_cast<char>(tCanvasOpCode::eDEFAULT_VIEWPORT_OFFSET);
+      WriteLittleEndian<int64_t>(prefix + 1, canvas.default_viewport_offset);
+      prefix_size = 9;
+    }
+    compression_buffer.resize(cCOMPRESSION_HEADER_SIZE);
+    compression_buffer[0] = static_cast<char>(tCanvasOpCode::eCOMPRESSED);
+    compression_buffer[1] = static_cast<char>(canvas.compression);
+    WriteLittleEndian<uint64_t>(&compression_buffer[2], prefix_size + size);
+    if (prefix_size)
+    {
+      AppendCompressedBlock(canvas.compression, canvas.compression_level, prefix, prefix_size);
+    }
+    for (size_t offset = 0; offset < size; offset += cCOMPRESSION_BLOCK_SIZE)
+    {
+      AppendCompressedBlock(canvas.compression, canvas.compression_level, data + offset, std::min(cCOMPRESSION_BLOCK_SIZE, size - offset));
+    }
+    stream.WriteLong(compression_buffer.size());
+    stream.Write(compression_buffer.data(), compression_buffer.size());
+  }
+  else if (!canvas.default_viewport_offset)
   {
     stream << (*canvas.buffer);
   }
@@ -176,13 +764,18 @@ rrlib::serialization::tInputStream& rrlib::canvas::operator >> (rrlib::serializa
   stream >> (*canvas.buffer);
   size_t buffer_size = canvas.buffer->GetSize();
   canvas.stream->Reset();
-  canvas.stream->Seek(buffer_size);
-
-  // Restore default viewport offset member variable
-  if (canvas.buffer->GetSize() && *canvas.buffer->GetBufferPointer(0) == static_cast<char>(tCanvasOpCode::eDEFAULT_VIEWPORT_OFFSET))
+  if (buffer_size && *canvas.buffer->GetBufferPointer(0) == static_cast<char>(tCanvasOpCode::eCOMPRESSED))
   {
-    canvas.default_viewport_offset = canvas.buffer->GetBuffer().GetLong(1);
+    // Copy compressed data - and decompress it directly into canvas buffer
+    compression_buffer.assign(canvas.buffer->GetBufferPointer(0), canvas.buffer->GetBufferPointer(0) + buffer_size);
+    buffer_size = Decompress([&canvas](size_t size)
+    {
+      canvas.Reserve(size);
+      return canvas.buffer->GetBufferPointer(0);
+    });
   }
+  canvas.stream->Seek(buffer_size);
 
+  canvas.ResetAfterLoad();
   return stream;
 }
@@ -38,8 +38,11 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
 #include <type_traits>
 #include <iterator>
+#include <vector>
 
 #include "rrlib/serialization/tMemoryBuffer.h"
 #include "rrlib/serialization/tOutputStream.h"
@@ -49,6 +52,11 @@
 // Internal includes with ""
 //----------------------------------------------------------------------
 #include "rrlib/canvas/definitions.h"
+#include "rrlib/canvas/internal/byte_order.h"
+#include "rrlib/canvas/internal/half_precision.h"
+#include "rrlib/canvas/internal/interleave.h"
+#include "rrlib/canvas/internal/tAffineTransformation.h"
+#include "rrlib/canvas/tViewFrustum.h"
 
 //----------------------------------------------------------------------
 // Debugging
@@ -66,6 +74,9 @@ namespace canvas
 // Forward declarations / typedefs / enums
 //----------------------------------------------------------------------
 
+/*! Commands with at most this number of values are assembled in a local buffer - and written with a single stream write */
+const size_t cMAX_INLINE_COMMAND_VALUES = 16;
+
 //----------------------------------------------------------------------
 // Class declaration
 //----------------------------------------------------------------------
@@ -98,22 +109,201 @@ public:
 
   tCanvas();
 
+  /*!
+   * Takes over buffer (with its capacity), stream and state of o.
+   * No memory is allocated. o is left without buffer: it may only be destroyed
+   * or assigned to (tCanvasPool discards such canvases on release).
+   */
   tCanvas(tCanvas && o);
 
   virtual ~tCanvas() {}
 
+  /*!
+   * Swaps buffers, streams and state with o (no memory is allocated or freed)
+   */
   tCanvas& operator=(tCanvas && o);
 
   /*!
    * Clear canvas
+   *
+   * The buffer's capacity is kept. So a canvas that is cleared and redrawn
+   * with similar content (e.g. in every control cycle) does not allocate memory after warm-up.
    */
   void Clear();
 
+  /*!
+   * Disables culling (transformation folding remains enabled)
+   */
+  void DisableCulling()
+  {
+    this->culling = false;
+  }
+
+  /*!
+   * \return Codec that is used when canvas is serialized (see SetCompression())
+   */
+  tCompression GetCompression() const
+  {
+    return this->compression;
+  }
+
+  /*!
+   * \return Precision with which coordinates are written (see SetCoordinatePrecision())
+   */
+  tCoordinatePrecision GetCoordinatePrecision() const
+  {
+    return this->half_precision ? eHALF_PRECISION : eFULL_PRECISION;
+  }
+
+  /*!
+   * \return Whether primitives with many points are split into commands with 16 bit point counts (see SetLegacyPointCounts())
+   */
+  bool GetLegacyPointCounts() const
+  {
+    return this->legacy_point_counts;
+  }
+
+  /*!
+   * \return Number of primitives and point cloud points that were dropped by culling (since construction)
+   */
+  size_t GetCulledCount() const
+  {
+    return this->culled_count;
+  }
+
+  /*!
+   * State commands (colors, alpha, fill, Z, extrusion) that would not change
+   * the current state are not written to the canvas.
+   *
+   * \return Number of bytes that were saved this way (since construction)
+   */
+  size_t GetElidedBytes() const
+  {
+    return this->elided_bytes;
+  }
+
+  /*!
+   * \return Number of bytes the buffer can hold without reallocation
+   */
+  size_t GetCapacity() const
+  {
+    return this->buffer->GetCapacity();
+  }
+
+  /*!
+   * \return Largest size (in bytes) the canvas had when Clear() was called
+   *         (a hint for the size of the next frame)
+   */
+  size_t GetHighWaterMark() const
+  {
+    return this->high_water_mark;
+  }
+
+  /*!
+   * \return Whether culling is enabled (see SetCullingViewport() of tCanvas2D and SetCullingFrustum() of tCanvas3D)
+   */
+  bool IsCulling() const
+  {
+    return this->culling;
+  }
+
+  /*!
+   * \return Whether transformation folding is enabled (see SetTransformationFolding() of tCanvas2D and tCanvas3D)
+   */
+  bool IsTransformationFolding() const
+  {
+    return this->transformation_folding;
+  }
+
+  /*!
+   * \return Current size of canvas data in bytes
+   */
+  size_t GetSize() const
+  {
+    return this->stream->GetPosition();
+  }
+
+  /*!
+   * Ensures that the buffer can hold the specified number of bytes without reallocation
+   * (Clear() reserves the high water mark - so this only needs to be called
+   * to avoid reallocations in the first frames)
+   *
+   * \param bytes Number of bytes
+   */
+  void Reserve(size_t bytes);
+
+  /*!
+   * Restores transformation that was saved with last call to PushTransformation()
+   * (requires transformation folding)
+   */
+  void PopTransformation();
+
+  /*!
+   * Saves current transformation - so that it can be restored with PopTransformation()
+   * (requires transformation folding)
+   */
+  void PushTransformation();
+
+  /*!
+   * Restores the settings of a newly constructed canvas: disables transformation folding and culling,
+   * compression, half precision and legacy point counts - and resets the culled and elided counters.
+   * Canvas content is not changed (Clear() and ResetSettings() together yield a canvas that behaves like a new one).
+   */
+  void ResetSettings();
+
+  /*!
+   * Enables compressed serialization: operator << then writes the canvas data compressed in blocks (eCOMPRESSED).
+   * operator >> decompresses such data transparently. Readers that do not support compression
+   * see a single unknown command - and therefore an empty canvas.
+   *
+   * \param compression Codec to use (eNO_COMPRESSION disables compression)
+   * \param level Compression level (zstd) or acceleration (LZ4: higher values are faster). 0 selects the codec's default.
+   * \return False if the codec is not available (compression is then disabled)
+   */
+  bool SetCompression(tCompression compression, int level = 0);
+
+  /*!
+   * Sets precision with which coordinates of subsequently drawn primitives are written.
+   * With eHALF_PRECISION, float and double coordinates of primitives, paths and point clouds are
+   * converted to eHALF (2 bytes per value) - without changes to any Draw*() call.
+   * Transformations, Z, extrusion - and offsets and steps of quantized point clouds and delta encoded points - are always written with full precision.
+   *
+   * Half precision is sufficient for local geometry (e.g. in a robot's frame): relative precision is about 1/2048
+   * (e.g. 0.5mm at 1m and 3cm at 50m). Coordinates beyond +-65504 become infinity.
+   *
+   * \param precision Precision of coordinates
+   */
+  void SetCoordinatePrecision(tCoordinatePrecision precision)
+  {
+    this->half_precision = (precision == eHALF_PRECISION);
+  }
+
+  /*!
+   * Sets how 2D line strips, polygons and splines with more than 65535 points are written.
+   * By default, they are written as single commands with 32 bit point count (eDRAW_LINE_STRIP_LONG etc.).
+   * With legacy point counts, only opcodes with 16 bit point counts are used - so that readers without support
+   * for the long opcodes can display the canvas: line strips and splines are split into commands that share
+   * their end points (the tangents of splines are not continuous at these points) - polygons are written as shapes.
+   *
+   * \param legacy Whether to use only opcodes with 16 bit point counts
+   */
+  void SetLegacyPointCounts(bool legacy)
+  {
+    this->legacy_point_counts = legacy;
+  }
+
   /*!
    * Reset Canvas' current transformation (to identity matrix)
    */
   void ResetTransformation()
   {
+    if (this->transformation_folding)
+    {
+      this->folded_transformation.SetIdentity();
+      this->transformation_pending = true;
+      this->local_culling_frustum_valid = false;
+      return;
+    }
     this->AppendCommandRaw(eRESET_TRANSFORMATION);
   }
 
@@ -123,7 +313,9 @@ public:
   void SetColor(uint8_t r, uint8_t g, uint8_t b)
   {
     uint8_t buffer[] = { r, g, b };
-    this->AppendCommandRaw(eSET_COLOR, buffer, sizeof(buffer));
+    bool edge_changed = this->UpdateState(eSTATE_EDGE_COLOR, buffer, sizeof(buffer));
+    bool fill_changed = this->UpdateState(eSTATE_FILL_COLOR, buffer, sizeof(buffer));
+    this->AppendStateCommand(eSET_COLOR, buffer, sizeof(buffer), edge_changed || fill_changed);
   }
   void SetColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
   {
@@ -141,7 +333,7 @@ public:
   void SetEdgeColor(uint8_t r, uint8_t g, uint8_t b)
   {
     uint8_t buffer[] = { r, g, b };
-    this->AppendCommandRaw(eSET_EDGE_COLOR, buffer, sizeof(buffer));
+    this->AppendStateCommand(eSET_EDGE_COLOR, buffer, sizeof(buffer), this->UpdateState(eSTATE_EDGE_COLOR, buffer, sizeof(buffer)));
   }
   void SetEdgeColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
   {
@@ -159,7 +351,7 @@ public:
   void SetFillColor(uint8_t r, uint8_t g, uint8_t b)
   {
     uint8_t buffer[] = { r, g, b };
-    this->AppendCommandRaw(eSET_FILL_COLOR, buffer, sizeof(buffer));
+    this->AppendStateCommand(eSET_FILL_COLOR, buffer, sizeof(buffer), this->UpdateState(eSTATE_FILL_COLOR, buffer, sizeof(buffer)));
   }
   void SetFillColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
   {
@@ -177,7 +369,7 @@ public:
   void SetFill(bool fill_objects)
   {
     uint8_t buffer = fill_objects ? 1 : 0;
-    this->AppendCommandRaw(eSET_FILL, &buffer, 1);
+    this->AppendStateCommand(eSET_FILL, &buffer, 1, this->UpdateState(eSTATE_FILL, &buffer, 1));
   }
 
   /*!
@@ -187,7 +379,7 @@ public:
    */
   void SetAlpha(uint8_t alpha)
   {
-    this->AppendCommandRaw(eSET_ALPHA, &alpha, sizeof(alpha));
+    this->AppendStateCommand(eSET_ALPHA, &alpha, sizeof(alpha), this->UpdateState(eSTATE_ALPHA, &alpha, sizeof(alpha)));
   }
 
   /*!
@@ -234,9 +426,83 @@ protected:
   /*! Offset of (any) default viewport in canvas */
   size_t default_viewport_offset;
 
+  /*! State variables that are tracked to elide redundant state commands */
+  enum tStateVariable
+  {
+    eSTATE_EDGE_COLOR,
+    eSTATE_FILL_COLOR,
+    eSTATE_ALPHA,
+    eSTATE_FILL,
+    eSTATE_Z,
+    eSTATE_EXTRUSION,
+    eSTATE_VARIABLE_COUNT
+  };
+
+  /*!
+   * Appends state command - or counts its bytes as elided if it does not change the state
+   *
+   * \param opcode Opcode
+   * \param buffer Raw byte buffer
+   * \param bytes Size in bytes of raw buffer
+   * \param state_changed Whether command changes state (see UpdateState())
+   */
+  void AppendStateCommand(tCanvasOpCode opcode, void* buffer, size_t bytes, bool state_changed)
+  {
+    if (state_changed)
+    {
+      this->AppendCommandRaw(opcode, buffer, bytes);
+    }
+    else
+    {
+      this->elided_bytes += 1 + bytes;
+    }
+  }
+
+  /*!
+   * Appends numeric state command (eSET_Z, eSET_EXTRUSION) - unless it does not change the state
+   */
+  template <typename T>
+  void AppendStateCommand(tCanvasOpCode opcode, tStateVariable variable, T value)
+  {
+    uint8_t key[1 + sizeof(T)];
+    key[0] = static_cast<uint8_t>(tNumberType<T>::value);
+    internal::CopyLittleEndian(&value, 1, key + 1);
+    if (this->UpdateState(variable, key, sizeof(key)))
+    {
+      this->AppendCommand(opcode, &value, 1);
+    }
+    else
+    {
+      this->elided_bytes += 1 + sizeof(key);
+    }
+  }
+
+  /*!
+   * Updates tracked value of state variable
+   *
+   * \param variable State variable
+   * \param value Serialized value (at most 9 bytes)
+   * \param bytes Size of value
+   * \return True if the value differs from the tracked value (or if the tracked value is unknown)
+   */
+  bool UpdateState(tStateVariable variable, const void* value, size_t bytes)
+  {
+    tStateValue& state = this->state_values[variable];
+    if (state.size == bytes && std::memcmp(state.bytes, value, bytes) == 0)
+    {
+      return false;
+    }
+    state.size = static_cast<uint8_t>(bytes);
+    std::memcpy(state.bytes, value, bytes);
+    return true;
+  }
+
   /*!
    * Adds command to canvas data
    *
+   * Commands with up to cMAX_INLINE_COMMAND_VALUES values are assembled (opcode, number type and values)
+   * in a local buffer and written with a single stream write.
+   *
    * \param opcode Opcode
    * \param values Buffer with values
    * \param value_count Number of values in buffer
@@ -244,15 +510,76 @@ protected:
   template <typename T>
   inline void AppendCommand(tCanvasOpCode opcode, const T *values, size_t value_count)
   {
-    // TODO could be optimized
-    (*this->stream) << static_cast<uint8_t>(opcode) << static_cast<uint8_t>(tNumberType<T>::value);
-#if __BYTE_ORDER == __ORDER_BIG_ENDIAN
-    for (size_t i = 0; i < value_count; i++)
+    if (value_count <= cMAX_INLINE_COMMAND_VALUES)
+    {
+      char command[2 + cMAX_INLINE_COMMAND_VALUES * sizeof(T)];
+      this->stream->Write(command, this->EncodeCommand(opcode, values, value_count, command));
+      return;
+    }
+    if (this->transformation_pending && IsTransformed(opcode))
+    {
+      this->WritePendingTransformation();
+    }
+    bool half = std::is_floating_point<T>::value && this->half_precision && IsHalfPrecisionCandidate(opcode);
+    uint8_t header[2] = { static_cast<uint8_t>(opcode), half ? static_cast<uint8_t>(eHALF) : static_cast<uint8_t>(tNumberType<T>::value) };
+    this->stream->Write(header, sizeof(header));
+    if (half)
+    {
+      this->AppendHalfValues(values, value_count);
+      return;
+    }
+    this->AppendLittleEndian(values, value_count);
+  }
+
+  /*!
+   * Adds command with a fixed number of values to canvas data
+   * (size of command is known at compile time - it is written with a single stream write)
+   *
+   * \param opcode Opcode
+   * \param values Array with values
+   */
+  template <typename T, size_t Tcount>
+  inline void AppendCommand(tCanvasOpCode opcode, const T(&values)[Tcount])
+  {
+    if (this->transformation_pending && IsTransformed(opcode))
     {
-      this->stream->WriteNumber<T>(values[i]);
+      this->WritePendingTransformation();
+    }
+    if (std::is_floating_point<T>::value && this->half_precision && IsHalfPrecisionCandidate(opcode))
+    {
+      char command[2 + Tcount * sizeof(uint16_t)];
+      this->EncodeHalfCommand(opcode, values, Tcount, command);
+      this->stream->Write(command, sizeof(command));
+      return;
+    }
+    char command[2 + Tcount * sizeof(T)];
+    command[0] = static_cast<char>(opcode);
+    command[1] = static_cast<char>(tNumberType<T>::value);
+    internal::CopyLittleEndian(values, Tcount, command + 2);
+    this->stream->Write(command, sizeof(command));
+  }
+
+  /*!
+   * Writes values in little endian byte order
+   * (single stream write on little endian platforms - byte-swapped chunks otherwise)
+   *
+   * \param values Values to write
+   * \param count Number of values
+   */
+  template <typename T>
+  inline void AppendLittleEndian(const T* values, size_t count)
+  {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const size_t cCHUNK_SIZE = 1024;
+    char chunk[cCHUNK_SIZE * sizeof(T)];
+    for (size_t offset = 0; offset < count; offset += cCHUNK_SIZE)
+    {
+      size_t chunk_count = std::min(cCHUNK_SIZE, count - offset);
+      internal::SwapByteOrder(values + offset, chunk_count, chunk);
+      this->stream->Write(chunk, chunk_count * sizeof(T));
     }
 #else
-    this->stream->Write(values, value_count * sizeof(T));
+    this->stream->Write(values, count * sizeof(T));
 #endif
   }
 
@@ -272,11 +599,44 @@ protected:
   inline void AppendData(TIterator data_begin, TIterator data_end)
   {
     typedef typename std::iterator_traits<TIterator>::value_type tData;
-    (*this->stream) << static_cast<uint8_t>(tNumberType<typename tElementExtractor<std::is_fundamental<tData>::value, tData>::tElement>::value);
-    std::for_each(data_begin, data_end, [this](const tData & vector)
+    typedef typename tElementExtractor<std::is_fundamental<tData>::value, tData>::tElement tElement;
+    if (std::is_floating_point<tElement>::value && this->half_precision_data)
     {
-      this->stream->Write(&vector, sizeof(tData));
-    });
+      (*this->stream) << static_cast<uint8_t>(eHALF);
+      this->AppendHalfDataValues<tElement>(data_begin, data_end, std::integral_constant<bool, tIsContiguousIterator<TIterator>::value>());
+      return;
+    }
+    (*this->stream) << static_cast<uint8_t>(tNumberType<tElement>::value);
+    this->AppendDataValues<tElement>(data_begin, data_end, std::integral_constant<bool, tIsContiguousIterator<TIterator>::value>());
+  }
+
+  /*!
+   * Adds structure-of-arrays data to canvas data - interleaving it on the fly
+   * (number type followed by c0[0], c1[0], ..., c0[1], c1[1], ...)
+   *
+   * \param channels Pointers to channel arrays (e.g. x, y, z)
+   * \param count Number of values in each channel
+   */
+  template <size_t Tchannels, typename T>
+  inline void AppendInterleavedData(const T* const(&channels)[Tchannels], size_t count)
+  {
+    bool half = std::is_floating_point<T>::value && this->half_precision_data;
+    (*this->stream) << (half ? static_cast<uint8_t>(eHALF) : static_cast<uint8_t>(tNumberType<T>::value));
+    const size_t cCHUNK_SIZE = 512;
+    T chunk[cCHUNK_SIZE * Tchannels];
+    for (size_t offset = 0; offset < count; offset += cCHUNK_SIZE)
+    {
+      size_t chunk_count = std::min(cCHUNK_SIZE, count - offset);
+      internal::tInterleave<Tchannels, T>::Interleave(channels, offset, chunk_count, chunk);
+      if (half)
+      {
+        this->AppendHalfValues(chunk, chunk_count * Tchannels);
+      }
+      else
+      {
+        this->AppendLittleEndian(chunk, chunk_count * Tchannels);
+      }
+    }
   }
 
   /*!
@@ -286,6 +646,180 @@ protected:
    */
   void AppendCanvas(const tCanvas& canvas);
 
+  /*!
+   * Counts points that were dropped by culling
+   */
+  void AddCulledPoints(size_t count)
+  {
+    this->culled_count += count;
+  }
+
+  /*!
+   * Checks whether axis-aligned box (in current coordinates) is visible
+   * (must only be called if culling is enabled)
+   *
+   * \param min Minimum corner of box
+   * \param max Maximum corner of box
+   * \return True if box is not visible (it is then counted as culled)
+   */
+  bool CullBox(const double(&min)[3], const double(&max)[3])
+  {
+    if (this->GetLocalCullingFrustum().IntersectsBox(min, max))
+    {
+      return false;
+    }
+    this->culled_count++;
+    return true;
+  }
+
+  /*!
+   * Checks whether points (in current coordinates) are visible
+   * (must only be called if culling is enabled)
+   *
+   * \tparam Tdimension Dimension of vectors (2 or 3)
+   * \param points_begin Iterator to first point (vector)
+   * \param points_end Iterator after last point
+   * \return True if the bounding box of the points is not visible (the points are then counted as one culled primitive)
+   */
+  template <size_t Tdimension, typename TIterator>
+  bool CullPoints(TIterator points_begin, TIterator points_end)
+  {
+    if (points_begin == points_end)
+    {
+      return false;
+    }
+    double min[3] = { 0, 0, 0 };
+    double max[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < Tdimension; i++)
+    {
+      min[i] = max[i] = static_cast<double>((*points_begin)[i]);
+    }
+    for (TIterator it = points_begin; it != points_end; ++it)
+    {
+      for (size_t i = 0; i < Tdimension; i++)
+      {
+        double value = static_cast<double>((*it)[i]);
+        min[i] = std::min(min[i], value);
+        max[i] = std::max(max[i], value);
+      }
+    }
+    return this->CullBox(min, max);
+  }
+
+  /*!
+   * Variant of CullPoints() for points in a buffer of values (x1, y1[, z1], x2, ...)
+   *
+   * \param values Buffer with values
+   * \param point_count Number of points in buffer
+   * \param dimension Number of values per point (2 or 3)
+   */
+  template <typename T>
+  bool CullValues(const T* values, size_t point_count, size_t dimension)
+  {
+    double min[3] = { 0, 0, 0 };
+    double max[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < dimension; i++)
+    {
+      min[i] = max[i] = static_cast<double>(values[i]);
+    }
+    for (size_t p = 1; p < point_count; p++)
+    {
+      for (size_t i = 0; i < dimension; i++)
+      {
+        double value = static_cast<double>(values[p * dimension + i]);
+        min[i] = std::min(min[i], value);
+        max[i] = std::max(max[i], value);
+      }
+    }
+    return this->CullBox(min, max);
+  }
+
+  /*!
+   * Variant of CullPoints() for structure-of-arrays data
+   *
+   * \param channels Pointers to coordinate arrays (x, y[, z])
+   * \param count Number of points
+   */
+  template <size_t Tdimension, typename T>
+  bool CullPoints(const T* const(&channels)[Tdimension], size_t count)
+  {
+    if (count == 0)
+    {
+      return false;
+    }
+    double min[3] = { 0, 0, 0 };
+    double max[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < Tdimension; i++)
+    {
+      const std::pair<const T*, const T*> bounds = std::minmax_element(channels[i], channels[i] + count);
+      min[i] = static_cast<double>(*bounds.first);
+      max[i] = static_cast<double>(*bounds.second);
+    }
+    return this->CullBox(min, max);
+  }
+
+  /*!
+   * Collects points of point cloud that are visible
+   * (must only be called if culling is enabled - points that are not visible are counted as culled)
+   *
+   * \param points_begin Iterator to first point (vector with at least three elements: x, y, z)
+   * \param points_end Iterator after last point
+   * \param visible_points Vector to store visible points in
+   */
+  template <typename TIterator, typename TVector>
+  void GetVisiblePoints(TIterator points_begin, TIterator points_end, std::vector<TVector>& visible_points)
+  {
+    const tViewFrustum& frustum = this->GetLocalCullingFrustum();
+    for (TIterator it = points_begin; it != points_end; ++it)
+    {
+      const TVector& point = *it;
+      if (frustum.Contains(static_cast<double>(point[0]), static_cast<double>(point[1]), static_cast<double>(point[2])))
+      {
+        visible_points.push_back(point);
+      }
+    }
+    this->culled_count += std::distance(points_begin, points_end) - visible_points.size();
+  }
+
+  /*!
+   * \return Culling frustum in current coordinates
+   */
+  const tViewFrustum& GetLocalCullingFrustum()
+  {
+    if (!this->local_culling_frustum_valid)
+    {
+      this->local_culling_frustum = this->culling_frustum.Transformed(this->folded_transformation);
+      this->local_culling_frustum_valid = true;
+    }
+    return this->local_culling_frustum;
+  }
+
+  /*!
+   * Enables culling (and transformation folding - as the current transformation needs to be known)
+   *
+   * \param frustum Visible volume (in coordinates of canvas without transformation)
+   * \param dimension Dimension of canvas (2 or 3)
+   */
+  void SetCulling(const tViewFrustum& frustum, uint8_t dimension);
+
+  /*!
+   * Enables or disables transformation folding
+   *
+   * \param dimension Dimension of canvas (2 or 3) - 0 disables transformation folding
+   */
+  void SetTransformationFolding(uint8_t dimension);
+
+  /*!
+   * Applies transformation to folded transformation
+   * (called by transformation methods of subclasses when transformation folding is enabled)
+   */
+  internal::tAffineTransformation& FoldTransformation()
+  {
+    this->transformation_pending = true;
+    this->local_culling_frustum_valid = false;
+    return this->folded_transformation;
+  }
+
   inline rrlib::serialization::tOutputStream &Stream()
   {
     return *this->stream;
@@ -298,6 +832,146 @@ private:
 
   friend serialization::tOutputStream& operator << (serialization::tOutputStream& stream, const tCanvas& canvas);
   friend serialization::tInputStream& operator >> (serialization::tInputStream& stream, tCanvas& canvas);
+  friend class tCanvasReader;
+  friend class tCanvasDeltaEncoder;
+  friend class tCanvasDeltaDecoder;
+  friend class tCanvasOptimizer;
+  friend class tCanvasPlayer;
+  friend class tCanvasRecorder;
+  template <typename TCanvas>
+  friend class tLayeredCanvas;
+  template <typename TCanvas>
+  friend class tCanvasShardSet;
+  template <typename TCanvas>
+  friend class tCanvasPool;
+
+  /*!
+   * Is TIterator an iterator over values that are stored contiguously in memory?
+   * (raw pointers and std::vector iterators)
+   */
+  template <typename TIterator>
+  struct tIsContiguousIterator
+  {
+    typedef typename std::iterator_traits<TIterator>::value_type tData;
+    enum { value = std::is_pointer<TIterator>::value ||
+                   std::is_same<TIterator, typename std::vector<tData>::iterator>::value ||
+                   std::is_same<TIterator, typename std::vector<tData>::const_iterator>::value
+         };
+  };
+
+  /*!
+   * Writes contiguous range of values with a single stream write
+   */
+  template <typename TElement, typename TIterator>
+  inline void AppendDataValues(TIterator data_begin, TIterator data_end, std::true_type)
+  {
+    typedef typename std::iterator_traits<TIterator>::value_type tData;
+    size_t count = std::distance(data_begin, data_end);
+    if (count)
+    {
+      this->AppendLittleEndian(reinterpret_cast<const TElement*>(&(*data_begin)), count * (sizeof(tData) / sizeof(TElement)));
+    }
+  }
+
+  /*!
+   * Writes values of other iterator ranges one by one
+   */
+  template <typename TElement, typename TIterator>
+  inline void AppendDataValues(TIterator data_begin, TIterator data_end, std::false_type)
+  {
+    typedef typename std::iterator_traits<TIterator>::value_type tData;
+    std::for_each(data_begin, data_end, [this](const tData & vector)
+    {
+      this->AppendLittleEndian(reinterpret_cast<const TElement*>(&vector), sizeof(tData) / sizeof(TElement));
+    });
+  }
+
+  /*!
+   * Writes opcode, number type and values of command to buffer
+   * (writes pending transformation to canvas first - if command is affected by it)
+   *
+   * \param destination Buffer for at least 2 + value_count * sizeof(T) bytes
+   * \return Size of command in bytes
+   */
+  template <typename T>
+  inline size_t EncodeCommand(tCanvasOpCode opcode, const T *values, size_t value_count, char* destination)
+  {
+    if (this->transformation_pending && IsTransformed(opcode))
+    {
+      this->WritePendingTransformation();
+    }
+    if (std::is_floating_point<T>::value && this->half_precision && IsHalfPrecisionCandidate(opcode))
+    {
+      this->EncodeHalfCommand(opcode, values, value_count, destination);
+      return 2 + value_count * sizeof(uint16_t);
+    }
+    destination[0] = static_cast<char>(opcode);
+    destination[1] = static_cast<char>(tNumberType<T>::value);
+    internal::CopyLittleEndian(values, value_count, destination + 2);
+    return 2 + value_count * sizeof(T);
+  }
+
+  /*!
+   * Writes opcode, number type (eHALF) and values of command converted to half precision to buffer
+   *
+   * \param destination Buffer for at least 2 + value_count * 2 bytes
+   */
+  template <typename T>
+  inline void EncodeHalfCommand(tCanvasOpCode opcode, const T *values, size_t value_count, char* destination)
+  {
+    destination[0] = static_cast<char>(opcode);
+    destination[1] = static_cast<char>(eHALF);
+    uint16_t half[cMAX_INLINE_COMMAND_VALUES];
+    for (size_t offset = 0; offset < value_count; offset += cMAX_INLINE_COMMAND_VALUES)
+    {
+      size_t chunk_count = std::min(cMAX_INLINE_COMMAND_VALUES, value_count - offset);
+      internal::ConvertToHalf(values + offset, chunk_count, half);
+      internal::CopyLittleEndian(half, chunk_count, destination + 2 + offset * sizeof(uint16_t));
+    }
+  }
+
+  /*!
+   * Converts values to half precision and writes them (in chunks)
+   */
+  template <typename T>
+  void AppendHalfValues(const T* values, size_t count)
+  {
+    const size_t cCHUNK_SIZE = 1024;
+    uint16_t chunk[cCHUNK_SIZE];
+    for (size_t offset = 0; offset < count; offset += cCHUNK_SIZE)
+    {
+      size_t chunk_count = std::min(cCHUNK_SIZE, count - offset);
+      internal::ConvertToHalf(values + offset, chunk_count, chunk);
+      this->AppendLittleEndian(chunk, chunk_count);
+    }
+  }
+
+  /*!
+   * Writes contiguous range of values (or vectors) with half precision
+   */
+  template <typename TElement, typename TIterator>
+  inline void AppendHalfDataValues(TIterator data_begin, TIterator data_end, std::true_type)
+  {
+    typedef typename std::iterator_traits<TIterator>::value_type tData;
+    size_t count = std::distance(data_begin, data_end);
+    if (count)
+    {
+      this->AppendHalfValues(reinterpret_cast<const TElement*>(&(*data_begin)), count * (sizeof(tData) / sizeof(TElement)));
+    }
+  }
+
+  /*!
+   * Writes values (or vectors) of other iterator ranges one by one with half precision
+   */
+  template <typename TElement, typename TIterator>
+  inline void AppendHalfDataValues(TIterator data_begin, TIterator data_end, std::false_type)
+  {
+    typedef typename std::iterator_traits<TIterator>::value_type tData;
+    std::for_each(data_begin, data_end, [this](const tData & vector)
+    {
+      this->AppendHalfValues(reinterpret_cast<const TElement*>(&vector), sizeof(tData) / sizeof(TElement));
+    });
+  }
 
   template <bool, typename T>
   struct tElementExtractor
@@ -315,6 +989,117 @@ private:
 
   /*! Stream to serialize to disposable geometry buffer */
   std::unique_ptr<rrlib::serialization::tOutputStream> stream;
+
+  /*! Largest size of canvas data when Clear() was called */
+  size_t high_water_mark;
+
+  /*! Tracked value of state variable (parameters of its state command - size 0 means unknown or not set) */
+  struct tStateValue
+  {
+    uint8_t size;
+    uint8_t bytes[9];
+  };
+  tStateValue state_values[eSTATE_VARIABLE_COUNT];
+
+  /*!
+   * True if all state commands in buffer were appended via tracking methods.
+   * Then, unknown values in state_values mean that the variable was not set.
+   * (False e.g. after deserialization)
+   */
+  bool state_fully_tracked;
+
+  /*! Number of bytes of elided state commands */
+  size_t elided_bytes;
+
+  /*! Dimension of canvas if transformation folding is enabled - otherwise 0 */
+  uint8_t transformation_folding;
+
+  /*! True if folded transformation has changed and needs to be written before the next primitive */
+  bool transformation_pending;
+
+  /*! Current transformation (if transformation folding is enabled) */
+  internal::tAffineTransformation folded_transformation;
+
+  /*! Transformations saved by PushTransformation() */
+  std::vector<internal::tAffineTransformation> transformation_stack;
+
+  /*! Whether culling is enabled */
+  bool culling;
+
+  /*! Whether local_culling_frustum is up to date */
+  bool local_culling_frustum_valid;
+
+  /*! Visible volume (in coordinates of canvas without transformation) */
+  tViewFrustum culling_frustum;
+
+  /*! Visible volume in current coordinates (transformed with folded transformation) */
+  tViewFrustum local_culling_frustum;
+
+  /*! Number of primitives and point cloud points that were dropped by culling */
+  size_t culled_count;
+
+  /*! Codec and level used for serialization */
+  tCompression compression;
+  int compression_level;
+
+  /*! Whether coordinates are written with half precision (see SetCoordinatePrecision()) */
+  bool half_precision;
+
+  /*! Whether values appended via AppendData() belong to a command written with half precision (set by AppendCommandRaw()) */
+  bool half_precision_data;
+
+  /*! Whether long primitives are split into commands with 16 bit point counts (see SetLegacyPointCounts()) */
+  bool legacy_point_counts;
+
+  /*!
+   * \return Whether the command with the specified opcode is affected by the current transformation
+   *          (primitives and paths - in contrast to state and transformation commands)
+   */
+  static bool IsTransformed(tCanvasOpCode opcode)
+  {
+    return (opcode >= eDRAW_POINT && opcode <= ePATH_CUBIC_BEZIER_CURVE) || opcode == eDRAW_COLORED_POINT_CLOUD ||
+           opcode == eDRAW_POINT_CLOUD || (opcode >= eDRAW_QUANTIZED_POINT_CLOUD && opcode <= eDRAW_POINT_CLOUD_LOD) || opcode == eDRAW_DELTA_ENCODED_POINTS || (opcode >= eDRAW_LINE_STRIP_LONG && opcode <= eDRAW_SPLINE_LONG);
+  }
+
+  /*!
+   * \return Whether coordinates of the command with the specified opcode are written with half precision if eHALF_PRECISION is set
+   *          (quantized point clouds and delta encoded points need their offset and step with full precision)
+   */
+  static bool IsHalfPrecisionCandidate(tCanvasOpCode opcode)
+  {
+    return IsTransformed(opcode) && opcode != eDRAW_QUANTIZED_POINT_CLOUD && opcode != eDRAW_DELTA_ENCODED_POINTS;
+  }
+
+  /*!
+   * Merges tracked state of canvas whose commands were appended to this canvas
+   */
+  void MergeState(const tCanvas& appended);
+
+  /*!
+   * Resets tracked state, transformation and path mode after canvas data was replaced with loaded data
+   * (restores default viewport offset from loaded data)
+   */
+  void ResetAfterLoad();
+
+  /*!
+   * Resets tracked state
+   *
+   * \param buffer_fully_tracked Whether all state commands in buffer were appended via tracking methods
+   */
+  void ResetState(bool buffer_fully_tracked);
+
+  /*!
+   * Restores state variables to the specified values - appending state commands for all variables that differ
+   * (variables that are unknown in 'values' cannot be restored - they become unknown)
+   *
+   * \param values Tracked values to restore (e.g. copy of state_values)
+   */
+  void RestoreState(const tStateValue(&values)[eSTATE_VARIABLE_COUNT]);
+
+  /*!
+   * Writes folded transformation to canvas (as eSET_TRANSFORMATION command)
+   */
+  void WritePendingTransformation();
 };
 
 serialization::tOutputStream& operator << (serialization::tOutputStream& stream, const tCanvas& canvas);
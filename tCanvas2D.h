@@ -122,6 +122,45 @@ public:
   template <typename T>
   inline void SetDefaultViewport(const math::tVector<2, T> &bottom_left, T width, T height = -1);
 
+  /*!
+   * Enables culling: points, line segments, line strips, boxes, ellipsoids, polygons and bezier curves
+   * that are completely outside the specified viewport (after transformation) are not written to the canvas.
+   *
+   * Culling tracks the current transformation - so it enables transformation folding.
+   * Paths, lines, arrows and text are not culled.
+   *
+   * \param bottom_left_x Left of viewport
+   * \param bottom_left_y Bottom of viewport
+   * \param width Width of viewport
+   * \param height Height of viewport
+   */
+  template <typename T>
+  void SetCullingViewport(T bottom_left_x, T bottom_left_y, T width, T height)
+  {
+    this->SetCulling(tViewFrustum::FromRectangle(bottom_left_x, bottom_left_y, width, height), 2);
+  }
+
+  /*!
+   * Enables or disables transformation folding
+   *
+   * With transformation folding, SetTransformation(), Transform(), Translate(), Rotate(), Scale() and
+   * ResetTransformation() do not write commands. Instead, the current transformation is accumulated
+   * client-side (in double precision) and written as a single eSET_TRANSFORMATION command when
+   * the next primitive is drawn after a change. PushTransformation() and PopTransformation()
+   * may be used to save and restore the current transformation.
+   *
+   * The folded transformation starts with the identity matrix - so folding should be enabled
+   * before any transformation commands are written (folding is kept when the canvas is cleared).
+   * Transformation matrices are expected to be affine (last row is ignored).
+   * Disabling transformation folding also disables culling.
+   *
+   * \param enable Whether to enable transformation folding
+   */
+  void SetTransformationFolding(bool enable)
+  {
+    tCanvas::SetTransformationFolding(enable ? 2 : 0);
+  }
+
   /*!
    * Set affine transformation of all following operations
    * Overwrites current transform completely.
@@ -172,6 +211,13 @@ public:
   template <typename T>
   void SetZ(T z);
 
+  /*!
+   * Set extrusion for 2D-Shapes painted to canvas
+   * (e.g. height of obstacles when shown in 3D)
+   */
+  template <typename T>
+  void SetExtrusion(T extrusion);
+
   /*!
    * Draw Point
    */
@@ -201,6 +247,7 @@ public:
 
   /*!
    * Draw Line Strip
+   * (number of points is not limited to 65535 - see tCanvas::SetLegacyPointCounts())
    */
   template <typename TIterator>
   void DrawLineStrip(TIterator points_begin, TIterator points_end);
@@ -208,6 +255,16 @@ public:
   template <typename TElement, typename ... TVectors>
   void DrawLineStrip(const math::tVector<2, TElement> &p1, const math::tVector<2, TElement> &p2, const TVectors &... rest);
 
+  /*!
+   * Draw Line Strip from separate coordinate arrays
+   *
+   * \param x Array with x coordinates of points
+   * \param y Array with y coordinates of points
+   * \param count Number of points
+   */
+  template <typename T>
+  void DrawLineStrip(const T* x, const T* y, size_t count);
+
   /*!
    * Draw arrow
    */
@@ -246,6 +303,7 @@ public:
 
   /*!
    * Draw Polygon
+   * (number of points is not limited to 65535 - see tCanvas::SetLegacyPointCounts())
    */
   template <typename TIterator>
   void DrawPolygon(TIterator points_begin, TIterator points_end);
@@ -255,10 +313,33 @@ public:
 
   /*!
    * Draw Spline
+   * (number of points is not limited to 65535 - see tCanvas::SetLegacyPointCounts())
    */
   template <typename TIterator>
   void DrawSpline(TIterator points_begin, TIterator points_end, float tension = 0.0);
 
+  /*!
+   * Draw line strip, polygon or spline with delta encoded points
+   *
+   * Points are quantized to multiples of the resolution (relative to the first point) - and differences between
+   * consecutive points are stored as zigzag varints. For paths of nearby points (e.g. from a planner), this needs 1-2 bytes
+   * per coordinate (instead of 4 for float and 8 for double coordinates). Number of points is not limited to 65535.
+   * Each decoded coordinate differs from the original coordinate by at most half of the resolution
+   * (see tCanvasCommand::DecodeDeltaEncodedPoints()). Coordinates must be finite.
+   *
+   * \param points_begin Iterator to first point
+   * \param points_end Iterator past last point
+   * \param resolution Quantization step (> 0)
+   */
+  template <typename TIterator>
+  void DrawDeltaEncodedLineStrip(TIterator points_begin, TIterator points_end, double resolution);
+
+  template <typename TIterator>
+  void DrawDeltaEncodedPolygon(TIterator points_begin, TIterator points_end, double resolution);
+
+  template <typename TIterator>
+  void DrawDeltaEncodedSpline(TIterator points_begin, TIterator points_end, double resolution, float tension = 0.0);
+
   /*!
    * Draw Text
    */
@@ -266,7 +347,7 @@ public:
   void DrawText(T x, T y, const S& text)
   {
     T values[] = { x, y };
-    AppendCommand(eDRAW_STRING, values, 2);
+    AppendCommand(eDRAW_STRING, values);
     this->Stream().WriteString(text);
   }
   template <typename T, typename S>
@@ -339,6 +420,46 @@ public:
 //----------------------------------------------------------------------
 private:
 
+  /*!
+   * Appends eDRAW_DELTA_ENCODED_POINTS command
+   *
+   * \param primitive Primitive to draw (eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE)
+   * \param tension Tension parameter (splines only)
+   */
+  template <typename TIterator>
+  void AppendDeltaEncodedPoints(tCanvasOpCode primitive, TIterator points_begin, TIterator points_end, double resolution, float tension);
+
+  /*!
+   * Appends line strip, polygon or spline command with the specified points.
+   * More than 65535 points are written with the respective 32 bit opcode (e.g. eDRAW_LINE_STRIP_LONG) -
+   * or split into several commands (see tCanvas::SetLegacyPointCounts()).
+   *
+   * \param opcode eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE
+   * \param tension Tension parameter (splines only)
+   */
+  template <typename TIterator>
+  void AppendPointList(tCanvasOpCode opcode, TIterator points_begin, TIterator points_end, float tension);
+
+  /*!
+   * Appends header of line strip, polygon or spline command (opcode, tension and point count)
+   * - using the 32 bit opcode if count exceeds 65535
+   */
+  inline void AppendPointListHeader(tCanvasOpCode opcode, size_t count, float tension);
+
+  /*!
+   * Culls rectangle of box or ellipsoid (see tCanvas::CullBox())
+   *
+   * \param values Bottom left x, bottom left y, width, height
+   */
+  template <typename T>
+  bool CullRectangle(const T(&values)[4]);
+
+  /*!
+   * \return Transformation matrix as 4x4 affine matrix (for transformation folding)
+   */
+  template <typename T>
+  static internal::tAffineTransformation::tMatrix ToAffineMatrix(const math::tMatrix<3, 3, T> &transformation);
+
 };
 
 //----------------------------------------------------------------------
@@ -32,12 +32,17 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
 #include "rrlib/logging/messages.h"
 #include "rrlib/util/variadic_templates.h"
 
 //----------------------------------------------------------------------
 // Internal includes with ""
 //----------------------------------------------------------------------
+#include "rrlib/canvas/internal/delta_encoding.h"
 
 //----------------------------------------------------------------------
 // Debugging
@@ -92,7 +97,7 @@ void tCanvas2D::SetDefaultViewport(T bottom_left_x, T bottom_left_y, T width, T
 {
   default_viewport_offset = Stream().GetPosition();
   T values[] = { bottom_left_x, bottom_left_y, width, height };
-  this->AppendCommand(eDEFAULT_VIEWPORT, values, 4);
+  this->AppendCommand(eDEFAULT_VIEWPORT, values);
 }
 
 template <typename T>
@@ -107,6 +112,11 @@ void tCanvas2D::SetDefaultViewport(const math::tVector<2, T> &bottom_left, T wid
 template <typename T>
 void tCanvas2D::SetTransformation(const math::tMatrix<3, 3, T> &transformation)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Set(ToAffineMatrix(transformation));
+    return;
+  }
   // FIXME: Why this order? Check with 3D version and use one matrix order for all
   T values[] =
   {
@@ -114,7 +124,7 @@ void tCanvas2D::SetTransformation(const math::tMatrix<3, 3, T> &transformation)
     transformation[0][1], transformation[1][1],
     transformation[0][2], transformation[1][2]
   };
-  this->AppendCommand(eSET_TRANSFORMATION, values, 6);
+  this->AppendCommand(eSET_TRANSFORMATION, values);
 }
 
 inline void tCanvas2D::SetTransformation(const math::tPose2D &transformation)
@@ -128,13 +138,18 @@ inline void tCanvas2D::SetTransformation(const math::tPose2D &transformation)
 template <typename T>
 void tCanvas2D::Transform(const math::tMatrix<3, 3, T> &transformation)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Multiply(ToAffineMatrix(transformation));
+    return;
+  }
   T values[] =
   {
     transformation[0][0], transformation[1][0],
     transformation[0][1], transformation[1][1],
     transformation[0][2], transformation[1][2]
   };
-  this->AppendCommand(eTRANSFORM, values, 6);
+  this->AppendCommand(eTRANSFORM, values);
 }
 
 inline void tCanvas2D::Transform(const math::tPose2D &transformation)
@@ -148,8 +163,13 @@ inline void tCanvas2D::Transform(const math::tPose2D &transformation)
 template <typename T>
 void tCanvas2D::Translate(T x, T y)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Translate(x, y, 0);
+    return;
+  }
   T values[] = { x, y };
-  this->AppendCommand(eTRANSLATE, values, 2);
+  this->AppendCommand(eTRANSLATE, values);
 }
 
 template <typename T>
@@ -164,6 +184,11 @@ void tCanvas2D::Translate(const math::tVector<2, T> &vector)
 template <typename T>
 void tCanvas2D::Rotate(T angle)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Rotate(0, 0, angle);
+    return;
+  }
   AppendCommand(eROTATE, &angle, 1);
 }
 
@@ -173,8 +198,13 @@ void tCanvas2D::Rotate(T angle)
 template <typename T>
 void tCanvas2D::Scale(T x, T y)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Scale(x, y, 1);
+    return;
+  }
   T values[] = { x, y };
-  this->AppendCommand(eSCALE, values, 2);
+  this->AppendCommand(eSCALE, values);
 }
 
 template <typename T>
@@ -183,13 +213,49 @@ void tCanvas2D::Scale(const math::tVector<2, T> &factor)
   this->Scale(factor.X(), factor.Y());
 }
 
+//----------------------------------------------------------------------
+// tCanvas2D ToAffineMatrix
+//----------------------------------------------------------------------
+template <typename T>
+internal::tAffineTransformation::tMatrix tCanvas2D::ToAffineMatrix(const math::tMatrix<3, 3, T> &transformation)
+{
+  return internal::tAffineTransformation::tMatrix
+  {
+    {
+      static_cast<double>(transformation[0][0]), static_cast<double>(transformation[0][1]), 0, static_cast<double>(transformation[0][2]),
+      static_cast<double>(transformation[1][0]), static_cast<double>(transformation[1][1]), 0, static_cast<double>(transformation[1][2]),
+      0, 0, 1, 0,
+      0, 0, 0, 1
+    }
+  };
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D CullRectangle
+//----------------------------------------------------------------------
+template <typename T>
+bool tCanvas2D::CullRectangle(const T(&values)[4])
+{
+  T corners[] = { values[0], values[1], static_cast<T>(values[0] + values[2]), static_cast<T>(values[1] + values[3]) };
+  return this->CullValues(corners, 2, 2);
+}
+
 //----------------------------------------------------------------------
 // tCanvas2D SetZ
 //----------------------------------------------------------------------
 template <typename T>
 void tCanvas2D::SetZ(T z)
 {
-  this->AppendCommand(eSET_Z, &z, 1);
+  this->AppendStateCommand(eSET_Z, eSTATE_Z, z);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D SetExtrusion
+//----------------------------------------------------------------------
+template <typename T>
+void tCanvas2D::SetExtrusion(T extrusion)
+{
+  this->AppendStateCommand(eSET_EXTRUSION, eSTATE_EXTRUSION, extrusion);
 }
 
 //----------------------------------------------------------------------
@@ -205,7 +271,11 @@ void tCanvas2D::DrawPoint(T x, T y)
   }
   this->in_path_mode = false;
   T values[] = { x, y };
-  this->AppendCommand(eDRAW_POINT, values, 2);
+  if (this->IsCulling() && this->CullValues(values, 1, 2))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_POINT, values);
 }
 
 template <typename T>
@@ -227,7 +297,7 @@ void tCanvas2D::DrawLine(T support_x, T support_y, T direction_x, T direction_y)
   }
   this->in_path_mode = false;
   T values[] = { support_x, support_y, direction_x, direction_y };
-  this->AppendCommand(eDRAW_LINE, values, 4);
+  this->AppendCommand(eDRAW_LINE, values);
 }
 
 template <typename T>
@@ -249,7 +319,11 @@ void tCanvas2D::DrawLineSegment(T p1_x, T p1_y, T p2_x, T p2_y)
   }
   this->in_path_mode = false;
   T values[] = { p1_x, p1_y, p2_x, p2_y };
-  this->AppendCommand(eDRAW_LINE_SEGMENT, values, 4);
+  if (this->IsCulling() && this->CullValues(values, 2, 2))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_LINE_SEGMENT, values);
 }
 
 template <typename T>
@@ -270,9 +344,11 @@ void tCanvas2D::DrawLineStrip(TIterator points_begin, TIterator points_end)
     return;
   }
   this->in_path_mode = false;
-  this->AppendCommandRaw(eDRAW_LINE_STRIP);
-  this->Stream().WriteShort(std::distance(points_begin, points_end));
-  this->AppendData(points_begin, points_end);
+  if (this->IsCulling() && this->template CullPoints<2>(points_begin, points_end))
+  {
+    return;
+  }
+  this->AppendPointList(eDRAW_LINE_STRIP, points_begin, points_end, 0);
 }
 
 template<typename TElement, typename ... TVectors>
@@ -292,6 +368,37 @@ void tCanvas2D::DrawLineStrip(const math::tVector<2, TElement> &p1, const math::
   this->DrawLineStrip(buffer, buffer + number_of_points);
 }
 
+template <typename T>
+void tCanvas2D::DrawLineStrip(const T* x, const T* y, size_t count)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  const T* const channels[] = { x, y };
+  if (this->IsCulling() && this->CullPoints(channels, count))
+  {
+    return;
+  }
+  if (count > std::numeric_limits<uint16_t>::max() && this->GetLegacyPointCounts())
+  {
+    // Line strips that share end points
+    const size_t cMAX_CHUNK = std::numeric_limits<uint16_t>::max();
+    for (size_t first = 0; first + 1 < count; first += cMAX_CHUNK - 1)
+    {
+      size_t chunk = std::min(count - first, cMAX_CHUNK);
+      const T* const chunk_channels[] = { x + first, y + first };
+      this->AppendPointListHeader(eDRAW_LINE_STRIP, chunk, 0);
+      this->AppendInterleavedData(chunk_channels, chunk);
+    }
+    return;
+  }
+  this->AppendPointListHeader(eDRAW_LINE_STRIP, count, 0);
+  this->AppendInterleavedData(channels, count);
+}
+
 //----------------------------------------------------------------------
 // tCanvas2D DrawArrow
 //----------------------------------------------------------------------
@@ -329,7 +436,11 @@ void tCanvas2D::DrawBox(T bottom_left_x, T bottom_left_y, T width, T height)
   }
   this->in_path_mode = false;
   T values[] = { bottom_left_x, bottom_left_y, width, height };
-  this->AppendCommand(eDRAW_BOX, values, 4);
+  if (this->IsCulling() && this->CullRectangle(values))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_BOX, values);
 }
 
 template <typename T>
@@ -355,7 +466,11 @@ void tCanvas2D::DrawEllipsoid(T center_x, T center_y, T width, T height)
     height = width;
   }
   T values[] = { center_x - width / 2, center_y - height / 2, width, height };
-  this->AppendCommand(eDRAW_ELLIPSOID, values, 4);
+  if (this->IsCulling() && this->CullRectangle(values))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_ELLIPSOID, values);
 }
 
 template <typename T>
@@ -377,6 +492,11 @@ void tCanvas2D::DrawBezierCurve(TIterator points_begin, TIterator points_end)
   }
   this->in_path_mode = false;
   assert(std::distance(points_begin, points_end) > 1);
+  if (this->IsCulling() && this->template CullPoints<2>(points_begin, points_end))
+  {
+    // Curve is inside convex hull of its control points
+    return;
+  }
   this->AppendCommandRaw(eDRAW_BEZIER_CURVE);
   this->Stream().WriteShort(std::distance(points_begin, points_end) - 1);
   this->AppendData(points_begin, points_end);
@@ -411,9 +531,11 @@ void tCanvas2D::DrawPolygon(TIterator points_begin, TIterator points_end)
     return;
   }
   this->in_path_mode = false;
-  this->AppendCommandRaw(eDRAW_POLYGON);
-  this->Stream().WriteShort(std::distance(points_begin, points_end));
-  this->AppendData(points_begin, points_end);
+  if (this->IsCulling() && this->template CullPoints<2>(points_begin, points_end))
+  {
+    return;
+  }
+  this->AppendPointList(eDRAW_POLYGON, points_begin, points_end, 0);
 }
 
 template <typename TElement, typename ... TVectors>
@@ -445,10 +567,185 @@ void tCanvas2D::DrawSpline(TIterator points_begin, TIterator points_end, float t
     return;
   }
   this->in_path_mode = false;
-  this->AppendCommandRaw(eDRAW_SPLINE);
-  this->Stream().WriteFloat(tension);
-  this->Stream().WriteShort(std::distance(points_begin, points_end));
-  this->AppendData(points_begin, points_end);
+  this->AppendPointList(eDRAW_SPLINE, points_begin, points_end, tension);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D DrawDeltaEncodedLineStrip
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tCanvas2D::DrawDeltaEncodedLineStrip(TIterator points_begin, TIterator points_end, double resolution)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling() && this->template CullPoints<2>(points_begin, points_end))
+  {
+    return;
+  }
+  this->AppendDeltaEncodedPoints(eDRAW_LINE_STRIP, points_begin, points_end, resolution, 0);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D DrawDeltaEncodedPolygon
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tCanvas2D::DrawDeltaEncodedPolygon(TIterator points_begin, TIterator points_end, double resolution)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling() && this->template CullPoints<2>(points_begin, points_end))
+  {
+    return;
+  }
+  this->AppendDeltaEncodedPoints(eDRAW_POLYGON, points_begin, points_end, resolution, 0);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D DrawDeltaEncodedSpline
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tCanvas2D::DrawDeltaEncodedSpline(TIterator points_begin, TIterator points_end, double resolution, float tension)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  this->AppendDeltaEncodedPoints(eDRAW_SPLINE, points_begin, points_end, resolution, tension);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D AppendDeltaEncodedPoints
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tCanvas2D::AppendDeltaEncodedPoints(tCanvasOpCode primitive, TIterator points_begin, TIterator points_end, double resolution, float tension)
+{
+  assert(resolution > 0);
+  size_t count = std::distance(points_begin, points_end);
+  assert(count <= std::numeric_limits<uint32_t>::max());
+  this->AppendCommandRaw(eDRAW_DELTA_ENCODED_POINTS);
+  this->Stream() << static_cast<uint8_t>(primitive);
+  this->Stream().WriteInt(count);
+  if (primitive == eDRAW_SPLINE)
+  {
+    this->Stream().WriteFloat(tension);
+  }
+  double parameters[] = { 0, 0, resolution };
+  if (count)
+  {
+    parameters[0] = static_cast<double>((*points_begin)[0]);
+    parameters[1] = static_cast<double>((*points_begin)[1]);
+  }
+  this->AppendData(parameters, parameters + 3);
+  if (count < 2)
+  {
+    return;
+  }
+
+  // Deltas of quantized coordinates (relative to first point - so that errors do not accumulate)
+  const double scale = 1.0 / resolution;
+  const size_t cCHUNK_POINTS = 512;
+  uint8_t chunk[cCHUNK_POINTS * 2 * internal::cMAX_VARINT_BYTES];
+  size_t chunk_bytes = 0;
+  size_t chunk_points = 0;
+  const double origin_x = parameters[0], origin_y = parameters[1];
+  int64_t previous_x = 0, previous_y = 0;  // locals - so that byte stores to chunk do not force reloads
+  TIterator it = points_begin;
+  for (++it; it != points_end; ++it)
+  {
+    int64_t quantized_x = internal::Quantize((static_cast<double>((*it)[0]) - origin_x) * scale);
+    int64_t quantized_y = internal::Quantize((static_cast<double>((*it)[1]) - origin_y) * scale);
+    chunk_bytes += internal::WriteVarint(internal::ZigZagEncode(quantized_x - previous_x), chunk + chunk_bytes);
+    chunk_bytes += internal::WriteVarint(internal::ZigZagEncode(quantized_y - previous_y), chunk + chunk_bytes);
+    previous_x = quantized_x;
+    previous_y = quantized_y;
+    chunk_points++;
+    if (chunk_points == cCHUNK_POINTS)
+    {
+      this->Stream().Write(chunk, chunk_bytes);
+      chunk_bytes = 0;
+      chunk_points = 0;
+    }
+  }
+  this->Stream().Write(chunk, chunk_bytes);
+}
+
+//----------------------------------------------------------------------
+// tCanvas2D AppendPointList
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tCanvas2D::AppendPointList(tCanvasOpCode opcode, TIterator points_begin, TIterator points_end, float tension)
+{
+  const size_t cMAX_CHUNK = std::numeric_limits<uint16_t>::max();
+  size_t count = std::distance(points_begin, points_end);
+  assert(count <= std::numeric_limits<uint32_t>::max());
+  if (count <= cMAX_CHUNK || !this->GetLegacyPointCounts())
+  {
+    this->AppendPointListHeader(opcode, count, tension);
+    this->AppendData(points_begin, points_end);
+    return;
+  }
+
+  if (opcode == eDRAW_POLYGON)
+  {
+    // Shape with the same outline (and fill)
+    TIterator it = points_begin;
+    this->StartShape(*it);
+    for (++it; it != points_end; ++it)
+    {
+      this->AppendLineSegment(*it);
+    }
+    this->CloseShape();
+    return;
+  }
+
+  // Line strips or splines that share end points
+  TIterator chunk_begin = points_begin;
+  for (size_t first = 0; first + 1 < count; first += cMAX_CHUNK - 1)
+  {
+    size_t chunk = std::min(count - first, cMAX_CHUNK);
+    TIterator chunk_end = chunk_begin;
+    std::advance(chunk_end, chunk);
+    this->AppendPointListHeader(opcode, chunk, tension);
+    this->AppendData(chunk_begin, chunk_end);
+    std::advance(chunk_begin, chunk - 1);
+  }
+}
+
+void tCanvas2D::AppendPointListHeader(tCanvasOpCode opcode, size_t count, float tension)
+{
+  bool long_count = count > std::numeric_limits<uint16_t>::max();
+  switch (opcode)
+  {
+  case eDRAW_LINE_STRIP:
+    this->AppendCommandRaw(long_count ? eDRAW_LINE_STRIP_LONG : eDRAW_LINE_STRIP);
+    break;
+  case eDRAW_POLYGON:
+    this->AppendCommandRaw(long_count ? eDRAW_POLYGON_LONG : eDRAW_POLYGON);
+    break;
+  default:
+    assert(opcode == eDRAW_SPLINE);
+    this->AppendCommandRaw(long_count ? eDRAW_SPLINE_LONG : eDRAW_SPLINE);
+    this->Stream().WriteFloat(tension);
+    break;
+  }
+  if (long_count)
+  {
+    this->Stream().WriteInt(count);
+  }
+  else
+  {
+    this->Stream().WriteShort(count);
+  }
 }
 
 //----------------------------------------------------------------------
@@ -463,7 +760,7 @@ void tCanvas2D::StartPath(T x, T y)
     return;
   }
   T values[] = { x, y };
-  this->AppendCommand(ePATH_START, values, 2);
+  this->AppendCommand(ePATH_START, values);
   this->Stream().WriteBoolean(false);
   this->entering_path_mode = true;
   this->in_path_mode = true;
@@ -487,7 +784,7 @@ void tCanvas2D::StartShape(T x, T y)
     return;
   }
   T values[] = { x, y };
-  this->AppendCommand(ePATH_START, values, 2);
+  this->AppendCommand(ePATH_START, values);
   this->Stream().WriteBoolean(true);
   this->entering_path_mode = true;
   this->in_path_mode = true;
@@ -512,7 +809,7 @@ void tCanvas2D::AppendLineSegment(T x, T y)
   }
   this->entering_path_mode = false;
   T values[] = { x, y };
-  this->AppendCommand(ePATH_LINE, values, 2);
+  this->AppendCommand(ePATH_LINE, values);
 }
 
 template <typename T>
@@ -534,7 +831,7 @@ void tCanvas2D::AppendQuadraticBezierCurve(T p1_x, T p1_y, T p2_x, T p2_y)
   }
   this->entering_path_mode = false;
   T values[] = { p1_x, p1_y, p2_x, p2_y };
-  this->AppendCommand(ePATH_QUADRATIC_BEZIER_CURVE, values, 4);
+  this->AppendCommand(ePATH_QUADRATIC_BEZIER_CURVE, values);
 }
 
 template <typename T>
@@ -556,7 +853,7 @@ void tCanvas2D::AppendCubicBezierCurve(T p1_x, T p1_y, T p2_x, T p2_y, T p3_x, T
   }
   this->entering_path_mode = false;
   T values[] = { p1_x, p1_y, p2_x, p2_y, p3_x, p3_y };
-  this->AppendCommand(ePATH_CUBIC_BEZIER_CURVE, values, 6);
+  this->AppendCommand(ePATH_CUBIC_BEZIER_CURVE, values);
 }
 
 template <typename T>
@@ -37,6 +37,8 @@
 #define __rrlib__canvas__tCanvas3D_h__
 
 #include "rrlib/canvas/tCanvas.h"
+#include "rrlib/canvas/tPointCloudLODBuilder.h"
+#include "rrlib/canvas/tVoxelGridFilter.h"
 
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
@@ -111,6 +113,45 @@ public:
     tCanvas::AppendCanvas(canvas);
   }
 
+  /*!
+   * Enables culling: points, line segments, line strips, boxes, ellipsoids, polygons and bezier curves
+   * that are completely outside the specified frustum (after transformation) are not written to the canvas.
+   * From point clouds (DrawPointCloud(), DrawColoredPointCloud(), DrawQuantizedPointCloud(), DrawRGBPointCloud()
+   * and DrawPointCloudLOD()), points outside the frustum are removed. LOD point clouds keep their levels
+   * (only the visible points of each level are written - so more levels may fit into the byte budget).
+   *
+   * Culling tracks the current transformation - so it enables transformation folding.
+   * Paths, lines, arrows and text are not culled.
+   *
+   * \param frustum Visible volume (in coordinates of canvas without transformation)
+   */
+  void SetCullingFrustum(const tViewFrustum& frustum)
+  {
+    this->SetCulling(frustum, 3);
+  }
+
+  /*!
+   * Enables or disables transformation folding
+   *
+   * With transformation folding, SetTransformation(), Transform(), Translate(), Rotate(), Scale() and
+   * ResetTransformation() do not write commands. Instead, the current transformation is accumulated
+   * client-side (in double precision) and written as a single eSET_TRANSFORMATION command when
+   * the next primitive is drawn after a change. PushTransformation() and PopTransformation()
+   * may be used to save and restore the current transformation.
+   *
+   * The folded transformation starts with the identity matrix - so folding should be enabled
+   * before any transformation commands are written (folding is kept when the canvas is cleared).
+   * Transformation matrices are expected to be affine (last row is ignored).
+   * Disabling transformation folding also disables culling.
+   * Rotate() angles are interpreted as roll, pitch and yaw (as in math::tPose3D).
+   *
+   * \param enable Whether to enable transformation folding
+   */
+  void SetTransformationFolding(bool enable)
+  {
+    tCanvas::SetTransformationFolding(enable ? 3 : 0);
+  }
+
   /*!
    * Set affine transformation of all following operations
    * Overwrites current transform completely.
@@ -197,6 +238,17 @@ public:
   template <typename TElement, typename ... TVectors>
   void DrawLineStrip(const math::tVector<3, TElement> &p1, const math::tVector<3, TElement> &p2, const TVectors &... rest);
 
+  /*!
+   * Draw Line Strip from separate coordinate arrays
+   *
+   * \param x Array with x coordinates of points
+   * \param y Array with y coordinates of points
+   * \param z Array with z coordinates of points
+   * \param count Number of points
+   */
+  template <typename T>
+  void DrawLineStrip(const T* x, const T* y, const T* z, size_t count);
+
   /*!
    * Draw arrow
    */
@@ -269,6 +321,65 @@ public:
   template <typename TElement, typename ... TVectors>
   void DrawPointCloud(const math::tVector<3, TElement> &p1, const math::tVector<3, TElement> &p2, const TVectors &... rest);
 
+  /*!
+   * Draw Point Cloud from separate coordinate arrays
+   * (points are interleaved directly into the canvas buffer - no temporary copy is created)
+   *
+   * \param x Array with x coordinates of points
+   * \param y Array with y coordinates of points
+   * \param z Array with z coordinates of points
+   * \param count Number of points
+   */
+  template <typename T>
+  void DrawPointCloud(const T* x, const T* y, const T* z, size_t count);
+
+  /*!
+   * Draw Point Cloud downsampled by a voxel grid filter
+   * (one representative point per occupied voxel is drawn)
+   *
+   * \param points_begin Iterator to first point (math::tVector<3, TElement>)
+   * \param points_end Iterator past last point
+   * \param filter Voxel grid filter to use (should be reused in subsequent calls - as it keeps its buffers)
+   */
+  template <typename TIterator>
+  void DrawPointCloud(TIterator points_begin, TIterator points_end, tVoxelGridFilter &filter);
+
+  /*!
+   * Draw Point Cloud as octree levels of detail (coarse levels first)
+   *
+   * Readers may stop after any level and still obtain a uniformly thinned point cloud
+   * (see tCanvasCommand::GetLODLevels()).
+   * If a byte budget is specified, finer levels that do not fit are omitted (level 0 is always written).
+   *
+   * \param points_begin Random access iterator to first point (math::tVector<3, TElement>)
+   * \param points_end Random access iterator past last point
+   * \param builder Builder on which Build() was called with these points
+   *                (a static point cloud only needs to be built once - and can then be drawn with varying budgets)
+   * \param max_bytes Maximum size of command in bytes (0 means no limit)
+   * \return Number of levels that were written (0 if builder was built with a different number of points - or if all points were culled)
+   */
+  template <typename TIterator>
+  size_t DrawPointCloudLOD(TIterator points_begin, TIterator points_end, const tPointCloudLODBuilder& builder, size_t max_bytes = 0);
+
+  /*!
+   * Draw Point Cloud with quantized coordinates
+   *
+   * Coordinates are encoded as 16 bit unsigned integers relative to the point cloud's bounding box.
+   * This reduces size to 6 bytes per point (instead of 12 for float and 24 for double coordinates).
+   * Points with non-finite coordinates are skipped.
+   *
+   * Each decoded coordinate differs from the original coordinate by at most half of the returned quantization step.
+   * The returned step equals the specified resolution - unless the point cloud's extent (along any axis)
+   * exceeds 65535 * resolution. Then step is extent / 65535.
+   *
+   * \param points_begin Iterator to first point (iterators must allow multiple passes)
+   * \param points_end Iterator past last point
+   * \param resolution Desired quantization step
+   * \return Quantization step that was actually used
+   */
+  template <typename TIterator>
+  double DrawQuantizedPointCloud(TIterator points_begin, TIterator points_end, double resolution);
+
   /*!
    * Draw Colored Point Cloud
    */
@@ -278,6 +389,49 @@ public:
   template <typename TElement, typename ... TVectors>
   void DrawColoredPointCloud(const math::tVector<6, TElement> &p1, const math::tVector<6, TElement> &p2, const TVectors &... rest);
 
+  /*!
+   * Draw Colored Point Cloud from separate coordinate and color arrays
+   * (points are interleaved directly into the canvas buffer - no temporary copy is created)
+   *
+   * \param x Array with x coordinates of points
+   * \param y Array with y coordinates of points
+   * \param z Array with z coordinates of points
+   * \param r Array with red components of point colors
+   * \param g Array with green components of point colors
+   * \param b Array with blue components of point colors
+   * \param count Number of points
+   */
+  template <typename T>
+  void DrawColoredPointCloud(const T* x, const T* y, const T* z, const T* r, const T* g, const T* b, size_t count);
+
+
+  /*!
+   * Draw Colored Point Cloud with colors packed as bytes
+   *
+   * Positions are encoded with their element type - colors as RGB bytes.
+   * (15 bytes per point for float coordinates - instead of 24 with DrawColoredPointCloud)
+   *
+   * \param points_begin Iterator to first point (iterators must allow multiple passes)
+   * \param points_end Iterator past last point
+   *
+   * Points are math::tVector<6, TElement> as with DrawColoredPointCloud.
+   * Color components are expected to be in the range 0 to 255 (values outside are clamped).
+   */
+  template <typename TIterator>
+  void DrawRGBPointCloud(TIterator points_begin, TIterator points_end);
+
+  /*!
+   * Draw Colored Point Cloud with separate position and color ranges
+   *
+   * \param points_begin Iterator to first position (math::tVector<3, TElement>)
+   * \param points_end Iterator past last position
+   * \param colors_begin Iterator to color of first point. Colors can be
+   *                     math::tVector<3, uint8_t> (RGB),
+   *                     math::tVector<4, uint8_t> (RGBA) or
+   *                     uint32_t (RGBA - as with SetColor(uint32_t rgba))
+   */
+  template <typename TIterator, typename TColorIterator>
+  void DrawRGBPointCloud(TIterator points_begin, TIterator points_end, TColorIterator colors_begin);
 
   /*!
    * Start a path (of lines and curves)
@@ -343,6 +497,34 @@ public:
   //----------------------------------------------------------------------
 private:
 
+  /*!
+   * \return Transformation matrix as 4x4 affine matrix (for transformation folding)
+   */
+  template <typename T>
+  static internal::tAffineTransformation::tMatrix ToAffineMatrix(const math::tMatrix<4, 4, T> &transformation);
+
+  /*!
+   * Writes chunk of quantized coordinates to stream (little endian)
+   */
+  inline void AppendQuantizedChunk(const uint16_t* values, size_t value_count);
+
+  /*!
+   * Helpers to write colors of DrawRGBPointCloud
+   */
+  template <typename TColor>
+  struct tColorEncoding;
+
+  template <typename TColorIterator>
+  void AppendColors(TColorIterator colors_begin, size_t count);
+
+  /*!
+   * Writes eDRAW_RGB_POINT_CLOUD command with all specified points (DrawRGBPointCloud() without culling)
+   */
+  template <typename TIterator>
+  void AppendRGBPointCloud(TIterator points_begin, TIterator points_end);
+
+  template <typename TIterator, typename TColorIterator>
+  void AppendRGBPointCloud(TIterator points_begin, TIterator points_end, TColorIterator colors_begin);
 
 };
 
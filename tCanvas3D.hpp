@@ -34,6 +34,9 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <cmath>
+#include <cstring>
+
 #include "rrlib/math/tMatrix.h"
 #include "rrlib/math/tPose2D.h"
 
@@ -93,6 +96,11 @@ tCanvas3D& tCanvas3D::operator=(tCanvas3D && o)
 template<typename T>
 void tCanvas3D::SetTransformation(const math::tMatrix<4, 4, T> &transformation)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Set(ToAffineMatrix(transformation));
+    return;
+  }
   T values[] =
   {
     transformation[0][0], transformation[0][1], transformation[0][2], transformation[0][3],
@@ -100,7 +108,7 @@ void tCanvas3D::SetTransformation(const math::tMatrix<4, 4, T> &transformation)
     transformation[2][0], transformation[2][1], transformation[2][2], transformation[2][3],
     transformation[3][0], transformation[3][1], transformation[3][2], transformation[3][3]
   };
-  this->AppendCommand(eSET_TRANSFORMATION, values, 16);
+  this->AppendCommand(eSET_TRANSFORMATION, values);
 }
 
 inline void tCanvas3D::SetTransformation(const math::tPose3D &transformation)
@@ -114,6 +122,11 @@ inline void tCanvas3D::SetTransformation(const math::tPose3D &transformation)
 template<typename T>
 void tCanvas3D::Transform(const math::tMatrix<4, 4, T> &transformation)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Multiply(ToAffineMatrix(transformation));
+    return;
+  }
   T values[] =
   {
     transformation[0][0], transformation[0][1], transformation[0][2], transformation[0][3],
@@ -121,7 +134,7 @@ void tCanvas3D::Transform(const math::tMatrix<4, 4, T> &transformation)
     transformation[2][0], transformation[2][1], transformation[2][2], transformation[2][3],
     transformation[3][0], transformation[3][1], transformation[3][2], transformation[3][3]
   };
-  this->AppendCommand(eTRANSFORM, values, 16);
+  this->AppendCommand(eTRANSFORM, values);
 }
 
 inline void tCanvas3D::Transform(const math::tPose3D &transformation)
@@ -135,8 +148,13 @@ inline void tCanvas3D::Transform(const math::tPose3D &transformation)
 template<typename T>
 void tCanvas3D::Translate(T x, T y, T z)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Translate(x, y, z);
+    return;
+  }
   T values[] = { x, y, z };
-  this->AppendCommand(eTRANSLATE, values, 3);
+  this->AppendCommand(eTRANSLATE, values);
 }
 
 template<typename T>
@@ -151,8 +169,13 @@ void tCanvas3D::Translate(const math::tVector<3, T> &vector)
 template<typename T>
 void tCanvas3D::Rotate(T x, T y, T z)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Rotate(x, y, z);
+    return;
+  }
   T values[] = { x, y, z };
-  this->AppendCommand(eROTATE, values, 3);
+  this->AppendCommand(eROTATE, values);
 }
 
 //----------------------------------------------------------------------
@@ -161,8 +184,13 @@ void tCanvas3D::Rotate(T x, T y, T z)
 template<typename T>
 void tCanvas3D::Scale(T x, T y, T z)
 {
+  if (this->IsTransformationFolding())
+  {
+    this->FoldTransformation().Scale(x, y, z);
+    return;
+  }
   T values[] = { x, y, z };
-  this->AppendCommand(eSCALE, values, 3);
+  this->AppendCommand(eSCALE, values);
 }
 
 template<typename T>
@@ -171,13 +199,32 @@ void tCanvas3D::Scale(const math::tVector<3, T> &vector)
   this->Scale(vector.X(), vector.Y(), vector.Z());
 }
 
+//----------------------------------------------------------------------
+// tCanvas3D ToAffineMatrix
+//----------------------------------------------------------------------
+template<typename T>
+internal::tAffineTransformation::tMatrix tCanvas3D::ToAffineMatrix(const math::tMatrix<4, 4, T> &transformation)
+{
+  internal::tAffineTransformation::tMatrix result;
+  for (size_t row = 0; row < 3; row++)
+  {
+    for (size_t column = 0; column < 4; column++)
+    {
+      result[row * 4 + column] = static_cast<double>(transformation[row][column]);
+    }
+  }
+  result[12] = result[13] = result[14] = 0;
+  result[15] = 1;
+  return result;
+}
+
 //----------------------------------------------------------------------
 // tCanvas3D SetZ
 //----------------------------------------------------------------------
 template<typename T>
 void tCanvas3D::SetZ(T z)
 {
-  this->AppendCommand(eSET_Z, &z, 1);
+  this->AppendStateCommand(eSET_Z, eSTATE_Z, z);
 }
 
 //----------------------------------------------------------------------
@@ -193,7 +240,11 @@ void tCanvas3D::DrawPoint(T x, T y, T z)
   }
   this->in_path_mode = false;
   T values[] = { x, y, z };
-  this->AppendCommand(eDRAW_POINT, values, 3);
+  if (this->IsCulling() && this->CullValues(values, 1, 3))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_POINT, values);
 }
 
 template<typename T>
@@ -215,7 +266,7 @@ void tCanvas3D::DrawLine(T support_x, T support_y, T support_z, T direction_x, T
   }
   this->in_path_mode = false;
   T values[] = { support_x, support_y, support_z, direction_x, direction_y, direction_z };
-  this->AppendCommand(eDRAW_LINE, values, 6);
+  this->AppendCommand(eDRAW_LINE, values);
 }
 
 template<typename T>
@@ -237,7 +288,11 @@ void tCanvas3D::DrawLineSegment(T p1_x, T p1_y, T p1_z, T p2_x, T p2_y, T p2_z)
   }
   this->in_path_mode = false;
   T values[] = { p1_x, p1_y, p1_z, p2_x, p2_y, p2_z };
-  this->AppendCommand(eDRAW_LINE_SEGMENT, values, 6);
+  if (this->IsCulling() && this->CullValues(values, 2, 3))
+  {
+    return;
+  }
+  this->AppendCommand(eDRAW_LINE_SEGMENT, values);
 }
 
 template<typename T>
@@ -258,6 +313,10 @@ void tCanvas3D::DrawLineStrip(TIterator points_begin, TIterator points_end)
     return;
   }
   this->in_path_mode = false;
+  if (this->IsCulling() && this->template CullPoints<3>(points_begin, points_end))
+  {
+    return;
+  }
   this->AppendCommandRaw(eDRAW_LINE_STRIP);
   this->Stream().WriteInt(std::distance(points_begin, points_end));
   this->AppendData(points_begin, points_end);
@@ -280,6 +339,25 @@ void tCanvas3D::DrawLineStrip(const math::tVector<3, TElement> &p1, const math::
   this->DrawLineStrip(buffer, buffer + number_of_points);
 }
 
+template<typename T>
+void tCanvas3D::DrawLineStrip(const T* x, const T* y, const T* z, size_t count)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  const T* const channels[] = { x, y, z };
+  if (this->IsCulling() && this->CullPoints(channels, count))
+  {
+    return;
+  }
+  this->AppendCommandRaw(eDRAW_LINE_STRIP);
+  this->Stream().WriteInt(count);
+  this->AppendInterleavedData(channels, count);
+}
+
 //----------------------------------------------------------------------
 // tCanvas3D DrawArrow
 //----------------------------------------------------------------------
@@ -317,7 +395,15 @@ void tCanvas3D::DrawBox(T bottom_left_x, T bottom_left_y, T bottom_left_z, T wid
   }
   this->in_path_mode = false;
   T values[] = { bottom_left_x, bottom_left_y, bottom_left_z, width, height, depth };
-  this->AppendCommand(eDRAW_BOX, values, 6);
+  if (this->IsCulling())
+  {
+    T corners[] = { bottom_left_x, bottom_left_y, bottom_left_z, static_cast<T>(bottom_left_x + width), static_cast<T>(bottom_left_y + height), static_cast<T>(bottom_left_z + depth) };
+    if (this->CullValues(corners, 2, 3))
+    {
+      return;
+    }
+  }
+  this->AppendCommand(eDRAW_BOX, values);
 }
 
 template<typename T>
@@ -339,7 +425,19 @@ void tCanvas3D::DrawEllipsoid(T center_x, T center_y, T center_z, T width, T hei
   }
   this->in_path_mode = false;
   T values[] = { center_x, center_y, center_z, width, height, depth };
-  this->AppendCommand(eDRAW_ELLIPSOID, values, 6);
+  if (this->IsCulling())
+  {
+    T corners[] =
+    {
+      static_cast<T>(center_x - width / 2), static_cast<T>(center_y - height / 2), static_cast<T>(center_z - depth / 2),
+      static_cast<T>(center_x + width / 2), static_cast<T>(center_y + height / 2), static_cast<T>(center_z + depth / 2)
+    };
+    if (this->CullValues(corners, 2, 3))
+    {
+      return;
+    }
+  }
+  this->AppendCommand(eDRAW_ELLIPSOID, values);
 }
 
 template<typename T>
@@ -361,6 +459,11 @@ void tCanvas3D::DrawBezierCurve(TIterator points_begin, TIterator points_end)
   }
   this->in_path_mode = false;
   assert(std::distance(points_begin, points_end) > 1);
+  if (this->IsCulling() && this->template CullPoints<3>(points_begin, points_end))
+  {
+    // Curve is inside convex hull of its control points
+    return;
+  }
   this->AppendCommandRaw(eDRAW_BEZIER_CURVE);
   this->Stream().WriteShort(std::distance(points_begin, points_end) - 1);
   this->AppendData(points_begin, points_end);
@@ -395,6 +498,10 @@ void tCanvas3D::DrawPolygon(TIterator points_begin, TIterator points_end)
     return;
   }
   this->in_path_mode = false;
+  if (this->IsCulling() && this->template CullPoints<3>(points_begin, points_end))
+  {
+    return;
+  }
   this->AppendCommandRaw(eDRAW_POLYGON);
   this->Stream().WriteShort(std::distance(points_begin, points_end));
   this->AppendData(points_begin, points_end);
@@ -475,6 +582,18 @@ void tCanvas3D::DrawPointCloud(TIterator points_begin, TIterator points_end)
     return;
   }
   this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    std::vector<typename std::iterator_traits<TIterator>::value_type> visible_points;
+    this->GetVisiblePoints(points_begin, points_end, visible_points);
+    if (visible_points.size())
+    {
+      this->AppendCommandRaw(eDRAW_POINT_CLOUD);
+      this->Stream().WriteInt(visible_points.size());
+      this->AppendData(visible_points.begin(), visible_points.end());
+    }
+    return;
+  }
   this->AppendCommandRaw(eDRAW_POINT_CLOUD);
   this->Stream().WriteInt(std::distance(points_begin, points_end));
   this->AppendData(points_begin, points_end);
@@ -497,8 +616,260 @@ void tCanvas3D::DrawPointCloud(const math::tVector<3, TElement> &p1, const math:
   this->DrawPointCloud(buffer, buffer + number_of_points);
 }
 
+template<typename T>
+void tCanvas3D::DrawPointCloud(const T* x, const T* y, const T* z, size_t count)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    std::vector<math::tVector<3, T>> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      points.push_back(math::tVector<3, T>(x[i], y[i], z[i]));
+    }
+    this->DrawPointCloud(points.begin(), points.end());
+    return;
+  }
+  this->AppendCommandRaw(eDRAW_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  const T* const channels[] = { x, y, z };
+  this->AppendInterleavedData(channels, count);
+}
+
+template<typename TIterator>
+void tCanvas3D::DrawPointCloud(TIterator points_begin, TIterator points_end, tVoxelGridFilter &filter)
+{
+  typedef typename std::iterator_traits<TIterator>::value_type::tElement tElement;
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  filter.Filter(points_begin, points_end);
+  size_t count = filter.GetVoxelCount();
+  if (this->IsCulling())
+  {
+    std::vector<math::tVector<3, tElement>> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      points.push_back(filter.GetPoint<tElement>(i));
+    }
+    this->DrawPointCloud(points.begin(), points.end());
+    return;
+  }
+  this->AppendCommandRaw(eDRAW_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  this->Stream() << static_cast<uint8_t>(tNumberType<tElement>::value);
+  const size_t cCHUNK_SIZE = 512;
+  math::tVector<3, tElement> chunk[cCHUNK_SIZE];
+  for (size_t offset = 0; offset < count; offset += cCHUNK_SIZE)
+  {
+    size_t chunk_count = std::min(cCHUNK_SIZE, count - offset);
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+      chunk[i] = filter.GetPoint<tElement>(offset + i);
+    }
+    this->AppendLittleEndian(&chunk[0][0], chunk_count * 3);
+  }
+}
+
 //----------------------------------------------------------------------
-// tCanvas3D DrawPointCloud
+// tCanvas3D DrawPointCloudLOD
+//----------------------------------------------------------------------
+template<typename TIterator>
+size_t tCanvas3D::DrawPointCloudLOD(TIterator points_begin, TIterator points_end, const tPointCloudLODBuilder& builder, size_t max_bytes)
+{
+  typedef typename std::iterator_traits<TIterator>::value_type tVector;
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return 0;
+  }
+  if (builder.GetPointCount() != static_cast<size_t>(points_end - points_begin))
+  {
+    RRLIB_LOG_PRINT(ERROR, "Builder was not built with these points (", builder.GetPointCount(), " instead of ", points_end - points_begin, " points). Command has no effect.");
+    return 0;
+  }
+  const std::vector<uint32_t>* order = &builder.GetOrder();
+  this->in_path_mode = false;
+
+  // With culling, points outside the frustum are removed from each level (levels keep their order)
+  std::vector<size_t> level_sizes(builder.GetLevelCount());
+  std::vector<uint32_t> visible_order;
+  for (size_t i = 0; i < level_sizes.size(); i++)
+  {
+    level_sizes[i] = builder.GetLevelSize(i);
+  }
+  if (this->IsCulling())
+  {
+    const tViewFrustum& frustum = this->GetLocalCullingFrustum();
+    visible_order.reserve(order->size());
+    size_t level_begin = 0;
+    for (size_t i = 0; i < level_sizes.size(); i++)
+    {
+      size_t level_end = level_begin + level_sizes[i];
+      size_t visible_begin = visible_order.size();
+      for (size_t j = level_begin; j < level_end; j++)
+      {
+        const tVector& point = *(points_begin + (*order)[j]);
+        if (frustum.Contains(static_cast<double>(point[0]), static_cast<double>(point[1]), static_cast<double>(point[2])))
+        {
+          visible_order.push_back((*order)[j]);
+        }
+      }
+      level_sizes[i] = visible_order.size() - visible_begin;
+      level_begin = level_end;
+    }
+    order = &visible_order;
+  }
+
+  // Number of levels that fit into budget
+  size_t level_count = 0;
+  size_t point_count = 0;
+  size_t bytes = 1 + 4 + 1;
+  for (; level_count < level_sizes.size(); level_count++)
+  {
+    size_t level_bytes = 4 + level_sizes[level_count] * sizeof(tVector);
+    if (max_bytes && level_count > 0 && bytes + level_bytes > max_bytes)
+    {
+      break;
+    }
+    bytes += level_bytes;
+    point_count += level_sizes[level_count];
+  }
+  if (this->IsCulling())
+  {
+    size_t written_points = 0;
+    for (size_t i = 0; i < level_count; i++)
+    {
+      written_points += builder.GetLevelSize(i);
+    }
+    this->AddCulledPoints(written_points - point_count);
+    if (point_count == 0)
+    {
+      return 0;
+    }
+  }
+
+  this->AppendCommandRaw(eDRAW_POINT_CLOUD_LOD);
+  this->Stream().WriteInt(level_count);
+  for (size_t i = 0; i < level_count; i++)
+  {
+    this->Stream().WriteInt(level_sizes[i]);
+  }
+  this->Stream() << static_cast<uint8_t>(tNumberType<typename tVector::tElement>::value);
+  const size_t cCHUNK_SIZE = 512;
+  tVector chunk[cCHUNK_SIZE];
+  for (size_t offset = 0; offset < point_count; offset += cCHUNK_SIZE)
+  {
+    size_t chunk_count = std::min(cCHUNK_SIZE, point_count - offset);
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+      chunk[i] = *(points_begin + (*order)[offset + i]);
+    }
+    this->AppendLittleEndian(reinterpret_cast<const typename tVector::tElement*>(chunk), chunk_count * (sizeof(tVector) / sizeof(typename tVector::tElement)));
+  }
+  return level_count;
+}
+
+//----------------------------------------------------------------------
+// tCanvas3D DrawQuantizedPointCloud
+//----------------------------------------------------------------------
+template<typename TIterator>
+double tCanvas3D::DrawQuantizedPointCloud(TIterator points_begin, TIterator points_end, double resolution)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return resolution;
+  }
+  assert(resolution > 0);
+  this->in_path_mode = false;
+
+  // Points outside culling frustum are treated like invalid points
+  const tViewFrustum* frustum = this->IsCulling() ? &this->GetLocalCullingFrustum() : NULL;
+
+  // Bounding box
+  double min[3] = { 0, 0, 0 };
+  double max[3] = { 0, 0, 0 };
+  size_t count = 0;
+  for (TIterator it = points_begin; it != points_end; ++it)
+  {
+    double point[3] = { static_cast<double>((*it)[0]), static_cast<double>((*it)[1]), static_cast<double>((*it)[2]) };
+    if (!(std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])))
+    {
+      continue;
+    }
+    if (frustum && (!frustum->Contains(point[0], point[1], point[2])))
+    {
+      this->AddCulledPoints(1);
+      continue;
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+      min[i] = (count == 0 || point[i] < min[i]) ? point[i] : min[i];
+      max[i] = (count == 0 || point[i] > max[i]) ? point[i] : max[i];
+    }
+    count++;
+  }
+  double step = resolution;
+  for (size_t i = 0; i < 3; i++)
+  {
+    step = std::max(step, (max[i] - min[i]) / 65535.0);
+  }
+
+  this->AppendCommandRaw(eDRAW_QUANTIZED_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  double parameters[] = { min[0], min[1], min[2], step };
+  this->AppendData(parameters, parameters + 4);
+
+  // Quantized coordinates
+  this->Stream() << static_cast<uint8_t>(eUINT16);
+  const size_t cCHUNK_SIZE = 512;
+  uint16_t chunk[cCHUNK_SIZE * 3];
+  size_t chunk_count = 0;
+  for (TIterator it = points_begin; it != points_end; ++it)
+  {
+    double point[3] = { static_cast<double>((*it)[0]), static_cast<double>((*it)[1]), static_cast<double>((*it)[2]) };
+    if (!(std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])))
+    {
+      continue;
+    }
+    if (frustum && (!frustum->Contains(point[0], point[1], point[2])))
+    {
+      continue;
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+      double quantized = std::round((point[i] - min[i]) / step);
+      chunk[chunk_count * 3 + i] = static_cast<uint16_t>(std::min(quantized, 65535.0));
+    }
+    chunk_count++;
+    if (chunk_count == cCHUNK_SIZE)
+    {
+      this->AppendQuantizedChunk(chunk, chunk_count * 3);
+      chunk_count = 0;
+    }
+  }
+  this->AppendQuantizedChunk(chunk, chunk_count * 3);
+  return step;
+}
+
+inline void tCanvas3D::AppendQuantizedChunk(const uint16_t* values, size_t value_count)
+{
+  this->AppendLittleEndian(values, value_count);
+}
+
+//----------------------------------------------------------------------
+// tCanvas3D DrawColoredPointCloud
 //----------------------------------------------------------------------
 template<typename TIterator>
 void tCanvas3D::DrawColoredPointCloud(TIterator points_begin, TIterator points_end)
@@ -509,6 +880,18 @@ void tCanvas3D::DrawColoredPointCloud(TIterator points_begin, TIterator points_e
     return;
   }
   this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    std::vector<typename std::iterator_traits<TIterator>::value_type> visible_points;
+    this->GetVisiblePoints(points_begin, points_end, visible_points);
+    if (visible_points.size())
+    {
+      this->AppendCommandRaw(eDRAW_COLORED_POINT_CLOUD);
+      this->Stream().WriteInt(visible_points.size());
+      this->AppendData(visible_points.begin(), visible_points.end());
+    }
+    return;
+  }
   this->AppendCommandRaw(eDRAW_COLORED_POINT_CLOUD);
   this->Stream().WriteInt(std::distance(points_begin, points_end));
   this->AppendData(points_begin, points_end);
@@ -531,6 +914,194 @@ void tCanvas3D::DrawColoredPointCloud(const math::tVector<6, TElement> &p1, cons
   this->DrawColoredPointCloud(buffer, buffer + number_of_points);
 }
 
+template<typename T>
+void tCanvas3D::DrawColoredPointCloud(const T* x, const T* y, const T* z, const T* r, const T* g, const T* b, size_t count)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    std::vector<math::tVector<6, T>> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      points.push_back(math::tVector<6, T>(x[i], y[i], z[i], r[i], g[i], b[i]));
+    }
+    this->DrawColoredPointCloud(points.begin(), points.end());
+    return;
+  }
+  this->AppendCommandRaw(eDRAW_COLORED_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  const T* const channels[] = { x, y, z, r, g, b };
+  this->AppendInterleavedData(channels, count);
+}
+
+//----------------------------------------------------------------------
+// tCanvas3D DrawRGBPointCloud
+//----------------------------------------------------------------------
+template<typename TColor>
+struct tCanvas3D::tColorEncoding
+{
+  enum { cBYTES = sizeof(TColor) };
+  static_assert(std::is_same<typename TColor::tElement, uint8_t>::value && (cBYTES == 3 || cBYTES == 4), "Colors must be vectors of 3 or 4 bytes");
+
+  static void Encode(const TColor& color, uint8_t* destination)
+  {
+    std::memcpy(destination, &color, cBYTES);
+  }
+};
+
+template<>
+struct tCanvas3D::tColorEncoding<uint32_t>
+{
+  enum { cBYTES = 4 };
+
+  static void Encode(uint32_t rgba, uint8_t* destination)
+  {
+    destination[0] = rgba >> 24 & 0xFF;
+    destination[1] = rgba >> 16 & 0xFF;
+    destination[2] = rgba >> 8 & 0xFF;
+    destination[3] = rgba & 0xFF;
+  }
+};
+
+template<typename TElement>
+struct tCanvas3D::tColorEncoding<math::tVector<6, TElement>>
+{
+  enum { cBYTES = 3 };
+
+  static void Encode(const math::tVector<6, TElement>& point, uint8_t* destination)
+  {
+    for (size_t i = 0; i < 3; i++)
+    {
+      double value = static_cast<double>(point[3 + i]);
+      destination[i] = static_cast<uint8_t>(value <= 0 ? 0 : (value >= 255 ? 255 : value + 0.5));
+    }
+  }
+};
+
+template<typename TColorIterator>
+void tCanvas3D::AppendColors(TColorIterator colors_begin, size_t count)
+{
+  typedef tColorEncoding<typename std::iterator_traits<TColorIterator>::value_type> tEncoding;
+  const size_t cCHUNK_SIZE = 1024;
+  uint8_t chunk[cCHUNK_SIZE * tEncoding::cBYTES];
+  size_t chunk_count = 0;
+  for (size_t i = 0; i < count; i++, ++colors_begin)
+  {
+    tEncoding::Encode(*colors_begin, &chunk[chunk_count * tEncoding::cBYTES]);
+    chunk_count++;
+    if (chunk_count == cCHUNK_SIZE || i + 1 == count)
+    {
+      this->Stream().Write(chunk, chunk_count * tEncoding::cBYTES);
+      chunk_count = 0;
+    }
+  }
+}
+
+template<typename TIterator>
+void tCanvas3D::DrawRGBPointCloud(TIterator points_begin, TIterator points_end)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    std::vector<typename std::iterator_traits<TIterator>::value_type> visible_points;
+    this->GetVisiblePoints(points_begin, points_end, visible_points);
+    if (visible_points.size())
+    {
+      this->AppendRGBPointCloud(visible_points.begin(), visible_points.end());
+    }
+    return;
+  }
+  this->AppendRGBPointCloud(points_begin, points_end);
+}
+
+template<typename TIterator, typename TColorIterator>
+void tCanvas3D::DrawRGBPointCloud(TIterator points_begin, TIterator points_end, TColorIterator colors_begin)
+{
+  if (this->entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  this->in_path_mode = false;
+  if (this->IsCulling())
+  {
+    const tViewFrustum& frustum = this->GetLocalCullingFrustum();
+    std::vector<typename std::iterator_traits<TIterator>::value_type> visible_points;
+    std::vector<typename std::iterator_traits<TColorIterator>::value_type> visible_colors;
+    size_t count = 0;
+    for (TIterator it = points_begin; it != points_end; ++it, ++colors_begin, count++)
+    {
+      if (frustum.Contains(static_cast<double>((*it)[0]), static_cast<double>((*it)[1]), static_cast<double>((*it)[2])))
+      {
+        visible_points.push_back(*it);
+        visible_colors.push_back(*colors_begin);
+      }
+    }
+    this->AddCulledPoints(count - visible_points.size());
+    if (visible_points.size())
+    {
+      this->AppendRGBPointCloud(visible_points.begin(), visible_points.end(), visible_colors.begin());
+    }
+    return;
+  }
+  this->AppendRGBPointCloud(points_begin, points_end, colors_begin);
+}
+
+template<typename TIterator>
+void tCanvas3D::AppendRGBPointCloud(TIterator points_begin, TIterator points_end)
+{
+  typedef typename std::iterator_traits<TIterator>::value_type tPoint;
+  typedef typename tPoint::tElement tElement;
+  size_t count = std::distance(points_begin, points_end);
+  this->AppendCommandRaw(eDRAW_RGB_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  this->Stream().WriteBoolean(false);
+
+  // Positions
+  this->Stream() << static_cast<uint8_t>(tNumberType<tElement>::value);
+  const size_t cCHUNK_SIZE = 512;
+  math::tVector<3, tElement> chunk[cCHUNK_SIZE];
+  size_t chunk_count = 0;
+  for (TIterator it = points_begin; it != points_end; ++it)
+  {
+    const tPoint& point = *it;
+    chunk[chunk_count] = math::tVector<3, tElement>(point[0], point[1], point[2]);
+    chunk_count++;
+    if (chunk_count == cCHUNK_SIZE)
+    {
+      this->AppendLittleEndian(&chunk[0][0], cCHUNK_SIZE * 3);
+      chunk_count = 0;
+    }
+  }
+  this->AppendLittleEndian(&chunk[0][0], chunk_count * 3);
+
+  // Colors
+  this->AppendColors(points_begin, count);
+}
+
+template<typename TIterator, typename TColorIterator>
+void tCanvas3D::AppendRGBPointCloud(TIterator points_begin, TIterator points_end, TColorIterator colors_begin)
+{
+  typedef tColorEncoding<typename std::iterator_traits<TColorIterator>::value_type> tEncoding;
+  size_t count = std::distance(points_begin, points_end);
+  this->AppendCommandRaw(eDRAW_RGB_POINT_CLOUD);
+  this->Stream().WriteInt(count);
+  this->Stream().WriteBoolean(tEncoding::cBYTES == 4);
+  this->AppendData(points_begin, points_end);
+  this->AppendColors(colors_begin, count);
+}
+
 //----------------------------------------------------------------------
 // tCanvas3D StartPath
 //----------------------------------------------------------------------
@@ -543,7 +1114,7 @@ void tCanvas3D::StartPath(T x, T y, T z)
     return;
   }
   T values[] = { x, y, z };
-  this->AppendCommand(ePATH_START, values, 3);
+  this->AppendCommand(ePATH_START, values);
   this->Stream().WriteBoolean(false);
   this->entering_path_mode = true;
   this->in_path_mode = true;
@@ -567,7 +1138,7 @@ void tCanvas3D::StartShape(T x, T y, T z)
     return;
   }
   T values[] = { x, y, z };
-  this->AppendCommand(ePATH_START, values, 3);
+  this->AppendCommand(ePATH_START, values);
   this->Stream().WriteBoolean(true);
   this->entering_path_mode = true;
   this->in_path_mode = true;
@@ -592,7 +1163,7 @@ void tCanvas3D::AppendLineSegment(T x, T y, T z)
   }
   this->entering_path_mode = false;
   T values[] = { x, y, z };
-  this->AppendCommand(ePATH_LINE, values, 3);
+  this->AppendCommand(ePATH_LINE, values);
 }
 
 template<typename T>
@@ -614,7 +1185,7 @@ void tCanvas3D::AppendQuadraticBezierCurve(T x1, T y1, T z1, T x2, T y2, T z2)
   }
   this->entering_path_mode = false;
   T values[] = { x1, y1, z1, x2, y2, z2 };
-  this->AppendCommand(ePATH_QUADRATIC_BEZIER_CURVE, values, 6);
+  this->AppendCommand(ePATH_QUADRATIC_BEZIER_CURVE, values);
 }
 
 template<typename T>
@@ -636,7 +1207,7 @@ void tCanvas3D::AppendCubicBezierCurve(T x1, T y1, T z1, T x2, T y2, T z2, T x3,
   }
   this->entering_path_mode = false;
   T values[] = { x1, y1, z1, x2, y2, z2, x3, y3, z3 };
-  this->AppendCommand(ePATH_CUBIC_BEZIER_CURVE, values, 9);
+  this->AppendCommand(ePATH_CUBIC_BEZIER_CURVE, values);
 }
 
 template<typename T>
@@ -0,0 +1,374 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasDelta.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasDelta.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstring>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Size of eDELTA_COPY command - shorter runs of commands are written verbatim */
+static const size_t cCOPY_COMMAND_SIZE = 9;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*!
+ * Hash of command bytes (processes 8 bytes per step)
+ */
+uint64_t HashBytes(const char* data, size_t size)
+{
+  const uint64_t cPRIME = 0x100000001B3ull;
+  uint64_t hash = 0xCBF29CE484222325ull ^ size;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * cPRIME;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; i++)
+  {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * cPRIME;
+  }
+  return hash;
+}
+
+/*!
+ * Determines offsets of all commands in data (with end of last valid command as last element)
+ */
+void GetCommandOffsets(const char* data, size_t size, unsigned int dimension, std::vector<size_t>& offsets)
+{
+  offsets.clear();
+  tCanvasReader reader(data, size, dimension);
+  tCanvasCommand command;
+  size_t end = 0;
+  while (reader.Next(command))
+  {
+    offsets.push_back(command.begin - data);
+    end = command.end - data;
+  }
+  offsets.push_back(end);
+}
+
+}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaEncoder constructors
+//----------------------------------------------------------------------
+tCanvasDeltaEncoder::tCanvasDeltaEncoder(unsigned int keyframe_interval) :
+  keyframe_interval(std::max(1u, keyframe_interval)),
+  frame_number(0),
+  frames_since_keyframe(0),
+  force_keyframe(true),
+  last_frame_keyframe(false),
+  previous_data(),
+  previous_offsets(),
+  previous_commands(),
+  current_offsets(),
+  current_hashes(),
+  output(),
+  output_stream(output)
+{}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaEncoder CommandsEqual
+//----------------------------------------------------------------------
+bool tCanvasDeltaEncoder::CommandsEqual(const char* data, size_t current, size_t previous) const
+{
+  size_t size = current_offsets[current + 1] - current_offsets[current];
+  return previous + 1 < previous_offsets.size() && size == previous_offsets[previous + 1] - previous_offsets[previous] &&
+         std::memcmp(data + current_offsets[current], previous_data.data() + previous_offsets[previous], size) == 0;
+}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaEncoder Encode
+//----------------------------------------------------------------------
+size_t tCanvasDeltaEncoder::Encode(rrlib::serialization::tOutputStream& stream, const tCanvas2D& canvas)
+{
+  return Encode(stream, canvas, 2);
+}
+
+size_t tCanvasDeltaEncoder::Encode(rrlib::serialization::tOutputStream& stream, const tCanvas3D& canvas)
+{
+  return Encode(stream, canvas, 3);
+}
+
+size_t tCanvasDeltaEncoder::Encode(rrlib::serialization::tOutputStream& stream, const tCanvas& canvas, unsigned int dimension)
+{
+  const char* data = canvas.buffer->GetBufferPointer(0);
+  const size_t size = canvas.stream->GetPosition();
+
+  // Split canvas into commands
+  current_offsets.clear();
+  current_hashes.clear();
+  tCanvasReader reader(data, size, dimension);
+  tCanvasCommand command;
+  size_t end = 0;
+  while (reader.Next(command))
+  {
+    current_offsets.push_back(command.begin - data);
+    current_hashes.push_back(HashBytes(command.begin, command.Bytes()));
+    end = command.end - data;
+  }
+  current_offsets.push_back(end);
+  if (reader.IsMalformed())
+  {
+    // Commands after malformed one cannot be addressed: such a frame can only be sent as a whole
+    RRLIB_LOG_PRINT(WARNING, "Canvas contains malformed commands. Writing keyframe.");
+    force_keyframe = true;
+  }
+
+  output.Clear();
+  output_stream.Reset(output);
+  bool keyframe = force_keyframe || frames_since_keyframe + 1 >= keyframe_interval;
+  if (!keyframe)
+  {
+    output_stream << eDELTA_FRAME;
+    output_stream.WriteInt(frame_number);
+    output_stream.WriteInt(frame_number - 1);
+    output_stream.WriteLong(canvas.default_viewport_offset);
+
+    // Runs of commands are either copied from previous frame (run_previous >= 0) or written verbatim
+    const size_t command_count = current_hashes.size();
+    size_t run_start = 0;
+    int64_t run_previous = -1;
+    for (size_t i = 0; i < command_count; i++)
+    {
+      if (run_previous >= 0 && CommandsEqual(data, i, run_previous + (i - run_start)))
+      {
+        continue;
+      }
+      int64_t match = -1;
+      auto candidates = previous_commands.equal_range(current_hashes[i]);
+      for (auto it = candidates.first; it != candidates.second; ++it)
+      {
+        if (CommandsEqual(data, i, it->second))
+        {
+          match = it->second;
+          break;
+        }
+      }
+      if (match >= 0 || run_previous >= 0)
+      {
+        WriteRun(data, run_start, i, run_previous);
+        run_start = i;
+        run_previous = match;
+      }
+    }
+    WriteRun(data, run_start, command_count, run_previous);
+
+    // Delta does not pay off
+    keyframe = output_stream.GetPosition() >= size + 13;
+    if (keyframe)
+    {
+      output.Clear();
+      output_stream.Reset(output);
+    }
+  }
+  if (keyframe)
+  {
+    output_stream << eDELTA_KEYFRAME;
+    output_stream.WriteInt(frame_number);
+    output_stream.WriteLong(canvas.default_viewport_offset);
+    output_stream.Write(data, size);
+    frames_since_keyframe = 0;
+    force_keyframe = false;
+  }
+  else
+  {
+    frames_since_keyframe++;
+  }
+  output_stream.Flush();
+  stream << output;
+  last_frame_keyframe = keyframe;
+  frame_number++;
+
+  // Current frame becomes previous frame
+  previous_data.assign(data, data + size);
+  previous_offsets.swap(current_offsets);
+  previous_commands.clear();
+  previous_commands.reserve(current_hashes.size());
+  for (size_t i = 0; i < current_hashes.size(); i++)
+  {
+    previous_commands.insert(std::make_pair(current_hashes[i], static_cast<uint32_t>(i)));
+  }
+  return output.GetSize();
+}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaEncoder WriteRun
+//----------------------------------------------------------------------
+void tCanvasDeltaEncoder::WriteRun(const char* data, size_t first, size_t last, int64_t previous_first)
+{
+  size_t bytes = current_offsets[last] - current_offsets[first];
+  if (previous_first >= 0 && bytes > cCOPY_COMMAND_SIZE)
+  {
+    output_stream << eDELTA_COPY;
+    output_stream.WriteInt(previous_first);
+    output_stream.WriteInt(last - first);
+  }
+  else
+  {
+    output_stream.Write(data + current_offsets[first], bytes);
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaDecoder constructors
+//----------------------------------------------------------------------
+tCanvasDeltaDecoder::tCanvasDeltaDecoder() :
+  valid(false),
+  frame_number(0),
+  previous_data(),
+  previous_offsets(),
+  current_data(),
+  current_offsets(),
+  input()
+{}
+
+//----------------------------------------------------------------------
+// tCanvasDeltaDecoder Decode
+//----------------------------------------------------------------------
+bool tCanvasDeltaDecoder::Decode(rrlib::serialization::tInputStream& stream, tCanvas2D& canvas)
+{
+  return Decode(stream, canvas, 2);
+}
+
+bool tCanvasDeltaDecoder::Decode(rrlib::serialization::tInputStream& stream, tCanvas3D& canvas)
+{
+  return Decode(stream, canvas, 3);
+}
+
+bool tCanvasDeltaDecoder::Decode(rrlib::serialization::tInputStream& stream, tCanvas& canvas, unsigned int dimension)
+{
+  stream >> input;
+  const char* data = input.GetBufferPointer(0);
+  const size_t size = input.GetSize();
+  tCanvasReader reader(data, size, dimension);
+  tCanvasCommand command;
+  if (!reader.Next(command))
+  {
+    valid = false;
+    return false;
+  }
+  int64_t default_viewport_offset = command.parameters.Size() ? command.parameters.Get<int64_t>(0) : 0;
+  uint32_t decoded_frame_number = command.values.Size() ? command.values.Get<uint32_t>(0) : 0;
+
+  if (command.opcode == eDELTA_KEYFRAME)
+  {
+    current_data.assign(command.end, data + size);
+    GetCommandOffsets(current_data.data(), current_data.size(), dimension, current_offsets);
+  }
+  else if (command.opcode == eDELTA_FRAME && valid && command.values.Get<uint32_t>(1) == frame_number)
+  {
+    current_data.clear();
+    current_offsets.clear();
+    while (reader.Next(command))
+    {
+      if (command.opcode == eDELTA_COPY)
+      {
+        size_t first = command.values.Get<uint32_t>(0);
+        size_t count = command.values.Get<uint32_t>(1);
+        if (first + count >= previous_offsets.size())
+        {
+          valid = false;
+          return false;
+        }
+        for (size_t i = first; i < first + count; i++)
+        {
+          current_offsets.push_back(current_data.size() + previous_offsets[i] - previous_offsets[first]);
+        }
+        current_data.insert(current_data.end(), previous_data.begin() + previous_offsets[first], previous_data.begin() + previous_offsets[first + count]);
+      }
+      else if (command.opcode == eDELTA_KEYFRAME || command.opcode == eDELTA_FRAME)
+      {
+        valid = false;
+        return false;
+      }
+      else
+      {
+        current_offsets.push_back(current_data.size());
+        current_data.insert(current_data.end(), command.begin, command.end);
+      }
+    }
+    if (reader.IsMalformed())
+    {
+      valid = false;
+      return false;
+    }
+    current_offsets.push_back(current_data.size());
+  }
+  else
+  {
+    valid = false;
+    return false;
+  }
+
+  valid = true;
+  frame_number = decoded_frame_number;
+  previous_data.swap(current_data);
+  previous_offsets.swap(current_offsets);
+
+  canvas.Clear();
+  canvas.stream->Write(previous_data.data(), previous_data.size());
+  canvas.ResetAfterLoad();
+
+  // Canvas data only starts with eDEFAULT_VIEWPORT_OFFSET if encoded canvas was deserialized - so use transmitted offset
+  canvas.default_viewport_offset = default_viewport_offset;
+  return true;
+}
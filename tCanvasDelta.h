@@ -0,0 +1,245 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasDelta.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasDeltaEncoder and tCanvasDeltaDecoder
+ *
+ * \b tCanvasDeltaEncoder
+ *
+ * Serializes consecutive frames of a canvas as differences to the previous frame.
+ *
+ * \b tCanvasDeltaDecoder
+ *
+ * Reconstructs canvases from data written by tCanvasDeltaEncoder.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasDelta_h__
+#define __rrlib__canvas__tCanvasDelta_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <unordered_map>
+#include <vector>
+
+#include "rrlib/serialization/tInputStream.h"
+#include "rrlib/serialization/tMemoryBuffer.h"
+#include "rrlib/serialization/tOutputStream.h"
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Delta encoder for canvases that are sent repeatedly
+/*!
+ * When a canvas is redrawn and sent in every control cycle, most commands
+ * are usually identical to the ones of the previous frame.
+ * This encoder compares a canvas with the previously encoded frame at command
+ * granularity. Runs of commands that already occurred in the previous frame are
+ * replaced by eDELTA_COPY commands - only new or changed commands are written.
+ *
+ * Every keyframe_interval frames (and whenever a delta would not be smaller),
+ * a keyframe with the complete canvas is written instead.
+ * Data is written with the same framing as operator << (size followed by data),
+ * so it can be sent wherever serialized canvases are sent.
+ * A receiver must decode every frame (in order) with a tCanvasDeltaDecoder.
+ * After packet loss or when a receiver joins, ForceKeyframe() should be called.
+ *
+ * Commands are found via hash map - so encoding is linear in canvas size.
+ */
+class tCanvasDeltaEncoder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param keyframe_interval A keyframe is written at least every keyframe_interval frames (1 disables delta encoding)
+   */
+  tCanvasDeltaEncoder(unsigned int keyframe_interval = 50);
+
+  /*!
+   * Writes canvas as delta to previously encoded frame (or as keyframe)
+   *
+   * \param stream Stream to write to
+   * \param canvas Canvas to encode
+   * \return Number of bytes written (excluding leading size)
+   */
+  size_t Encode(serialization::tOutputStream& stream, const tCanvas2D& canvas);
+  size_t Encode(serialization::tOutputStream& stream, const tCanvas3D& canvas);
+
+  /*!
+   * Next frame will be a keyframe
+   */
+  void ForceKeyframe()
+  {
+    force_keyframe = true;
+  }
+
+  /*!
+   * \return Whether last encoded frame was a keyframe
+   */
+  bool LastFrameWasKeyframe() const
+  {
+    return last_frame_keyframe;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  unsigned int keyframe_interval;
+
+  /*! Number of frame that is encoded next */
+  uint32_t frame_number;
+
+  /*! Number of frames since last keyframe */
+  unsigned int frames_since_keyframe;
+
+  bool force_keyframe;
+
+  bool last_frame_keyframe;
+
+  /*! Data of previous frame */
+  std::vector<char> previous_data;
+
+  /*! Offsets of commands in previous frame (with end of data as last element) */
+  std::vector<size_t> previous_offsets;
+
+  /*! Commands of previous frame by hash of their bytes */
+  std::unordered_multimap<uint64_t, uint32_t> previous_commands;
+
+  /*! Offsets and hashes of commands in current frame */
+  std::vector<size_t> current_offsets;
+  std::vector<uint64_t> current_hashes;
+
+  /*! Buffer that frame is encoded to */
+  serialization::tMemoryBuffer output;
+  serialization::tOutputStream output_stream;
+
+  /*!
+   * Implementation of Encode()
+   */
+  size_t Encode(serialization::tOutputStream& stream, const tCanvas& canvas, unsigned int dimension);
+
+  /*!
+   * \return Whether command with index 'current' equals command with index 'previous' in previous frame
+   */
+  bool CommandsEqual(const char* data, size_t current, size_t previous) const;
+
+  /*!
+   * Writes commands [first, last) of current frame - either copied from previous frame or verbatim
+   */
+  void WriteRun(const char* data, size_t first, size_t last, int64_t previous_first);
+};
+
+//! Decoder for data written by tCanvasDeltaEncoder
+/*!
+ * Keeps the last decoded frame so that subsequent delta frames can be reconstructed.
+ */
+class tCanvasDeltaDecoder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  tCanvasDeltaDecoder();
+
+  /*!
+   * Reads frame from stream and reconstructs canvas
+   *
+   * \param stream Stream to read from
+   * \param canvas Canvas to store decoded frame in (is cleared first)
+   * \return False if frame could not be decoded (malformed data, or a delta frame whose previous frame was not decoded).
+   *         The decoder then waits for the next keyframe.
+   */
+  bool Decode(serialization::tInputStream& stream, tCanvas2D& canvas);
+  bool Decode(serialization::tInputStream& stream, tCanvas3D& canvas);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Is there a valid previous frame? */
+  bool valid;
+
+  /*! Number of previous frame */
+  uint32_t frame_number;
+
+  /*! Data of previous frame */
+  std::vector<char> previous_data;
+
+  /*! Offsets of commands in previous frame (with end of data as last element) */
+  std::vector<size_t> previous_offsets;
+
+  /*! Frame that is currently reconstructed */
+  std::vector<char> current_data;
+  std::vector<size_t> current_offsets;
+
+  /*! Buffer that encoded frame is read to */
+  serialization::tMemoryBuffer input;
+
+  /*!
+   * Implementation of Decode()
+   */
+  bool Decode(serialization::tInputStream& stream, tCanvas& canvas, unsigned int dimension);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
@@ -0,0 +1,251 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasOptimizer.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasOptimizer.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstring>
+#include <limits>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tCanvasOptimizer constructors
+//----------------------------------------------------------------------
+tCanvasOptimizer::tCanvasOptimizer() :
+  scratch_buffer(new serialization::tMemoryBuffer()),
+  run(),
+  run_type(eRUN_NONE)
+{}
+
+//----------------------------------------------------------------------
+// tCanvasOptimizer ExtendsRun
+//----------------------------------------------------------------------
+bool tCanvasOptimizer::ExtendsRun(const tCanvasCommand& command, unsigned int dimension) const
+{
+  if (run.empty() || command.opcode != run.back().opcode || command.values.NumberType() != run.back().values.NumberType())
+  {
+    return false;
+  }
+  switch (run_type)
+  {
+  case eRUN_LINE_SEGMENTS:
+  {
+    // Line strip has one more point than segments - 2D line strips have 16 bit point count
+    size_t max_segments = (dimension == 2 ? std::numeric_limits<uint16_t>::max() : std::numeric_limits<int32_t>::max()) - 1;
+    size_t point_bytes = command.values.Bytes() / 2;
+    return run.size() < max_segments && std::memcmp(command.values.Data(), run.back().values.Data() + point_bytes, point_bytes) == 0;
+  }
+  case eRUN_POINTS:
+    return run.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max());
+  case eRUN_TRANSLATIONS:
+    return true;
+  default:
+    return false;
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasOptimizer FlushRun
+//----------------------------------------------------------------------
+void tCanvasOptimizer::FlushRun(tCanvas& canvas, unsigned int dimension, tCanvasOptimizationReport& report)
+{
+  if (run.empty())
+  {
+    return;
+  }
+  serialization::tOutputStream& stream = *canvas.stream;
+  report.commands_after++;
+  if (run.size() == 1)
+  {
+    stream.Write(run[0].begin, run[0].Bytes());
+  }
+  else if (run_type == eRUN_LINE_SEGMENTS)
+  {
+    size_t point_bytes = run[0].values.Bytes() / 2;
+    stream << static_cast<uint8_t>(eDRAW_LINE_STRIP);
+    if (dimension == 2)
+    {
+      stream.WriteShort(run.size() + 1);
+    }
+    else
+    {
+      stream.WriteInt(run.size() + 1);
+    }
+    stream << static_cast<uint8_t>(run[0].values.NumberType());
+    stream.Write(run[0].values.Data(), point_bytes);
+    for (const tCanvasCommand & command : run)
+    {
+      stream.Write(command.values.Data() + point_bytes, point_bytes);
+    }
+    report.merged_line_segments += run.size();
+  }
+  else if (run_type == eRUN_POINTS)
+  {
+    stream << static_cast<uint8_t>(eDRAW_POINT_CLOUD);
+    stream.WriteInt(run.size());
+    stream << static_cast<uint8_t>(run[0].values.NumberType());
+    for (const tCanvasCommand & command : run)
+    {
+      stream.Write(command.values.Data(), command.values.Bytes());
+    }
+    report.merged_points += run.size();
+  }
+  else if (run_type == eRUN_TRANSLATIONS)
+  {
+    double sum[3] = { 0, 0, 0 };
+    for (const tCanvasCommand & command : run)
+    {
+      for (unsigned int i = 0; i < dimension; i++)
+      {
+        sum[i] += command.values.Get<double>(i);
+      }
+    }
+    if (run[0].values.NumberType() == eFLOAT)
+    {
+      float values[3] = { static_cast<float>(sum[0]), static_cast<float>(sum[1]), static_cast<float>(sum[2]) };
+      canvas.AppendCommand(eTRANSLATE, values, dimension);
+    }
+    else
+    {
+      canvas.AppendCommand(eTRANSLATE, sum, dimension);
+    }
+    report.merged_translations += run.size();
+  }
+  run.clear();
+  run_type = eRUN_NONE;
+}
+
+//----------------------------------------------------------------------
+// tCanvasOptimizer GetRunType
+//----------------------------------------------------------------------
+tCanvasOptimizer::tRunType tCanvasOptimizer::GetRunType(const tCanvasCommand& command, unsigned int dimension) const
+{
+  switch (command.opcode)
+  {
+  case eDRAW_LINE_SEGMENT:
+    return eRUN_LINE_SEGMENTS;
+  case eDRAW_POINT:
+    return dimension == 3 ? eRUN_POINTS : eRUN_NONE;
+  case eTRANSLATE:
+    // Sums of integer translations could overflow
+    return (command.values.NumberType() == eFLOAT || command.values.NumberType() == eDOUBLE) ? eRUN_TRANSLATIONS : eRUN_NONE;
+  default:
+    return eRUN_NONE;
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasOptimizer Optimize
+//----------------------------------------------------------------------
+tCanvasOptimizationReport tCanvasOptimizer::Optimize(tCanvas2D& canvas)
+{
+  return Optimize(canvas, 2);
+}
+
+tCanvasOptimizationReport tCanvasOptimizer::Optimize(tCanvas3D& canvas)
+{
+  return Optimize(canvas, 3);
+}
+
+tCanvasOptimizationReport tCanvasOptimizer::Optimize(tCanvas& canvas, unsigned int dimension)
+{
+  tCanvasOptimizationReport report;
+  report.bytes_before = canvas.stream->GetPosition();
+  canvas.stream->Flush();
+
+  // Canvas writes to scratch buffer - commands are read from its former buffer
+  std::swap(canvas.buffer, scratch_buffer);
+  canvas.buffer->Clear();
+  canvas.stream->Reset(*canvas.buffer);
+  canvas.Reserve(report.bytes_before);
+  const char* data = scratch_buffer->GetBufferPointer(0);
+  const size_t old_default_viewport_offset = canvas.default_viewport_offset;
+
+  tCanvasReader reader(data, report.bytes_before, dimension);
+  tCanvasCommand command;
+  const char* end = data;
+  while (reader.Next(command))
+  {
+    report.commands_before++;
+    end = command.end;
+    if (ExtendsRun(command, dimension))
+    {
+      run.push_back(command);
+      continue;
+    }
+    FlushRun(canvas, dimension, report);
+    run_type = GetRunType(command, dimension);
+    if (run_type != eRUN_NONE)
+    {
+      run.push_back(command);
+      continue;
+    }
+    if (old_default_viewport_offset && static_cast<size_t>(command.begin - data) == old_default_viewport_offset)
+    {
+      canvas.default_viewport_offset = canvas.stream->GetPosition();
+    }
+    canvas.stream->Write(command.begin, command.Bytes());
+    report.commands_after++;
+  }
+  FlushRun(canvas, dimension, report);
+  if (reader.IsMalformed())
+  {
+    RRLIB_LOG_PRINT(WARNING, "Canvas contains malformed commands. These are copied unchanged.");
+    canvas.stream->Write(end, (data + report.bytes_before) - end);
+  }
+
+  report.bytes_after = canvas.stream->GetPosition();
+  return report;
+}
@@ -0,0 +1,183 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasOptimizer.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasOptimizer
+ *
+ * \b tCanvasOptimizer
+ *
+ * Rewrites finished canvases with fewer, larger commands.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasOptimizer_h__
+#define __rrlib__canvas__tCanvasOptimizer_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <memory>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Result of tCanvasOptimizer::Optimize()
+ */
+struct tCanvasOptimizationReport
+{
+  /*! Number of commands before and after optimization */
+  size_t commands_before, commands_after;
+
+  /*! Size of canvas in bytes before and after optimization */
+  size_t bytes_before, bytes_after;
+
+  /*! Number of line segments that were merged into line strips */
+  size_t merged_line_segments;
+
+  /*! Number of points that were merged into point clouds */
+  size_t merged_points;
+
+  /*! Number of translations that were merged with other translations */
+  size_t merged_translations;
+
+  tCanvasOptimizationReport() :
+    commands_before(0),
+    commands_after(0),
+    bytes_before(0),
+    bytes_after(0),
+    merged_line_segments(0),
+    merged_points(0),
+    merged_translations(0)
+  {}
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Canvas optimizer
+/*!
+ * Merges runs of adjacent commands that can be expressed by a single command:
+ *
+ *  - connected line segments (end point of one equals start point of next) into a line strip
+ *  - points into a point cloud (tCanvas3D only - there is no 2D point cloud command)
+ *  - consecutive translations (eFLOAT or eDOUBLE) into one translation
+ *
+ * Only commands with the same number type are merged. All other commands are
+ * copied unchanged - so rendering results are preserved.
+ * The default viewport offset is adjusted to the rewritten canvas.
+ *
+ * The optimizer keeps a scratch buffer that it exchanges with the canvas buffer -
+ * so an optimizer object should be reused.
+ */
+class tCanvasOptimizer
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  tCanvasOptimizer();
+
+  /*!
+   * Optimizes canvas
+   *
+   * \param canvas Finished canvas to optimize
+   * \return Report on command count and byte savings
+   */
+  tCanvasOptimizationReport Optimize(tCanvas2D& canvas);
+  tCanvasOptimizationReport Optimize(tCanvas3D& canvas);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Kind of commands in current run */
+  enum tRunType
+  {
+    eRUN_NONE,
+    eRUN_LINE_SEGMENTS,
+    eRUN_POINTS,
+    eRUN_TRANSLATIONS
+  };
+
+  /*! Buffer that is exchanged with canvas buffer */
+  std::unique_ptr<serialization::tMemoryBuffer> scratch_buffer;
+
+  /*! Commands of current run */
+  std::vector<tCanvasCommand> run;
+
+  tRunType run_type;
+
+  /*!
+   * Implementation of Optimize()
+   */
+  tCanvasOptimizationReport Optimize(tCanvas& canvas, unsigned int dimension);
+
+  /*!
+   * \return Whether command can be appended to current run
+   */
+  bool ExtendsRun(const tCanvasCommand& command, unsigned int dimension) const;
+
+  /*!
+   * Writes current run to canvas (merged if it contains more than one command)
+   */
+  void FlushRun(tCanvas& canvas, unsigned int dimension, tCanvasOptimizationReport& report);
+
+  /*!
+   * \return Type of run that command can start
+   */
+  tRunType GetRunType(const tCanvasCommand& command, unsigned int dimension) const;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
@@ -0,0 +1,161 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasPool.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasPool
+ *
+ * \b tCanvasPool
+ *
+ * Recycles canvases (with their buffers) for publishers that create canvases at a high rate.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasPool_h__
+#define __rrlib__canvas__tCanvasPool_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <memory>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Pool of canvases
+/*!
+ * Constructing a canvas allocates a buffer and a stream. Publishers that create
+ * a canvas for every frame can instead acquire canvases from this pool and
+ * release them when they are no longer needed.
+ *
+ * The pool has a fixed number of slots that are filled with canvases on construction.
+ * Canvases are moved in and out of slots - which swaps buffers and streams without
+ * allocating memory. So canvases keep their capacity (and high water mark) when recycled.
+ *
+ * Acquire() and Release() are thread-safe and lock-free (each slot is claimed via
+ * compare-and-swap). If the pool is empty, Acquire() constructs a new canvas.
+ * If all slots are occupied, Release() lets the canvas be destroyed.
+ *
+ * Usage:
+ *
+ *   tCanvas2D canvas = pool.Acquire();
+ *   ... (draw and publish canvas)
+ *   pool.Release(std::move(canvas));
+ *
+ * \tparam TCanvas Type of canvases (tCanvas2D or tCanvas3D)
+ */
+template <typename TCanvas>
+class tCanvasPool : public rrlib::util::tNoncopyable
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param slot_count Number of canvases the pool can hold
+   * \param initial_capacity Buffer capacity (in bytes) that canvases are created with
+   */
+  inline tCanvasPool(size_t slot_count, size_t initial_capacity = 0);
+
+  /*!
+   * Obtains canvas from pool (thread-safe and lock-free)
+   *
+   * \return Cleared canvas with default settings (newly constructed if the pool is empty)
+   */
+  inline TCanvas Acquire();
+
+  /*!
+   * \return Number of slots
+   */
+  size_t GetSlotCount() const
+  {
+    return slot_count;
+  }
+
+  /*!
+   * Returns canvas to pool (thread-safe and lock-free)
+   * Canvases that have been moved from (and therefore have no buffer) are discarded.
+   *
+   * \param canvas Canvas to return (is cleared - and its settings are reset with tCanvas::ResetSettings())
+   */
+  inline void Release(TCanvas && canvas);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  enum tSlotState
+  {
+    eEMPTY,   //!< Slot contains no usable canvas
+    eFULL,    //!< Slot contains a canvas that can be acquired
+    eBUSY     //!< Canvas is currently moved in or out of slot
+  };
+
+  struct tSlot
+  {
+    std::atomic<int> state;
+    TCanvas canvas;
+  };
+
+  size_t slot_count;
+
+  std::unique_ptr<tSlot[]> slots;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tCanvasPool.hpp"
+
+#endif
@@ -0,0 +1,129 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasPool.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tCanvasPool constructors
+//----------------------------------------------------------------------
+template <typename TCanvas>
+tCanvasPool<TCanvas>::tCanvasPool(size_t slot_count, size_t initial_capacity) :
+  slot_count(slot_count),
+  slots(new tSlot[slot_count])
+{
+  for (size_t i = 0; i < slot_count; i++)
+  {
+    slots[i].canvas.Reserve(initial_capacity);
+    slots[i].state.store(eFULL, std::memory_order_release);
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasPool Acquire
+//----------------------------------------------------------------------
+template <typename TCanvas>
+TCanvas tCanvasPool<TCanvas>::Acquire()
+{
+  for (size_t i = 0; i < slot_count; i++)
+  {
+    int expected = eFULL;
+    if (slots[i].state.compare_exchange_strong(expected, eBUSY, std::memory_order_acquire))
+    {
+      TCanvas canvas(std::move(slots[i].canvas));
+      slots[i].state.store(eEMPTY, std::memory_order_release);
+      return canvas;
+    }
+  }
+  return TCanvas();
+}
+
+//----------------------------------------------------------------------
+// tCanvasPool Release
+//----------------------------------------------------------------------
+template <typename TCanvas>
+void tCanvasPool<TCanvas>::Release(TCanvas && canvas)
+{
+  tCanvas& released = canvas;
+  if (!released.buffer)
+  {
+    return;
+  }
+  released.Clear();
+  released.ResetSettings();
+  released.entering_path_mode = false;
+  released.in_path_mode = false;
+
+  for (size_t i = 0; i < slot_count; i++)
+  {
+    int expected = eEMPTY;
+    if (slots[i].state.compare_exchange_strong(expected, eBUSY, std::memory_order_acquire))
+    {
+      slots[i].canvas = std::move(canvas);
+      slots[i].state.store(eFULL, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
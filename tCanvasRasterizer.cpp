@@ -0,0 +1,1111 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasRasterizer.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasRasterizer.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasReader.h"
+#include "rrlib/canvas/internal/tAffineTransformation.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Edge length of points in pixels */
+static const double cPOINT_SIZE = 2;
+
+/*! Maximum distance between vertices of flattened curves in pixels */
+static const double cCURVE_STEP = 4;
+
+/*! Maximum number of line segments per flattened curve (or ellipse) */
+static const double cMAX_CURVE_SEGMENTS = 256;
+
+/*! Length of arrow heads in pixels */
+static const double cARROW_HEAD_SIZE = 8;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+uint32_t PackColor(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
+{
+  uint8_t bytes[4] = { r, g, b, alpha };
+  uint32_t color;
+  std::memcpy(&color, bytes, 4);
+  return color;
+}
+
+/*!
+ * Blends color over pixel (dst = (src * alpha + dst * (255 - alpha)) / 255 for each channel)
+ */
+inline void BlendPixel(uint32_t* pixel, uint32_t color, uint8_t alpha)
+{
+  if (alpha == 255)
+  {
+    *pixel = color;
+    return;
+  }
+  uint8_t source[4], destination[4];
+  std::memcpy(source, &color, 4);
+  std::memcpy(destination, pixel, 4);
+  for (size_t i = 0; i < 4; i++)
+  {
+    unsigned int value = source[i] * alpha + destination[i] * (255u - alpha) + 128;
+    destination[i] = static_cast<uint8_t>((value + (value >> 8)) >> 8);
+  }
+  std::memcpy(pixel, destination, 4);
+}
+
+/*!
+ * Blends color over span of pixels
+ */
+void BlendSpan(uint32_t* pixel, size_t count, uint32_t color, uint8_t alpha)
+{
+  if (alpha == 255)
+  {
+    std::fill(pixel, pixel + count, color);
+    return;
+  }
+  size_t i = 0;
+#ifdef __SSE2__
+  // Four pixels per step - with channels widened to 16 bit
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i source = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(color), zero), _mm_set1_epi16(alpha)), _mm_set1_epi16(128));
+  const __m128i inverse_alpha = _mm_set1_epi16(255 - alpha);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixel + i));
+    __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), inverse_alpha), source);
+    __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), inverse_alpha), source);
+    low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixel + i), _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    BlendPixel(pixel + i, color, alpha);
+  }
+}
+
+/*!
+ * Rounds value down and clamps it to [min, max] - also for huge and invalid values (std::floor is a library call without SSE4.1)
+ */
+inline int FloorToInt(float value, int min, int max)
+{
+  if (!(value > min))
+  {
+    return min;
+  }
+  if (value >= max)
+  {
+    return max;
+  }
+  int result = static_cast<int>(value);
+  return result - (value < result);
+}
+
+/*!
+ * Rounds value up and clamps it to [min, max]
+ */
+inline int CeilToInt(float value, int min, int max)
+{
+  if (!(value > min))
+  {
+    return min;
+  }
+  if (value >= max)
+  {
+    return max;
+  }
+  int result = static_cast<int>(value);
+  return result + (value > result);
+}
+
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer::tDisplayListBuilder
+//----------------------------------------------------------------------
+/*!
+ * Replays canvas commands and appends their geometry - in pixel coordinates - to the display list.
+ * In measuring mode, only the vertices are of interest (to fit the viewport to the geometry):
+ * curves and ellipses then add their control points only.
+ */
+class tCanvasRasterizer::tDisplayListBuilder
+{
+public:
+
+  /*!
+   * \param viewport_transformation Transformation from canvas to pixel coordinates (as 2D eSET_TRANSFORMATION values)
+   */
+  tDisplayListBuilder(tCanvasRasterizer& rasterizer, const double (&viewport_transformation)[6], bool measure) :
+    default_viewport_found(false),
+    primitives(rasterizer.primitives),
+    vertices(rasterizer.vertices),
+    measure(measure),
+    image_width(rasterizer.width),
+    image_height(rasterizer.height),
+    transformation(),
+    edge_color(PackColor(0, 0, 0, 255)),
+    fill_color(PackColor(0, 0, 0, 255)),
+    alpha(255),
+    fill(false),
+    path_first_vertex(0),
+    in_path(false),
+    path_shape(false)
+  {
+    std::copy(viewport_transformation, viewport_transformation + 6, this->viewport_transformation);
+    UpdatePixelTransformation();
+    primitives.clear();
+    vertices.clear();
+  }
+
+  /*!
+   * Replays all commands of reader
+   */
+  void Replay(tCanvasReader& reader)
+  {
+    tCanvasCommand command;
+    while (reader.Next(command))
+    {
+      if (in_path && (command.opcode == ePATH_START || (command.opcode >= eDRAW_POINT && command.opcode <= eDRAW_STRING)))
+      {
+        EndPath(false);
+      }
+      Process(command);
+      if (measure && default_viewport_found)
+      {
+        break;
+      }
+    }
+    if (in_path)
+    {
+      EndPath(false);
+    }
+  }
+
+  /*! Default viewport of canvas (if default_viewport_found is true) */
+  double default_viewport[4];
+  bool default_viewport_found;
+
+private:
+
+  std::vector<tPrimitive>& primitives;
+  std::vector<float>& vertices;
+  const bool measure;
+  const double image_width, image_height;
+
+  /*! Canvas transformation */
+  internal::tAffineTransformation transformation;
+
+  /*! Transformations from canvas to pixel coordinates: viewport transformation only - and combined with canvas transformation */
+  double viewport_transformation[6];
+  double pixel_transformation[6];
+
+  uint32_t edge_color, fill_color;
+  uint8_t alpha;
+  bool fill;
+
+  /*! Current path or shape */
+  size_t path_first_vertex;
+  bool in_path, path_shape;
+
+  /*!
+   * Appends vertex (in canvas coordinates)
+   */
+  void AddVertex(double x, double y)
+  {
+    const double* m = pixel_transformation;
+    vertices.push_back(static_cast<float>(m[0] * x + m[2] * y + m[4]));
+    vertices.push_back(static_cast<float>(m[1] * x + m[3] * y + m[5]));
+  }
+
+  /*!
+   * Appends vertex (in pixel coordinates)
+   */
+  void AddPixelVertex(double x, double y)
+  {
+    vertices.push_back(static_cast<float>(x));
+    vertices.push_back(static_cast<float>(y));
+  }
+
+  /*!
+   * Appends primitive with vertices [first_vertex, end of vertex buffer)
+   */
+  void AddPrimitive(tPrimitiveType type, uint32_t color, size_t first_vertex)
+  {
+    size_t vertex_count = vertices.size() / 2 - first_vertex;
+    if (measure || vertex_count == 0 || alpha == 0 || (type == eFILL && vertex_count < 3))
+    {
+      return;
+    }
+    tPrimitive primitive;
+    const float* vertex = &vertices[first_vertex * 2];
+    primitive.bounds[0] = primitive.bounds[2] = vertex[0];
+    primitive.bounds[1] = primitive.bounds[3] = vertex[1];
+    for (size_t i = 1; i < vertex_count; i++)
+    {
+      vertex += 2;
+      primitive.bounds[0] = std::min(primitive.bounds[0], vertex[0]);
+      primitive.bounds[1] = std::min(primitive.bounds[1], vertex[1]);
+      primitive.bounds[2] = std::max(primitive.bounds[2], vertex[0]);
+      primitive.bounds[3] = std::max(primitive.bounds[3], vertex[1]);
+    }
+    primitive.first_vertex = static_cast<uint32_t>(first_vertex);
+    primitive.vertex_count = static_cast<uint32_t>(vertex_count);
+    primitive.color = color;
+    primitive.alpha = alpha;
+    primitive.type = type;
+    primitives.push_back(primitive);
+  }
+
+  /*!
+   * Appends primitives for outline with vertices [first_vertex, end of vertex buffer):
+   * filled with fill color (if fill is enabled) and edge with edge color
+   */
+  void AddOutline(size_t first_vertex)
+  {
+    if (fill)
+    {
+      AddPrimitive(eFILL, fill_color, first_vertex);
+    }
+    AddPrimitive(eSTROKE_CLOSED, edge_color, first_vertex);
+  }
+
+  /*!
+   * Appends vertices of cubic bezier curve (in pixel coordinates) - except first control point
+   */
+  void AddCubicBezierCurve(const double (&points)[8])
+  {
+    if (measure)
+    {
+      for (size_t i = 2; i < 8; i += 2)
+      {
+        AddPixelVertex(points[i], points[i + 1]);
+      }
+      return;
+    }
+    double length = 0;
+    for (size_t i = 2; i < 8; i += 2)
+    {
+      length += std::hypot(points[i] - points[i - 2], points[i + 1] - points[i - 1]);
+    }
+    size_t segments = static_cast<size_t>(std::max(1.0, std::min(cMAX_CURVE_SEGMENTS, std::ceil(length / cCURVE_STEP))));
+    for (size_t i = 1; i <= segments; i++)
+    {
+      double t = static_cast<double>(i) / segments, s = 1 - t;
+      double w0 = s * s * s, w1 = 3 * s * s * t, w2 = 3 * s * t * t, w3 = t * t * t;
+      AddPixelVertex(w0 * points[0] + w1 * points[2] + w2 * points[4] + w3 * points[6], w0 * points[1] + w1 * points[3] + w2 * points[5] + w3 * points[7]);
+    }
+  }
+
+  /*!
+   * Appends vertices of bezier curve of arbitrary degree (control points in canvas coordinates)
+   */
+  void AddBezierCurve(const tCanvasValues& values, size_t count)
+  {
+    std::vector<double>& points = scratch;
+    points.resize(count * 2);
+    for (size_t i = 0; i < count; i++)
+    {
+      const double* m = pixel_transformation;
+      double x = values.Get<double>(i * 2), y = values.Get<double>(i * 2 + 1);
+      points[i * 2] = m[0] * x + m[2] * y + m[4];
+      points[i * 2 + 1] = m[1] * x + m[3] * y + m[5];
+    }
+    AddPixelVertex(points[0], points[1]);
+    if (measure || count < 2)
+    {
+      for (size_t i = 1; i < count; i++)
+      {
+        AddPixelVertex(points[i * 2], points[i * 2 + 1]);
+      }
+      return;
+    }
+    double length = 0;
+    for (size_t i = 1; i < count; i++)
+    {
+      length += std::hypot(points[i * 2] - points[i * 2 - 2], points[i * 2 + 1] - points[i * 2 - 1]);
+    }
+    size_t segments = static_cast<size_t>(std::max(1.0, std::min(cMAX_CURVE_SEGMENTS, std::ceil(length / cCURVE_STEP))));
+    std::vector<double> casteljau(count * 2);
+    for (size_t i = 1; i <= segments; i++)
+    {
+      double t = static_cast<double>(i) / segments;
+      casteljau = points;
+      for (size_t level = count - 1; level > 0; level--)
+      {
+        for (size_t j = 0; j < level * 2; j++)
+        {
+          casteljau[j] += t * (casteljau[j + 2] - casteljau[j]);
+        }
+      }
+      AddPixelVertex(casteljau[0], casteljau[1]);
+    }
+  }
+
+  /*!
+   * Appends polygon of ellipse with the specified bounding box (in canvas coordinates)
+   */
+  void AddEllipse(double x, double y, double width, double height)
+  {
+    const double* m = pixel_transformation;
+    double center_x = x + width / 2, center_y = y + height / 2;
+    double center[2] = { m[0] * center_x + m[2] * center_y + m[4], m[1] * center_x + m[3] * center_y + m[5] };
+    double axis1[2] = { m[0] * width / 2, m[1] * width / 2 };
+    double axis2[2] = { m[2] * height / 2, m[3] * height / 2 };
+    if (measure)
+    {
+      AddPixelVertex(center[0] + axis1[0] + axis2[0], center[1] + axis1[1] + axis2[1]);
+      AddPixelVertex(center[0] - axis1[0] - axis2[0], center[1] - axis1[1] - axis2[1]);
+      AddPixelVertex(center[0] + axis1[0] - axis2[0], center[1] + axis1[1] - axis2[1]);
+      AddPixelVertex(center[0] - axis1[0] + axis2[0], center[1] - axis1[1] + axis2[1]);
+      return;
+    }
+    double radius = std::max(std::hypot(axis1[0], axis1[1]), std::hypot(axis2[0], axis2[1]));
+    size_t segments = static_cast<size_t>(std::max(8.0, std::min(cMAX_CURVE_SEGMENTS, std::ceil(2 * M_PI * radius / cCURVE_STEP))));
+    for (size_t i = 0; i < segments; i++)
+    {
+      double angle = 2 * M_PI * i / segments;
+      double c = std::cos(angle), s = std::sin(angle);
+      AddPixelVertex(center[0] + c * axis1[0] + s * axis2[0], center[1] + c * axis1[1] + s * axis2[1]);
+    }
+  }
+
+  /*!
+   * Appends vertices of cardinal spline through the specified points (in canvas coordinates)
+   */
+  void AddSpline(const tCanvasValues& values, size_t count, double tension)
+  {
+    std::vector<double>& points = scratch;
+    points.resize(count * 2);
+    for (size_t i = 0; i < count; i++)
+    {
+      const double* m = pixel_transformation;
+      double x = values.Get<double>(i * 2), y = values.Get<double>(i * 2 + 1);
+      points[i * 2] = m[0] * x + m[2] * y + m[4];
+      points[i * 2 + 1] = m[1] * x + m[3] * y + m[5];
+    }
+    AddPixelVertex(points[0], points[1]);
+
+    // Each segment is converted to a cubic bezier curve with tangents (1 - tension) * (p[i + 1] - p[i - 1]) / 2
+    double factor = (1 - tension) / 6;
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+      size_t previous = i > 0 ? i - 1 : 0;
+      size_t next = std::min(i + 2, count - 1);
+      double bezier[8] =
+      {
+        points[i * 2], points[i * 2 + 1],
+        points[i * 2] + factor * (points[i * 2 + 2] - points[previous * 2]), points[i * 2 + 1] + factor * (points[i * 2 + 3] - points[previous * 2 + 1]),
+        points[i * 2 + 2] - factor * (points[next * 2] - points[i * 2]), points[i * 2 + 3] - factor * (points[next * 2 + 1] - points[i * 2 + 1]),
+        points[i * 2 + 2], points[i * 2 + 3]
+      };
+      AddCubicBezierCurve(bezier);
+    }
+  }
+
+  /*!
+   * Ends current path or shape
+   *
+   * \param closed Whether path is closed
+   */
+  void EndPath(bool closed)
+  {
+    in_path = false;
+    if (path_shape)
+    {
+      AddOutline(path_first_vertex);
+    }
+    else
+    {
+      AddPrimitive(closed ? eSTROKE_CLOSED : eSTROKE_OPEN, edge_color, path_first_vertex);
+    }
+  }
+
+  /*!
+   * Processes single command
+   */
+  void Process(const tCanvasCommand& command)
+  {
+    const tCanvasValues& values = command.values;
+    size_t first_vertex = vertices.size() / 2;
+    switch (command.opcode)
+    {
+    case eSET_TRANSFORMATION:
+    case eTRANSFORM:
+    {
+      internal::tAffineTransformation::tMatrix matrix = {{ 0 }};
+      matrix[0] = values.Get<double>(0);
+      matrix[4] = values.Get<double>(1);
+      matrix[1] = values.Get<double>(2);
+      matrix[5] = values.Get<double>(3);
+      matrix[3] = values.Get<double>(4);
+      matrix[7] = values.Get<double>(5);
+      matrix[10] = 1;
+      matrix[15] = 1;
+      if (command.opcode == eSET_TRANSFORMATION)
+      {
+        transformation.Set(matrix);
+      }
+      else
+      {
+        transformation.Multiply(matrix);
+      }
+      UpdatePixelTransformation();
+      break;
+    }
+    case eTRANSLATE:
+      transformation.Translate(values.Get<double>(0), values.Get<double>(1), 0);
+      UpdatePixelTransformation();
+      break;
+    case eROTATE:
+      transformation.Rotate(0, 0, values.Get<double>(0));
+      UpdatePixelTransformation();
+      break;
+    case eSCALE:
+      transformation.Scale(values.Get<double>(0), values.Get<double>(1), 1);
+      UpdatePixelTransformation();
+      break;
+    case eRESET_TRANSFORMATION:
+      transformation.SetIdentity();
+      UpdatePixelTransformation();
+      break;
+    case eSET_COLOR:
+    case eSET_EDGE_COLOR:
+    case eSET_FILL_COLOR:
+    {
+      uint32_t color = PackColor(values.Get<uint8_t>(0), values.Get<uint8_t>(1), values.Get<uint8_t>(2), 255);
+      if (command.opcode != eSET_FILL_COLOR)
+      {
+        edge_color = color;
+      }
+      if (command.opcode != eSET_EDGE_COLOR)
+      {
+        fill_color = color;
+      }
+      break;
+    }
+    case eSET_FILL:
+      fill = values.Get<uint8_t>(0) != 0;
+      break;
+    case eSET_ALPHA:
+      alpha = values.Get<uint8_t>(0);
+      break;
+    case eDRAW_POINT:
+    {
+      const double* m = pixel_transformation;
+      double x = m[0] * values.Get<double>(0) + m[2] * values.Get<double>(1) + m[4];
+      double y = m[1] * values.Get<double>(0) + m[3] * values.Get<double>(1) + m[5];
+      AddPixelVertex(x - cPOINT_SIZE / 2, y - cPOINT_SIZE / 2);
+      AddPixelVertex(x + cPOINT_SIZE / 2, y - cPOINT_SIZE / 2);
+      AddPixelVertex(x + cPOINT_SIZE / 2, y + cPOINT_SIZE / 2);
+      AddPixelVertex(x - cPOINT_SIZE / 2, y + cPOINT_SIZE / 2);
+      AddPrimitive(eFILL, edge_color, first_vertex);
+      break;
+    }
+    case eDRAW_LINE:
+    {
+      // Infinite line: clipped to image (Liang-Barsky)
+      AddVertex(values.Get<double>(0), values.Get<double>(1));
+      if (measure)
+      {
+        break;
+      }
+      const double* m = pixel_transformation;
+      double point[2] = { vertices[first_vertex * 2], vertices[first_vertex * 2 + 1] };
+      double direction[2] = { m[0] * values.Get<double>(2) + m[2] * values.Get<double>(3), m[1] * values.Get<double>(2) + m[3] * values.Get<double>(3) };
+      vertices.resize(first_vertex * 2);
+      double t_min = -std::numeric_limits<double>::infinity(), t_max = std::numeric_limits<double>::infinity();
+      double limits[2] = { image_width, image_height };
+      for (size_t i = 0; i < 2; i++)
+      {
+        if (direction[i] == 0)
+        {
+          continue;
+        }
+        double t1 = (-1 - point[i]) / direction[i], t2 = (limits[i] + 1 - point[i]) / direction[i];
+        t_min = std::max(t_min, std::min(t1, t2));
+        t_max = std::min(t_max, std::max(t1, t2));
+      }
+      if ((direction[0] != 0 || direction[1] != 0) && t_min < t_max)
+      {
+        AddPixelVertex(point[0] + t_min * direction[0], point[1] + t_min * direction[1]);
+        AddPixelVertex(point[0] + t_max * direction[0], point[1] + t_max * direction[1]);
+        AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      }
+      break;
+    }
+    case eDRAW_LINE_SEGMENT:
+      AddVertex(values.Get<double>(0), values.Get<double>(1));
+      AddVertex(values.Get<double>(2), values.Get<double>(3));
+      AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      break;
+    case eDRAW_LINE_STRIP:
+    case eDRAW_LINE_STRIP_LONG:
+      for (size_t i = 0; i < command.count; i++)
+      {
+        AddVertex(values.Get<double>(i * 2), values.Get<double>(i * 2 + 1));
+      }
+      AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      break;
+    case eDRAW_ARROW:
+    {
+      AddVertex(values.Get<double>(0), values.Get<double>(1));
+      AddVertex(values.Get<double>(2), values.Get<double>(3));
+      AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      const float* line = &vertices[first_vertex * 2];
+      double dx = line[2] - line[0], dy = line[3] - line[1];
+      double length = std::hypot(dx, dy);
+      if (command.flag || measure || length == 0)
+      {
+        break;
+      }
+      double head = std::min(cARROW_HEAD_SIZE, length / 2) / length;
+      double tip[2] = { line[2], line[3] };
+      size_t head_first_vertex = vertices.size() / 2;
+      AddPixelVertex(tip[0] - head * (dx + dy / 2), tip[1] - head * (dy - dx / 2));
+      AddPixelVertex(tip[0], tip[1]);
+      AddPixelVertex(tip[0] - head * (dx - dy / 2), tip[1] - head * (dy + dx / 2));
+      AddPrimitive(eSTROKE_OPEN, edge_color, head_first_vertex);
+      break;
+    }
+    case eDRAW_BOX:
+    {
+      double x = values.Get<double>(0), y = values.Get<double>(1), width = values.Get<double>(2), height = values.Get<double>(3);
+      if (height == -1)
+      {
+        height = width;
+      }
+      AddVertex(x, y);
+      AddVertex(x + width, y);
+      AddVertex(x + width, y + height);
+      AddVertex(x, y + height);
+      AddOutline(first_vertex);
+      break;
+    }
+    case eDRAW_ELLIPSOID:
+      AddEllipse(values.Get<double>(0), values.Get<double>(1), values.Get<double>(2), values.Get<double>(3));
+      AddOutline(first_vertex);
+      break;
+    case eDRAW_BEZIER_CURVE:
+      AddBezierCurve(values, command.count);
+      AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      break;
+    case eDRAW_POLYGON:
+    case eDRAW_POLYGON_LONG:
+      for (size_t i = 0; i < command.count; i++)
+      {
+        AddVertex(values.Get<double>(i * 2), values.Get<double>(i * 2 + 1));
+      }
+      AddOutline(first_vertex);
+      break;
+    case eDRAW_SPLINE:
+    case eDRAW_SPLINE_LONG:
+      if (command.count)
+      {
+        AddSpline(values, command.count, command.tension);
+        AddPrimitive(eSTROKE_OPEN, edge_color, first_vertex);
+      }
+      break;
+    case ePATH_START:
+      AddVertex(values.Get<double>(0), values.Get<double>(1));
+      path_first_vertex = first_vertex;
+      path_shape = command.flag;
+      in_path = true;
+      break;
+    case ePATH_LINE:
+      if (in_path)
+      {
+        AddVertex(values.Get<double>(0), values.Get<double>(1));
+      }
+      break;
+    case ePATH_QUADRATIC_BEZIER_CURVE:
+    case ePATH_CUBIC_BEZIER_CURVE:
+      if (in_path)
+      {
+        // Quadratic curves are converted to cubic ones (control points at 2/3 towards quadratic control point)
+        const double* m = pixel_transformation;
+        double points[8] = { vertices[first_vertex * 2 - 2], vertices[first_vertex * 2 - 1] };
+        for (size_t i = 0; i < values.Size() / 2; i++)
+        {
+          double x = values.Get<double>(i * 2), y = values.Get<double>(i * 2 + 1);
+          points[i * 2 + 2] = m[0] * x + m[2] * y + m[4];
+          points[i * 2 + 3] = m[1] * x + m[3] * y + m[5];
+        }
+        if (command.opcode == ePATH_QUADRATIC_BEZIER_CURVE)
+        {
+          points[6] = points[4];
+          points[7] = points[5];
+          for (size_t i = 0; i < 2; i++)
+          {
+            double control = points[2 + i];
+            points[2 + i] = points[i] + 2.0 / 3.0 * (control - points[i]);
+            points[4 + i] = points[6 + i] + 2.0 / 3.0 * (control - points[6 + i]);
+          }
+        }
+        AddCubicBezierCurve(points);
+      }
+      break;
+    case ePATH_END_OPEN:
+    case ePATH_END_CLOSED:
+      if (in_path)
+      {
+        EndPath(command.opcode == ePATH_END_CLOSED);
+      }
+      break;
+    case eDRAW_DELTA_ENCODED_POINTS:
+    {
+      // Decoded points are drawn like the respective primitive
+      decoded_points.resize(command.count * 2);
+      command.DecodeDeltaEncodedPoints(decoded_points.data());
+      tCanvasCommand decoded = command;
+      decoded.opcode = command.primitive;
+      decoded.values = tCanvasValues(reinterpret_cast<const char*>(decoded_points.data()), decoded_points.size(), eDOUBLE);
+      Process(decoded);
+      break;
+    }
+    case eDEFAULT_VIEWPORT:
+      if (!default_viewport_found)
+      {
+        for (size_t i = 0; i < 4; i++)
+        {
+          default_viewport[i] = values.Get<double>(i);
+        }
+        default_viewport_found = true;
+      }
+      break;
+    default:
+      // Text, z and extrusion values, as well as 3D and delta opcodes are not rendered
+      break;
+    }
+  }
+
+  /*!
+   * Combines viewport and canvas transformation
+   */
+  void UpdatePixelTransformation()
+  {
+    const double* v = viewport_transformation;
+    double* p = pixel_transformation;
+    double t[6] = { transformation.Get(0, 0), transformation.Get(1, 0), transformation.Get(0, 1), transformation.Get(1, 1), transformation.Get(0, 3), transformation.Get(1, 3) };
+    p[0] = v[0] * t[0] + v[2] * t[1];
+    p[1] = v[1] * t[0] + v[3] * t[1];
+    p[2] = v[0] * t[2] + v[2] * t[3];
+    p[3] = v[1] * t[2] + v[3] * t[3];
+    p[4] = v[0] * t[4] + v[2] * t[5] + v[4];
+    p[5] = v[1] * t[4] + v[3] * t[5] + v[5];
+  }
+
+  /*! Buffer for control points */
+  std::vector<double> scratch;
+
+  /*! Buffer for points of delta encoded commands */
+  std::vector<double> decoded_points;
+};
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer constructors
+//----------------------------------------------------------------------
+tCanvasRasterizer::tCanvasRasterizer(unsigned int width, unsigned int height, unsigned int thread_count) :
+  width(0),
+  height(0),
+  thread_count(std::max(1u, thread_count)),
+  band_height(16),
+  pixels(),
+  background(PackColor(255, 255, 255, 255)),
+  viewport_set(false),
+  viewport(),
+  primitives(),
+  vertices(),
+  bands()
+{
+  SetSize(width, height);
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer FillPolygon
+//----------------------------------------------------------------------
+void tCanvasRasterizer::FillPolygon(const tPrimitive& primitive, int first_row, int last_row, std::vector<float>& buffer)
+{
+  // Pixels are filled if their centers are inside the polygon (even-odd rule)
+  const float* vertex = &vertices[primitive.first_vertex * 2];
+  const size_t count = primitive.vertex_count;
+  int row_begin = CeilToInt(primitive.bounds[1] - 0.5f, first_row, last_row);
+  int row_end = CeilToInt(primitive.bounds[3] - 0.5f, first_row, last_row);
+  if (row_begin >= row_end)
+  {
+    return;
+  }
+
+  // Collect edges that cross pixel centers in these rows: y min, y max, x at y min, slope dx/dy
+  buffer.resize(count * 5);
+  float* edges = buffer.data();
+  float* crossings = edges + count * 4;
+  size_t edge_count = 0;
+  const float y_first = row_begin + 0.5f, y_last = row_end - 0.5f;
+  const float* previous = vertex + (count - 1) * 2;
+  for (size_t i = 0; i < count; i++)
+  {
+    const float* current = vertex + i * 2;
+    const float* low = previous[1] < current[1] ? previous : current;
+    const float* high = previous[1] < current[1] ? current : previous;
+    previous = current;
+    if (low[1] == high[1] || high[1] <= y_first || low[1] > y_last)
+    {
+      continue;
+    }
+    float* edge = edges + edge_count * 4;
+    edge[0] = low[1];
+    edge[1] = high[1];
+    edge[2] = low[0];
+    edge[3] = (high[0] - low[0]) / (high[1] - low[1]);
+    edge_count++;
+  }
+
+  const int column_limit = static_cast<int>(width);
+  for (int row = row_begin; row < row_end; row++)
+  {
+    const float y = row + 0.5f;
+    size_t crossing_count = 0;
+    for (size_t i = 0; i < edge_count; i++)
+    {
+      const float* edge = edges + i * 4;
+      if (edge[0] <= y && y < edge[1])
+      {
+        crossings[crossing_count++] = edge[2] + (y - edge[0]) * edge[3];
+      }
+    }
+    if (crossing_count == 2)
+    {
+      if (crossings[0] > crossings[1])
+      {
+        std::swap(crossings[0], crossings[1]);
+      }
+    }
+    else
+    {
+      std::sort(crossings, crossings + crossing_count);
+    }
+    uint32_t* pixel_row = &pixels[static_cast<size_t>(row) * width];
+    for (size_t i = 0; i + 1 < crossing_count; i += 2)
+    {
+      int begin = CeilToInt(crossings[i] - 0.5f, 0, column_limit);
+      int end = CeilToInt(crossings[i + 1] - 0.5f, 0, column_limit);
+      if (begin < end)
+      {
+        BlendSpan(pixel_row + begin, end - begin, primitive.color, primitive.alpha);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer Render
+//----------------------------------------------------------------------
+void tCanvasRasterizer::Render(const tCanvas2D& canvas)
+{
+  tCanvasReader reader(canvas);
+
+  // Determine viewport
+  double view[4] = { 0, 0, 1, 1 };
+  if (viewport_set)
+  {
+    std::copy(viewport, viewport + 4, view);
+  }
+  else
+  {
+    const double cIDENTITY[6] = { 1, 0, 0, 1, 0, 0 };
+    tDisplayListBuilder measure(*this, cIDENTITY, true);
+    measure.Replay(reader);
+    reader.Reset();
+    if (measure.default_viewport_found)
+    {
+      std::copy(measure.default_viewport, measure.default_viewport + 4, view);
+    }
+    else if (vertices.size())
+    {
+      float bounds[4] = { vertices[0], vertices[1], vertices[0], vertices[1] };
+      for (size_t i = 2; i < vertices.size(); i += 2)
+      {
+        bounds[0] = std::min(bounds[0], vertices[i]);
+        bounds[1] = std::min(bounds[1], vertices[i + 1]);
+        bounds[2] = std::max(bounds[2], vertices[i]);
+        bounds[3] = std::max(bounds[3], vertices[i + 1]);
+      }
+      double margin = std::max(bounds[2] - bounds[0], bounds[3] - bounds[1]) * 0.05;
+      if (!(margin > 0))
+      {
+        margin = 1;
+      }
+      view[0] = bounds[0] - margin;
+      view[1] = bounds[1] - margin;
+      view[2] = bounds[2] - bounds[0] + 2 * margin;
+      view[3] = bounds[3] - bounds[1] + 2 * margin;
+    }
+  }
+  if (view[3] < 0)
+  {
+    view[3] = view[2] * height / std::max(1u, width);
+  }
+  double scale = std::min(width / view[2], height / view[3]);
+  if (!std::isfinite(scale) || scale <= 0)
+  {
+    scale = 1;
+  }
+  const double viewport_transformation[6] =
+  {
+    scale, 0, 0, -scale,
+    width / 2.0 - scale * (view[0] + view[2] / 2), height / 2.0 + scale * (view[1] + view[3] / 2)
+  };
+
+  // Build display list
+  {
+    tDisplayListBuilder builder(*this, viewport_transformation, false);
+    builder.Replay(reader);
+  }
+  if (reader.IsMalformed())
+  {
+    RRLIB_LOG_PRINT(WARNING, "Canvas contains malformed commands. Rendering commands before them only.");
+  }
+
+  // Sort primitives into bands
+  for (std::vector<uint32_t> & band : bands)
+  {
+    band.clear();
+  }
+  const int band_count = static_cast<int>(bands.size()), rows = static_cast<int>(band_height);
+  for (size_t i = 0; i < primitives.size(); i++)
+  {
+    const float* bounds = primitives[i].bounds;
+    if (!(bounds[0] < width + 1.0f && bounds[2] >= -1.0f && bounds[1] < height + 1.0f && bounds[3] >= -1.0f))
+    {
+      continue;  // also discards primitives with invalid coordinates
+    }
+    int first_band = FloorToInt(bounds[1] - 1, 0, height) / rows;
+    int last_band = std::min(band_count - 1, FloorToInt(bounds[3] + 1, 0, height) / rows);
+    for (int band = first_band; band <= last_band; band++)
+    {
+      bands[band].push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  // Rasterize bands
+  std::atomic<size_t> next_band(0);
+  auto worker = [&]()
+  {
+    std::vector<float> crossings;
+    for (size_t band = next_band++; band < bands.size(); band = next_band++)
+    {
+      RenderBand(band, crossings);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min<size_t>(thread_count, bands.size()); i++)
+  {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread & thread : workers)
+  {
+    thread.join();
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer RenderBand
+//----------------------------------------------------------------------
+void tCanvasRasterizer::RenderBand(size_t band, std::vector<float>& crossings)
+{
+  int first_row = static_cast<int>(band * band_height);
+  int last_row = std::min<int>(first_row + band_height, height);
+  std::fill(pixels.begin() + static_cast<size_t>(first_row) * width, pixels.begin() + static_cast<size_t>(last_row) * width, background);
+  const std::vector<uint32_t>& indices = bands[band];
+  for (size_t i = 0; i < indices.size(); i++)
+  {
+    // Primitives of a band are scattered across the display list: prefetch them (and then their vertices) some iterations ahead
+    if (i + 8 < indices.size())
+    {
+      __builtin_prefetch(&primitives[indices[i + 8]]);
+    }
+    if (i + 4 < indices.size())
+    {
+      __builtin_prefetch(&vertices[primitives[indices[i + 4]].first_vertex * 2]);
+    }
+    const tPrimitive& primitive = primitives[indices[i]];
+    if (primitive.type == eFILL)
+    {
+      FillPolygon(primitive, first_row, last_row, crossings);
+      continue;
+    }
+    const float* vertex = &vertices[primitive.first_vertex * 2];
+    if (primitive.vertex_count == 1)
+    {
+      StrokeLineSegment(vertex[0], vertex[1], vertex[0], vertex[1], primitive.color, primitive.alpha, first_row, last_row);
+    }
+    for (size_t j = 1; j < primitive.vertex_count; j++)
+    {
+      StrokeLineSegment(vertex[j * 2 - 2], vertex[j * 2 - 1], vertex[j * 2], vertex[j * 2 + 1], primitive.color, primitive.alpha, first_row, last_row);
+    }
+    if (primitive.type == eSTROKE_CLOSED && primitive.vertex_count > 2)
+    {
+      size_t last = primitive.vertex_count - 1;
+      StrokeLineSegment(vertex[last * 2], vertex[last * 2 + 1], vertex[0], vertex[1], primitive.color, primitive.alpha, first_row, last_row);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer SetBackground
+//----------------------------------------------------------------------
+void tCanvasRasterizer::SetBackground(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
+{
+  background = PackColor(r, g, b, alpha);
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer SetSize
+//----------------------------------------------------------------------
+void tCanvasRasterizer::SetSize(unsigned int width, unsigned int height)
+{
+  this->width = width;
+  this->height = height;
+  pixels.assign(static_cast<size_t>(width) * height, background);
+  band_height = std::max(16u, std::min(64u, height / (4 * thread_count)));
+  bands.resize((height + band_height - 1) / band_height);
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer SetViewport
+//----------------------------------------------------------------------
+void tCanvasRasterizer::SetViewport(double bottom_left_x, double bottom_left_y, double width, double height)
+{
+  viewport[0] = bottom_left_x;
+  viewport[1] = bottom_left_y;
+  viewport[2] = width;
+  viewport[3] = height;
+  viewport_set = true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasRasterizer StrokeLineSegment
+//----------------------------------------------------------------------
+void tCanvasRasterizer::StrokeLineSegment(float x1, float y1, float x2, float y2, uint32_t color, uint8_t alpha, int first_row, int last_row)
+{
+  // Pixels are set in every row (steep lines) or column (flat lines) whose center is in the segment's range
+  const int column_limit = static_cast<int>(width);
+  float dx = x2 - x1, dy = y2 - y1;
+  if (dx == 0 && dy == 0)
+  {
+    int row = FloorToInt(y1, first_row - 1, last_row);
+    int column = FloorToInt(x1, -1, column_limit);
+    if (row >= first_row && row < last_row && column >= 0 && column < column_limit)
+    {
+      BlendPixel(&pixels[static_cast<size_t>(row) * width + column], color, alpha);
+    }
+  }
+  else if (std::abs(dy) >= std::abs(dx))
+  {
+    float slope = dx / dy;
+    int row_begin = CeilToInt(std::min(y1, y2) - 0.5f, first_row, last_row);
+    int row_end = CeilToInt(std::max(y1, y2) - 0.5f, first_row, last_row);
+    for (int row = row_begin; row < row_end; row++)
+    {
+      int column = FloorToInt(x1 + (row + 0.5f - y1) * slope, -1, column_limit);
+      if (column >= 0 && column < column_limit)
+      {
+        BlendPixel(&pixels[static_cast<size_t>(row) * width + column], color, alpha);
+      }
+    }
+  }
+  else if (dy == 0)
+  {
+    int row = FloorToInt(y1, first_row - 1, last_row);
+    if (row >= first_row && row < last_row)
+    {
+      int column_begin = CeilToInt(std::min(x1, x2) - 0.5f, 0, column_limit);
+      int column_end = CeilToInt(std::max(x1, x2) - 0.5f, 0, column_limit);
+      for (int column = column_begin; column < column_end; column++)
+      {
+        BlendPixel(&pixels[static_cast<size_t>(row) * width + column], color, alpha);
+      }
+    }
+  }
+  else
+  {
+    // Restrict columns to those whose pixels can be in band
+    float slope = dy / dx;
+    float band_x1 = x1 + (first_row - y1) / slope, band_x2 = x1 + (last_row - y1) / slope;
+    float column_min = std::max(std::min(x1, x2), std::min(band_x1, band_x2) - 1);
+    float column_max = std::min(std::max(x1, x2), std::max(band_x1, band_x2) + 1);
+    int column_begin = CeilToInt(column_min - 0.5f, 0, column_limit);
+    int column_end = CeilToInt(column_max - 0.5f, 0, column_limit);
+    for (int column = column_begin; column < column_end; column++)
+    {
+      int row = FloorToInt(y1 + (column + 0.5f - x1) * slope, first_row - 1, last_row);
+      if (row >= first_row && row < last_row)
+      {
+        BlendPixel(&pixels[static_cast<size_t>(row) * width + column], color, alpha);
+      }
+    }
+  }
+}
@@ -0,0 +1,247 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasRasterizer.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasRasterizer
+ *
+ * \b tCanvasRasterizer
+ *
+ * Renders 2D canvases to RGBA images on the CPU (e.g. for thumbnails on headless systems).
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasRasterizer_h__
+#define __rrlib__canvas__tCanvasRasterizer_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Software rasterizer for 2D canvases
+/*!
+ * Replays the commands of a tCanvas2D into an RGBA8 image.
+ *
+ * Supported are all geometry primitives (except text), paths and shapes,
+ * transformations, colors, fill and alpha (blended over what was drawn before).
+ * Curves and ellipses are flattened to polygons. Filled geometry is
+ * filled with the fill color (even-odd rule) - and its edge is drawn with the edge color.
+ * Edges, lines and line strips are one pixel wide and not antialiased.
+ * Points are drawn as small squares.
+ *
+ * Geometry is shown in the viewport set via SetViewport() - or else in the canvas' default viewport.
+ * If the canvas has no default viewport either, the viewport is fitted to the geometry.
+ * The aspect ratio of the viewport is preserved.
+ *
+ * Rendering works in two steps: commands are first converted to a display list in pixel coordinates
+ * and sorted into bands of image rows. Bands are then rasterized independently by the specified
+ * number of threads - each in the order the commands were drawn.
+ * Buffers are kept between calls - so a rasterizer object should be reused.
+ */
+class tCanvasRasterizer
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param width Width of image in pixels
+   * \param height Height of image in pixels
+   * \param thread_count Number of threads to use
+   */
+  tCanvasRasterizer(unsigned int width, unsigned int height, unsigned int thread_count = 1);
+
+  /*!
+   * \return Height of image in pixels
+   */
+  unsigned int GetHeight() const
+  {
+    return height;
+  }
+
+  /*!
+   * \return Image of last call to Render(): RGBA (one byte per channel), top row first, no padding between rows
+   */
+  const uint8_t* GetImage() const
+  {
+    return reinterpret_cast<const uint8_t*>(pixels.data());
+  }
+
+  /*!
+   * \return Width of image in pixels
+   */
+  unsigned int GetWidth() const
+  {
+    return width;
+  }
+
+  /*!
+   * Renders canvas
+   *
+   * \param canvas Canvas to render
+   */
+  void Render(const tCanvas2D& canvas);
+
+  /*!
+   * Uses canvas' default viewport (or fits viewport to geometry) again
+   */
+  void ResetViewport()
+  {
+    viewport_set = false;
+  }
+
+  /*!
+   * \param r Red component of background
+   * \param g Green component of background
+   * \param b Blue component of background
+   * \param alpha Alpha component of background (255 is opaque)
+   */
+  void SetBackground(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha = 255);
+
+  /*!
+   * \param width Width of image in pixels
+   * \param height Height of image in pixels
+   */
+  void SetSize(unsigned int width, unsigned int height);
+
+  /*!
+   * Sets area of canvas that is shown in image
+   *
+   * \param bottom_left_x Left of viewport
+   * \param bottom_left_y Bottom of viewport
+   * \param width Width of viewport
+   * \param height Height of viewport (-1 to derive it from the image's aspect ratio)
+   */
+  void SetViewport(double bottom_left_x, double bottom_left_y, double width, double height = -1);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  class tDisplayListBuilder;
+
+  enum tPrimitiveType
+  {
+    eFILL,
+    eSTROKE_OPEN,
+    eSTROKE_CLOSED
+  };
+
+  /*! Entry in display list */
+  struct tPrimitive
+  {
+    /*! Bounding box in pixel coordinates: x min, y min, x max, y max */
+    float bounds[4];
+
+    /*! Vertices of polygon or polyline */
+    uint32_t first_vertex, vertex_count;
+
+    /*! Color (RGBA bytes as stored in image - alpha is 255) */
+    uint32_t color;
+
+    uint8_t alpha;
+
+    tPrimitiveType type;
+  };
+
+  unsigned int width, height;
+
+  unsigned int thread_count;
+
+  /*! Number of image rows in each band (larger bands are rasterized with less overhead - smaller bands balance load across threads better) */
+  unsigned int band_height;
+
+  /*! Image (one RGBA pixel per element) */
+  std::vector<uint32_t> pixels;
+
+  /*! Background color */
+  uint32_t background;
+
+  /*! Viewport set via SetViewport() (bottom left x, bottom left y, width, height) */
+  bool viewport_set;
+  double viewport[4];
+
+  /*! Display list of current canvas */
+  std::vector<tPrimitive> primitives;
+
+  /*! Vertices of display list (x and y in pixel coordinates) */
+  std::vector<float> vertices;
+
+  /*! Indices of primitives that (possibly) touch each band of rows */
+  std::vector<std::vector<uint32_t>> bands;
+
+  /*!
+   * Fills polygon in rows [first_row, last_row)
+   *
+   * \param buffer Buffer for edges and their intersections with scanline
+   */
+  void FillPolygon(const tPrimitive& primitive, int first_row, int last_row, std::vector<float>& buffer);
+
+  /*!
+   * Rasterizes band with the specified index
+   */
+  void RenderBand(size_t band, std::vector<float>& buffer);
+
+  /*!
+   * Draws line segment from (x1, y1) to (x2, y2) in rows [first_row, last_row)
+   */
+  void StrokeLineSegment(float x1, float y1, float x2, float y2, uint32_t color, uint8_t alpha, int first_row, int last_row);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
@@ -0,0 +1,389 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasReader.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasReader
+ *
+ * \b tCanvasReader
+ *
+ * Decodes the command stream of serialized canvases in place.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasReader_h__
+#define __rrlib__canvas__tCanvasReader_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstring>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//! Values stored in serialized canvas data
+/*!
+ * Refers to a sequence of numbers of the same type inside a canvas buffer.
+ * Nothing is copied: the referenced memory must remain valid while this object is used.
+ * Values are not necessarily aligned - so they are accessed via Get() or CopyTo().
+ */
+class tCanvasValues
+{
+public:
+
+  tCanvasValues() :
+    data(NULL),
+    count(0),
+    number_type(eFLOAT)
+  {}
+
+  tCanvasValues(const char* data, size_t count, tNumberTypeEnum number_type) :
+    data(data),
+    count(count),
+    number_type(number_type)
+  {}
+
+  /*!
+   * \return Size of values in bytes
+   */
+  size_t Bytes() const
+  {
+    return count * GetNumberTypeSize(number_type);
+  }
+
+  /*!
+   * Copies values to the provided buffer - converting them to T if necessary
+   * (plain memcpy if number types match on little endian platforms - eHALF values are converted to float in batches)
+   *
+   * \param destination Buffer with space for at least Size() values
+   */
+  template <typename T>
+  inline void CopyTo(T* destination) const;
+
+  /*!
+   * \param index Index of value
+   * \return Value with the specified index - converted to T
+   */
+  template <typename T>
+  inline T Get(size_t index) const;
+
+  /*!
+   * \return Pointer to first value in buffer
+   */
+  const char* Data() const
+  {
+    return data;
+  }
+
+  /*!
+   * \return Number type of values
+   */
+  tNumberTypeEnum NumberType() const
+  {
+    return number_type;
+  }
+
+  /*!
+   * \return Number of values
+   */
+  size_t Size() const
+  {
+    return count;
+  }
+
+private:
+
+  const char* data;
+  size_t count;
+  tNumberTypeEnum number_type;
+};
+
+//! Single decoded canvas command
+/*!
+ * Filled by tCanvasReader. All pointers point into the canvas buffer.
+ */
+struct tCanvasCommand
+{
+  /*! Opcode of command */
+  tCanvasOpCode opcode;
+
+  /*! Raw bytes of command (including opcode) */
+  const char* begin;
+  const char* end;
+
+  /*!
+   * Numeric payload of command: coordinates, sizes or matrix entries.
+   * Colors, fill flag and alpha are stored as eUINT8 values - the default viewport offset as eINT64 value.
+   * Delta commands: frame number(s) of eDELTA_KEYFRAME and eDELTA_FRAME - first command and command count of eDELTA_COPY (eUINT32 values)
+   * eDRAW_DELTA_ENCODED_POINTS: encoded deltas (eUINT8 values - decode with DecodeDeltaEncodedPoints())
+   */
+  tCanvasValues values;
+
+  /*!
+   * Parameters of encoded commands.
+   * eDRAW_QUANTIZED_POINT_CLOUD: offset vector and quantization step (4 values)
+   * eDRAW_DELTA_ENCODED_POINTS: first point and quantization step (K + 1 values)
+   * eDRAW_POINT_CLOUD_LOD: number of points in each level (eINT32 values)
+   * eDELTA_KEYFRAME and eDELTA_FRAME: default viewport offset (eINT64 value)
+   */
+  tCanvasValues parameters;
+
+  /*! Colors of eDRAW_RGB_POINT_CLOUD commands (eUINT8 values: 3 per point - or 4 if flag is set) */
+  tCanvasValues colors;
+
+  /*! Number of points for line strips, polygons, splines, delta encoded points, bezier curves (degree + 1) and point clouds (all levels of LOD point clouds) */
+  uint32_t count;
+
+  /*! Undirected flag of arrows, shape flag of ePATH_START, 2D flag of text in 3D canvases, alpha flag of RGB point clouds */
+  bool flag;
+
+  /*! Tension parameter of splines */
+  float tension;
+
+  /*! Primitive drawn by eDRAW_DELTA_ENCODED_POINTS commands (eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE) */
+  tCanvasOpCode primitive;
+
+  /*! Null-terminated text of eDRAW_STRING commands (NULL otherwise) */
+  const char* text;
+
+  tCanvasCommand() :
+    opcode(eRESET_TRANSFORMATION),
+    begin(NULL),
+    end(NULL),
+    values(),
+    parameters(),
+    colors(),
+    count(0),
+    flag(false),
+    tension(0),
+    primitive(eDRAW_LINE_STRIP),
+    text(NULL)
+  {}
+
+  /*!
+   * \return Size of command in bytes
+   */
+  size_t Bytes() const
+  {
+    return end - begin;
+  }
+
+  /*!
+   * Decodes point of eDRAW_QUANTIZED_POINT_CLOUD command
+   *
+   * \param index Index of point (< count)
+   * \param coordinate Index of coordinate (0 = x, 1 = y, 2 = z)
+   * \return Decoded coordinate
+   */
+  double GetQuantizedPointCoordinate(size_t index, size_t coordinate) const
+  {
+    return parameters.Get<double>(coordinate) + parameters.Get<double>(3) * values.Get<double>(index * 3 + coordinate);
+  }
+
+  /*!
+   * Decodes points of eDRAW_DELTA_ENCODED_POINTS command
+   *
+   * \param destination Buffer for count * K coordinates (x1, y1, x2, y2, ...)
+   */
+  template <typename T>
+  inline void DecodeDeltaEncodedPoints(T* destination) const;
+
+  /*!
+   * Points of a single level of eDRAW_POINT_CLOUD_LOD command
+   * (computed from level sizes - points of other levels are not touched)
+   *
+   * \param level Index of level (< parameters.Size())
+   * \return Coordinates of points in level
+   */
+  tCanvasValues GetLODLevel(size_t level) const
+  {
+    size_t first = 0;
+    for (size_t i = 0; i < level; i++)
+    {
+      first += parameters.Get<uint32_t>(i);
+    }
+    size_t value_size = GetNumberTypeSize(values.NumberType());
+    return tCanvasValues(values.Data() + first * 3 * value_size, parameters.Get<uint32_t>(level) * 3, values.NumberType());
+  }
+
+  /*!
+   * Points of the coarsest levels of eDRAW_POINT_CLOUD_LOD command
+   * (they are stored contiguously - so this is a thinned version of the complete point cloud)
+   *
+   * \param level_count Number of levels (<= parameters.Size())
+   * \return Coordinates of points in levels 0 to level_count - 1
+   */
+  tCanvasValues GetLODLevels(size_t level_count) const
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < level_count; i++)
+    {
+      count += parameters.Get<uint32_t>(i);
+    }
+    return tCanvasValues(values.Data(), count * 3, values.NumberType());
+  }
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Reads serialized canvases
+/*!
+ * Walks the command stream of a canvas (see tCanvasOpCode) in place.
+ * Commands are decoded into tCanvasCommand objects whose values point
+ * directly into the buffer - so no memory is allocated or copied.
+ *
+ * Usage:
+ *
+ *   tCanvasReader reader(canvas);
+ *   reader.Visit([](const tCanvasCommand & command) { ... });
+ *
+ * The buffer must not be modified while the reader is in use.
+ */
+class tCanvasReader
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param data Serialized canvas data (without leading size)
+   * \param size Size of data in bytes
+   * \param dimension 2 for tCanvas2D and 3 for tCanvas3D data
+   */
+  inline tCanvasReader(const void* data, size_t size, unsigned int dimension);
+
+  inline explicit tCanvasReader(const tCanvas2D& canvas);
+
+  inline explicit tCanvasReader(const tCanvas3D& canvas);
+
+  /*!
+   * \return Dimension of canvas (2 or 3)
+   */
+  unsigned int GetDimension() const
+  {
+    return dimension;
+  }
+
+  /*!
+   * \return Offset of next command in buffer
+   */
+  size_t GetPosition() const
+  {
+    return current - data_begin;
+  }
+
+  /*!
+   * \return Whether an invalid or truncated command was encountered
+   */
+  bool IsMalformed() const
+  {
+    return malformed;
+  }
+
+  /*!
+   * Decodes next command
+   *
+   * \param command Command object to fill
+   * \return False if there are no more commands (or data is malformed)
+   */
+  inline bool Next(tCanvasCommand& command);
+
+  /*!
+   * Restarts reading at beginning of buffer
+   */
+  void Reset()
+  {
+    current = data_begin;
+    malformed = false;
+  }
+
+  /*!
+   * Decodes all remaining commands and passes them to visitor
+   *
+   * \param visitor Function object that is called with each command (const tCanvasCommand&)
+   * \return True if end of data was reached without encountering malformed commands
+   */
+  template <typename TVisitor>
+  inline bool Visit(TVisitor && visitor);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  const char* data_begin;
+  const char* data_end;
+
+  /*! Current read position */
+  const char* current;
+
+  unsigned int dimension;
+
+  bool malformed;
+
+  /*!
+   * Reads number type and the specified number of values
+   */
+  inline bool ReadValues(tCanvasValues& values, size_t count);
+
+  /*!
+   * Reads raw value (little endian) and advances read position
+   */
+  template <typename T>
+  inline bool ReadRaw(T& value);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tCanvasReader.hpp"
+
+#endif
@@ -0,0 +1,518 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasReader.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/internal/delta_encoding.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace internal
+{
+
+/*!
+ * Reads (possibly unaligned) little endian value from buffer
+ */
+template <typename T>
+inline T ReadLittleEndian(const char* data)
+{
+  T result;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  char* bytes = reinterpret_cast<char*>(&result);
+  std::reverse_copy(data, data + sizeof(T), bytes);
+#else
+  std::memcpy(&result, data, sizeof(T));
+#endif
+  return result;
+}
+
+}
+
+//----------------------------------------------------------------------
+// tCanvasValues Get
+//----------------------------------------------------------------------
+template <typename T>
+T tCanvasValues::Get(size_t index) const
+{
+  assert(index < count);
+  const char* element = data + index * GetNumberTypeSize(number_type);
+  switch (number_type)
+  {
+  case eFLOAT:
+    return static_cast<T>(internal::ReadLittleEndian<float>(element));
+  case eDOUBLE:
+    return static_cast<T>(internal::ReadLittleEndian<double>(element));
+  case eINT8:
+    return static_cast<T>(internal::ReadLittleEndian<int8_t>(element));
+  case eUINT8:
+    return static_cast<T>(internal::ReadLittleEndian<uint8_t>(element));
+  case eINT16:
+    return static_cast<T>(internal::ReadLittleEndian<int16_t>(element));
+  case eUINT16:
+    return static_cast<T>(internal::ReadLittleEndian<uint16_t>(element));
+  case eINT32:
+    return static_cast<T>(internal::ReadLittleEndian<int32_t>(element));
+  case eUINT32:
+    return static_cast<T>(internal::ReadLittleEndian<uint32_t>(element));
+  case eINT64:
+    return static_cast<T>(internal::ReadLittleEndian<int64_t>(element));
+  case eUINT64:
+    return static_cast<T>(internal::ReadLittleEndian<uint64_t>(element));
+  case eHALF:
+    return static_cast<T>(internal::HalfToFloat(internal::ReadLittleEndian<uint16_t>(element)));
+  default:
+    return T();
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasValues CopyTo
+//----------------------------------------------------------------------
+template <typename T>
+void tCanvasValues::CopyTo(T* destination) const
+{
+#if __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+  if (number_type == tNumberType<T>::value)
+  {
+    std::memcpy(destination, data, count * sizeof(T));
+    return;
+  }
+  if (number_type == eHALF && std::is_same<T, float>::value)
+  {
+    internal::ConvertFromHalf(data, count, reinterpret_cast<float*>(destination));
+    return;
+  }
+#endif
+  for (size_t i = 0; i < count; i++)
+  {
+    destination[i] = Get<T>(i);
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasCommand DecodeDeltaEncodedPoints
+//----------------------------------------------------------------------
+template <typename T>
+void tCanvasCommand::DecodeDeltaEncodedPoints(T* destination) const
+{
+  assert(opcode == eDRAW_DELTA_ENCODED_POINTS && parameters.Size() >= 3 && parameters.Size() <= 4);
+  if (count == 0)
+  {
+    return;
+  }
+  const size_t K = parameters.Size() - 1;
+  double origin[3];
+  for (size_t i = 0; i < K; i++)
+  {
+    origin[i] = parameters.Get<double>(i);
+  }
+
+  // The reader checked that values contain (count - 1) * K terminated varints
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(values.Data());
+  if (K == 2)
+  {
+    internal::DecodeDeltaEncodedPoints<2>(data, origin, parameters.Get<double>(K), count, destination);
+  }
+  else
+  {
+    internal::DecodeDeltaEncodedPoints<3>(data, origin, parameters.Get<double>(K), count, destination);
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasReader constructors
+//----------------------------------------------------------------------
+tCanvasReader::tCanvasReader(const void* data, size_t size, unsigned int dimension) :
+  data_begin(static_cast<const char*>(data)),
+  data_end(static_cast<const char*>(data) + size),
+  current(data_begin),
+  dimension(dimension),
+  malformed(false)
+{
+  assert(dimension == 2 || dimension == 3);
+}
+
+tCanvasReader::tCanvasReader(const tCanvas2D& canvas) :
+  tCanvasReader(canvas.buffer->GetBufferPointer(0), canvas.stream->GetPosition(), 2)
+{}
+
+tCanvasReader::tCanvasReader(const tCanvas3D& canvas) :
+  tCanvasReader(canvas.buffer->GetBufferPointer(0), canvas.stream->GetPosition(), 3)
+{}
+
+//----------------------------------------------------------------------
+// tCanvasReader ReadRaw
+//----------------------------------------------------------------------
+template <typename T>
+bool tCanvasReader::ReadRaw(T& value)
+{
+  if (static_cast<size_t>(data_end - current) < sizeof(T))
+  {
+    return false;
+  }
+  value = internal::ReadLittleEndian<T>(current);
+  current += sizeof(T);
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasReader ReadValues
+//----------------------------------------------------------------------
+bool tCanvasReader::ReadValues(tCanvasValues& values, size_t count)
+{
+  uint8_t number_type = 0;
+  if (!ReadRaw(number_type) || number_type > eHALF)
+  {
+    return false;
+  }
+  tNumberTypeEnum type = static_cast<tNumberTypeEnum>(number_type);
+  size_t bytes = count * GetNumberTypeSize(type);
+  if (static_cast<size_t>(data_end - current) < bytes)
+  {
+    return false;
+  }
+  values = tCanvasValues(current, count, type);
+  current += bytes;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasReader Next
+//----------------------------------------------------------------------
+bool tCanvasReader::Next(tCanvasCommand& command)
+{
+  if (current >= data_end || malformed)
+  {
+    return false;
+  }
+
+  const size_t K = dimension;
+  const char* command_begin = current;
+  uint8_t opcode = *current;
+  current++;
+  command = tCanvasCommand();
+  command.opcode = static_cast<tCanvasOpCode>(opcode);
+  command.begin = command_begin;
+
+  bool ok = true;
+  switch (command.opcode)
+  {
+  case eSET_TRANSFORMATION:
+  case eTRANSFORM:
+    ok = ReadValues(command.values, K == 2 ? 6 : 16);
+    break;
+  case eTRANSLATE:
+  case eSCALE:
+  case eDRAW_POINT:
+  case ePATH_LINE:
+    ok = ReadValues(command.values, K);
+    break;
+  case eROTATE:
+    ok = ReadValues(command.values, K == 2 ? 1 : 3);
+    break;
+  case eRESET_TRANSFORMATION:
+  case ePATH_END_OPEN:
+  case ePATH_END_CLOSED:
+    break;
+  case eSET_COLOR:
+  case eSET_EDGE_COLOR:
+  case eSET_FILL_COLOR:
+    ok = static_cast<size_t>(data_end - current) >= 3;
+    command.values = tCanvasValues(current, 3, eUINT8);
+    current += ok ? 3 : 0;
+    break;
+  case eSET_FILL:
+  case eSET_ALPHA:
+    ok = current < data_end;
+    command.values = tCanvasValues(current, 1, eUINT8);
+    current += ok ? 1 : 0;
+    break;
+  case eDRAW_LINE:
+  case eDRAW_LINE_SEGMENT:
+  case eDRAW_BOX:
+  case eDRAW_ELLIPSOID:
+  case ePATH_QUADRATIC_BEZIER_CURVE:
+    ok = ReadValues(command.values, 2 * K);
+    break;
+  case ePATH_CUBIC_BEZIER_CURVE:
+    ok = ReadValues(command.values, 3 * K);
+    break;
+  case eDRAW_LINE_STRIP:
+    if (K == 2)
+    {
+      uint16_t count = 0;
+      ok = ReadRaw(count);
+      command.count = count;
+    }
+    else
+    {
+      int32_t count = 0;
+      ok = ReadRaw(count) && count >= 0;
+      command.count = count;
+    }
+    ok = ok && ReadValues(command.values, command.count * K);
+    break;
+  case eDRAW_POLYGON:
+  {
+    uint16_t count = 0;
+    ok = ReadRaw(count);
+    command.count = count;
+    ok = ok && ReadValues(command.values, command.count * K);
+    break;
+  }
+  case eDRAW_BEZIER_CURVE:
+  {
+    uint16_t degree = 0;
+    ok = ReadRaw(degree);
+    command.count = degree + 1u;
+    ok = ok && ReadValues(command.values, command.count * K);
+    break;
+  }
+  case eDRAW_SPLINE:
+  {
+    uint16_t count = 0;
+    ok = ReadRaw(command.tension) && ReadRaw(count);
+    command.count = count;
+    ok = ok && ReadValues(command.values, command.count * K);
+    break;
+  }
+  case eDRAW_LINE_STRIP_LONG:
+  case eDRAW_POLYGON_LONG:
+  case eDRAW_SPLINE_LONG:
+    ok = K == 2 && (command.opcode != eDRAW_SPLINE_LONG || ReadRaw(command.tension)) && ReadRaw(command.count);
+    ok = ok && ReadValues(command.values, static_cast<size_t>(command.count) * K);
+    break;
+  case eDRAW_ARROW:
+  {
+    uint8_t undirected = 0;
+    ok = ReadRaw(undirected);
+    command.flag = undirected;
+    ok = ok && ReadValues(command.values, 2 * K);
+    break;
+  }
+  case eDRAW_STRING:
+  {
+    size_t value_count = 2;
+    if (K == 3)
+    {
+      uint8_t two_d = 0;
+      ok = ReadRaw(two_d);
+      command.flag = two_d;
+      value_count = two_d ? 2 : 3;
+    }
+    ok = ok && ReadValues(command.values, value_count);
+    const char* terminator = ok ? static_cast<const char*>(std::memchr(current, 0, data_end - current)) : NULL;
+    ok = ok && terminator;
+    if (ok)
+    {
+      command.text = current;
+      current = terminator + 1;
+    }
+    break;
+  }
+  case ePATH_START:
+  {
+    uint8_t shape = 0;
+    ok = ReadValues(command.values, K) && ReadRaw(shape);
+    command.flag = shape;
+    break;
+  }
+  case eSET_Z:
+  case eSET_EXTRUSION:
+    ok = ReadValues(command.values, 1);
+    break;
+  case eDRAW_COLORED_POINT_CLOUD:
+  case eDRAW_POINT_CLOUD:
+  {
+    int32_t count = 0;
+    ok = ReadRaw(count) && count >= 0;
+    command.count = count;
+    ok = ok && ReadValues(command.values, command.count * (command.opcode == eDRAW_COLORED_POINT_CLOUD ? 6 : K));
+    break;
+  }
+  case eDRAW_QUANTIZED_POINT_CLOUD:
+  {
+    int32_t count = 0;
+    ok = ReadRaw(count) && count >= 0;
+    command.count = count;
+    ok = ok && ReadValues(command.parameters, 4) && ReadValues(command.values, command.count * 3);
+    break;
+  }
+  case eDRAW_RGB_POINT_CLOUD:
+  {
+    int32_t count = 0;
+    uint8_t alpha = 0;
+    ok = ReadRaw(count) && count >= 0 && ReadRaw(alpha);
+    command.count = count;
+    command.flag = alpha;
+    ok = ok && ReadValues(command.values, command.count * 3);
+    size_t color_bytes = command.count * (alpha ? 4 : 3);
+    ok = ok && static_cast<size_t>(data_end - current) >= color_bytes;
+    if (ok)
+    {
+      command.colors = tCanvasValues(current, color_bytes, eUINT8);
+      current += color_bytes;
+    }
+    break;
+  }
+  case eDRAW_POINT_CLOUD_LOD:
+  {
+    int32_t level_count = 0;
+    ok = ReadRaw(level_count) && level_count >= 0 && static_cast<size_t>(data_end - current) / 4 >= static_cast<size_t>(level_count);
+    if (ok)
+    {
+      command.parameters = tCanvasValues(current, level_count, eINT32);
+      current += level_count * 4;
+      uint64_t count = 0;
+      for (int32_t i = 0; i < level_count; i++)
+      {
+        int32_t level_size = command.parameters.Get<int32_t>(i);
+        ok = ok && level_size >= 0;
+        count += level_size;
+      }
+      ok = ok && count <= std::numeric_limits<uint32_t>::max();
+      command.count = static_cast<uint32_t>(count);
+    }
+    ok = ok && ReadValues(command.values, static_cast<size_t>(command.count) * 3);
+    break;
+  }
+  case eDRAW_DELTA_ENCODED_POINTS:
+  {
+    uint8_t primitive = 0;
+    ok = ReadRaw(primitive) && (primitive == eDRAW_LINE_STRIP || primitive == eDRAW_POLYGON || primitive == eDRAW_SPLINE) && ReadRaw(command.count);
+    command.primitive = static_cast<tCanvasOpCode>(primitive);
+    ok = ok && (command.primitive != eDRAW_SPLINE || ReadRaw(command.tension)) && ReadValues(command.parameters, K + 1);
+    if (ok)
+    {
+      // One varint per coordinate of all points but the first (the last byte of each varint is < 0x80)
+      uint64_t varints = command.count ? (command.count - 1ull) * K : 0;
+      const char* end = current;
+      while (varints && end < data_end)
+      {
+        varints -= static_cast<uint8_t>(*end) < 0x80;
+        end++;
+      }
+      ok = varints == 0;
+      command.values = tCanvasValues(current, end - current, eUINT8);
+      current = end;
+    }
+    break;
+  }
+  case eDELTA_KEYFRAME:
+  case eDELTA_FRAME:
+  {
+    size_t frame_numbers = command.opcode == eDELTA_FRAME ? 2 : 1;
+    ok = static_cast<size_t>(data_end - current) >= frame_numbers * 4 + 8;
+    if (ok)
+    {
+      command.values = tCanvasValues(current, frame_numbers, eUINT32);
+      current += frame_numbers * 4;
+      command.parameters = tCanvasValues(current, 1, eINT64);
+      current += 8;
+    }
+    break;
+  }
+  case eDELTA_COPY:
+    ok = static_cast<size_t>(data_end - current) >= 8;
+    command.values = tCanvasValues(current, 2, eUINT32);
+    current += ok ? 8 : 0;
+    break;
+  case eDEFAULT_VIEWPORT:
+    ok = ReadValues(command.values, 4);
+    break;
+  case eDEFAULT_VIEWPORT_OFFSET:
+    ok = static_cast<size_t>(data_end - current) >= 8;
+    command.values = tCanvasValues(current, 1, eINT64);
+    current += ok ? 8 : 0;
+    break;
+  default:
+    ok = false;
+    break;
+  }
+
+  if (!ok)
+  {
+    malformed = true;
+    current = data_end;
+    return false;
+  }
+  command.end = current;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasReader Visit
+//----------------------------------------------------------------------
+template <typename TVisitor>
+bool tCanvasReader::Visit(TVisitor && visitor)
+{
+  tCanvasCommand command;
+  while (Next(command))
+  {
+    visitor(static_cast<const tCanvasCommand&>(command));
+  }
+  return !malformed;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,488 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasRecording.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasRecording.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+static const char cFILE_MAGIC[8] = { 'R', 'R', 'C', 'A', 'N', 'R', 'E', 'C' };
+static const char cINDEX_MAGIC[8] = { 'R', 'R', 'C', 'A', 'N', 'I', 'D', 'X' };
+static const uint32_t cFORMAT_VERSION = 1;
+
+static const size_t cFILE_HEADER_SIZE = 16;
+static const size_t cFRAME_HEADER_SIZE = 16;
+static const size_t cINDEX_ENTRY_SIZE = 24;
+static const size_t cTRAILER_SIZE = 24;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*!
+ * Writes little endian value to (possibly unaligned) buffer
+ */
+template <typename T>
+inline void WriteLittleEndian(char* data, T value)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  std::reverse_copy(bytes, bytes + sizeof(T), data);
+#else
+  std::memcpy(data, &value, sizeof(T));
+#endif
+}
+
+int64_t ToNanoseconds(tCanvasTimestamp timestamp)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+}
+
+tCanvasTimestamp FromNanoseconds(int64_t nanoseconds)
+{
+  return tCanvasTimestamp(std::chrono::duration_cast<tCanvasTimestamp::duration>(std::chrono::nanoseconds(nanoseconds)));
+}
+
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder constructors
+//----------------------------------------------------------------------
+tCanvasRecorder::tCanvasRecorder() :
+  file_descriptor(-1),
+  file_name(),
+  dimension(0),
+  file_size(0),
+  index(),
+  last_timestamp(0)
+{}
+
+tCanvasRecorder::~tCanvasRecorder()
+{
+  Close();
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder Close
+//----------------------------------------------------------------------
+bool tCanvasRecorder::Close()
+{
+  if (file_descriptor < 0)
+  {
+    return true;
+  }
+  char trailer[cTRAILER_SIZE];
+  WriteLittleEndian<uint64_t>(trailer, file_size);
+  WriteLittleEndian<uint64_t>(trailer + 8, index.size() / cINDEX_ENTRY_SIZE);
+  std::memcpy(trailer + 16, cINDEX_MAGIC, 8);
+  bool success = Write(index.data(), index.size()) && Write(trailer, cTRAILER_SIZE);
+  if (::close(file_descriptor) != 0 && success)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Closing '", file_name, "' failed: ", std::strerror(errno));
+    success = false;
+  }
+  file_descriptor = -1;
+  index.clear();
+  return success;
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder GetFrameCount
+//----------------------------------------------------------------------
+size_t tCanvasRecorder::GetFrameCount() const
+{
+  return index.size() / cINDEX_ENTRY_SIZE;
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder Open
+//----------------------------------------------------------------------
+bool tCanvasRecorder::Open(const std::string& file_name, unsigned int dimension)
+{
+  Close();
+  if (dimension != 2 && dimension != 3)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Invalid dimension ", dimension, ". Must be 2 or 3.");
+    return false;
+  }
+  file_descriptor = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (file_descriptor < 0)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Could not create '", file_name, "': ", std::strerror(errno));
+    return false;
+  }
+  this->file_name = file_name;
+  this->dimension = dimension;
+  file_size = 0;
+  last_timestamp = std::numeric_limits<int64_t>::min();
+
+  char header[cFILE_HEADER_SIZE] = { 0 };
+  std::memcpy(header, cFILE_MAGIC, 8);
+  WriteLittleEndian<uint32_t>(header + 8, cFORMAT_VERSION);
+  header[12] = static_cast<char>(dimension);
+  if (!Write(header, cFILE_HEADER_SIZE))
+  {
+    ::close(file_descriptor);
+    file_descriptor = -1;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder Record
+//----------------------------------------------------------------------
+bool tCanvasRecorder::Record(const tCanvas2D& canvas, tCanvasTimestamp timestamp)
+{
+  return Record(canvas, 2, timestamp);
+}
+
+bool tCanvasRecorder::Record(const tCanvas3D& canvas, tCanvasTimestamp timestamp)
+{
+  return Record(canvas, 3, timestamp);
+}
+
+bool tCanvasRecorder::Record(const tCanvas& canvas, unsigned int dimension, tCanvasTimestamp timestamp)
+{
+  if (file_descriptor < 0)
+  {
+    RRLIB_LOG_PRINT(ERROR, "No file is open. Canvas is not recorded.");
+    return false;
+  }
+  if (dimension != this->dimension)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Recording contains ", this->dimension, "D canvases. Cannot record ", dimension, "D canvas.");
+    return false;
+  }
+  int64_t nanoseconds = ToNanoseconds(timestamp);
+  if (nanoseconds < last_timestamp)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Timestamp is before timestamp of previous frame. Canvas is not recorded.");
+    return false;
+  }
+
+  // Canvas data as written by operator << (with default viewport offset as first command - if set)
+  const char* data = canvas.buffer->GetBufferPointer(0);
+  size_t size = canvas.stream->GetPosition();
+  char header[cFRAME_HEADER_SIZE + 9];
+  size_t header_size = cFRAME_HEADER_SIZE;
+  if (canvas.default_viewport_offset)
+  {
+    if (size && *data == static_cast<char>(eDEFAULT_VIEWPORT_OFFSET))
+    {
+      data += 9;
+      size -= 9;
+    }
+    header[header_size] = static_cast<char>(eDEFAULT_VIEWPORT_OFFSET);
+    WriteLittleEndian<int64_t>(header + header_size + 1, canvas.default_viewport_offset);
+    header_size += 9;
+  }
+  const uint64_t frame_size = size + header_size - cFRAME_HEADER_SIZE;
+  WriteLittleEndian<int64_t>(header, nanoseconds);
+  WriteLittleEndian<uint64_t>(header + 8, frame_size);
+
+  const uint64_t frame_start = file_size;
+  const uint64_t frame_offset = file_size + cFRAME_HEADER_SIZE;
+  if (!(Write(header, header_size) && Write(data, size)))
+  {
+    // Remove partial frame - otherwise index reconstruction would stop at it (and drop all subsequent frames)
+    if (::ftruncate(file_descriptor, frame_start) == 0 && ::lseek(file_descriptor, frame_start, SEEK_SET) == static_cast<off_t>(frame_start))
+    {
+      file_size = frame_start;
+    }
+    else
+    {
+      RRLIB_LOG_PRINT(ERROR, "Could not remove partial frame from '", file_name, "': ", std::strerror(errno), ". Closing recording.");
+      Close();
+    }
+    return false;
+  }
+  char entry[cINDEX_ENTRY_SIZE];
+  WriteLittleEndian<int64_t>(entry, nanoseconds);
+  WriteLittleEndian<uint64_t>(entry + 8, frame_offset);
+  WriteLittleEndian<uint64_t>(entry + 16, frame_size);
+  index.insert(index.end(), entry, entry + cINDEX_ENTRY_SIZE);
+  last_timestamp = nanoseconds;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasRecorder Write
+//----------------------------------------------------------------------
+bool tCanvasRecorder::Write(const void* data, size_t size)
+{
+  const char* remaining = static_cast<const char*>(data);
+  while (size)
+  {
+    ssize_t written = ::write(file_descriptor, remaining, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      RRLIB_LOG_PRINT(ERROR, "Writing to '", file_name, "' failed: ", std::strerror(errno));
+      return false;
+    }
+    remaining += written;
+    size -= written;
+    file_size += written;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer constructors
+//----------------------------------------------------------------------
+tCanvasPlayer::tCanvasPlayer() :
+  mapping(NULL),
+  mapping_size(0),
+  dimension(0),
+  frame_count(0),
+  index(NULL),
+  reconstructed_index()
+{}
+
+tCanvasPlayer::~tCanvasPlayer()
+{
+  Close();
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer Close
+//----------------------------------------------------------------------
+void tCanvasPlayer::Close()
+{
+  if (mapping)
+  {
+    ::munmap(const_cast<char*>(mapping), mapping_size);
+  }
+  mapping = NULL;
+  mapping_size = 0;
+  frame_count = 0;
+  index = NULL;
+  reconstructed_index.clear();
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer FindFrame
+//----------------------------------------------------------------------
+size_t tCanvasPlayer::FindFrame(tCanvasTimestamp timestamp) const
+{
+  // Binary search for first frame recorded after timestamp
+  const int64_t nanoseconds = ToNanoseconds(timestamp);
+  size_t first = 0, count = frame_count;
+  while (count)
+  {
+    size_t step = count / 2;
+    if (internal::ReadLittleEndian<int64_t>(index + (first + step) * cINDEX_ENTRY_SIZE) <= nanoseconds)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+  return first ? first - 1 : 0;
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer GetFrame
+//----------------------------------------------------------------------
+tCanvasPlayer::tFrame tCanvasPlayer::GetFrame(size_t frame_index) const
+{
+  assert(frame_index < frame_count);
+  const char* entry = index + frame_index * cINDEX_ENTRY_SIZE;
+  tFrame frame;
+  frame.timestamp = FromNanoseconds(internal::ReadLittleEndian<int64_t>(entry));
+  frame.data = mapping + internal::ReadLittleEndian<uint64_t>(entry + 8);
+  frame.size = internal::ReadLittleEndian<uint64_t>(entry + 16);
+  return frame;
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer Load
+//----------------------------------------------------------------------
+bool tCanvasPlayer::Load(size_t frame_index, tCanvas2D& canvas) const
+{
+  return Load(frame_index, canvas, 2);
+}
+
+bool tCanvasPlayer::Load(size_t frame_index, tCanvas3D& canvas) const
+{
+  return Load(frame_index, canvas, 3);
+}
+
+bool tCanvasPlayer::Load(size_t frame_index, tCanvas& canvas, unsigned int dimension) const
+{
+  if (frame_index >= frame_count)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Frame ", frame_index, " does not exist (recording has ", frame_count, " frames).");
+    return false;
+  }
+  if (dimension != this->dimension)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Recording contains ", this->dimension, "D canvases. Cannot load frame into ", dimension, "D canvas.");
+    return false;
+  }
+  tFrame frame = GetFrame(frame_index);
+  canvas.Clear();
+  canvas.Reserve(frame.size);
+  canvas.stream->Write(frame.data, frame.size);
+  canvas.ResetAfterLoad();
+  return true;
+}
+
+//----------------------------------------------------------------------
+// tCanvasPlayer Open
+//----------------------------------------------------------------------
+bool tCanvasPlayer::Open(const std::string& file_name)
+{
+  Close();
+  int file_descriptor = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_descriptor < 0)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Could not open '", file_name, "': ", std::strerror(errno));
+    return false;
+  }
+  struct stat file_status;
+  if (::fstat(file_descriptor, &file_status) != 0 || static_cast<size_t>(file_status.st_size) < cFILE_HEADER_SIZE)
+  {
+    RRLIB_LOG_PRINT(ERROR, "'", file_name, "' is not a canvas recording.");
+    ::close(file_descriptor);
+    return false;
+  }
+  mapping_size = file_status.st_size;
+  void* address = ::mmap(NULL, mapping_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  ::close(file_descriptor);  // mapping remains valid
+  if (address == MAP_FAILED)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Could not map '", file_name, "' into memory: ", std::strerror(errno));
+    mapping_size = 0;
+    return false;
+  }
+  mapping = static_cast<const char*>(address);
+
+  // Check header
+  const uint32_t version = internal::ReadLittleEndian<uint32_t>(mapping + 8);
+  dimension = static_cast<uint8_t>(mapping[12]);
+  if (std::memcmp(mapping, cFILE_MAGIC, 8) != 0 || version != cFORMAT_VERSION || (dimension != 2 && dimension != 3))
+  {
+    RRLIB_LOG_PRINT(ERROR, "'", file_name, "' is not a canvas recording (or has an unsupported format version).");
+    Close();
+    return false;
+  }
+
+  // Use index from trailer - if it is consistent
+  const char* end = mapping + mapping_size;
+  if (mapping_size >= cFILE_HEADER_SIZE + cTRAILER_SIZE && std::memcmp(end - 8, cINDEX_MAGIC, 8) == 0)
+  {
+    uint64_t index_offset = internal::ReadLittleEndian<uint64_t>(end - cTRAILER_SIZE);
+    uint64_t count = internal::ReadLittleEndian<uint64_t>(end - cTRAILER_SIZE + 8);
+    bool valid = index_offset >= cFILE_HEADER_SIZE && index_offset <= mapping_size && count <= (mapping_size - index_offset) / cINDEX_ENTRY_SIZE &&
+                 index_offset + count * cINDEX_ENTRY_SIZE + cTRAILER_SIZE == mapping_size;
+    int64_t previous_timestamp = std::numeric_limits<int64_t>::min();
+    for (uint64_t i = 0; valid && i < count; i++)
+    {
+      const char* entry = mapping + index_offset + i * cINDEX_ENTRY_SIZE;
+      int64_t timestamp = internal::ReadLittleEndian<int64_t>(entry);
+      uint64_t offset = internal::ReadLittleEndian<uint64_t>(entry + 8), size = internal::ReadLittleEndian<uint64_t>(entry + 16);
+      valid = timestamp >= previous_timestamp && offset >= cFILE_HEADER_SIZE + cFRAME_HEADER_SIZE && offset <= index_offset && size <= index_offset - offset;
+      previous_timestamp = timestamp;
+    }
+    if (valid)
+    {
+      index = mapping + index_offset;
+      frame_count = count;
+      return true;
+    }
+  }
+
+  // Reconstruct index from frame headers (recording was not closed properly)
+  RRLIB_LOG_PRINT(WARNING, "'", file_name, "' has no valid frame index. Reconstructing it from frames.");
+  const char* frame_header = mapping + cFILE_HEADER_SIZE;
+  int64_t previous_timestamp = std::numeric_limits<int64_t>::min();
+  while (static_cast<size_t>(end - frame_header) >= cFRAME_HEADER_SIZE)
+  {
+    int64_t timestamp = internal::ReadLittleEndian<int64_t>(frame_header);
+    uint64_t size = internal::ReadLittleEndian<uint64_t>(frame_header + 8);
+    if (timestamp < previous_timestamp || size > static_cast<size_t>(end - frame_header) - cFRAME_HEADER_SIZE)
+    {
+      RRLIB_LOG_PRINT(WARNING, "Ignoring incomplete or invalid data at end of '", file_name, "'.");
+      break;
+    }
+    char entry[cINDEX_ENTRY_SIZE];
+    WriteLittleEndian<int64_t>(entry, timestamp);
+    WriteLittleEndian<uint64_t>(entry + 8, frame_header + cFRAME_HEADER_SIZE - mapping);
+    WriteLittleEndian<uint64_t>(entry + 16, size);
+    reconstructed_index.insert(reconstructed_index.end(), entry, entry + cINDEX_ENTRY_SIZE);
+    previous_timestamp = timestamp;
+    frame_header += cFRAME_HEADER_SIZE + size;
+  }
+  index = reconstructed_index.data();
+  frame_count = reconstructed_index.size() / cINDEX_ENTRY_SIZE;
+  return true;
+}
@@ -0,0 +1,306 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasRecording.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasRecorder and tCanvasPlayer
+ *
+ * \b tCanvasRecorder
+ *
+ * Records canvases to a file - with an index for seeking.
+ *
+ * \b tCanvasPlayer
+ *
+ * Reads files written by tCanvasRecorder via memory mapping.
+ *
+ * File format (all numbers little endian):
+ *
+ *   Header:  "RRCANREC" (8 bytes), format version (uint32), dimension of canvases (uint8), 3 reserved bytes
+ *   Frames:  timestamp in ns since epoch (int64), size (uint64), canvas data (as written by operator << - without leading size)
+ *   Index:   per frame: timestamp (int64), offset of canvas data in file (uint64), size (uint64)
+ *   Trailer: offset of index (uint64), number of frames (uint64), "RRCANIDX" (8 bytes)
+ *
+ * Index and trailer are written when a recording is closed. If they are missing
+ * (e.g. because the recording process crashed), the index is reconstructed from the frames.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasRecording_h__
+#define __rrlib__canvas__tCanvasRecording_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <chrono>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*! Timestamp of recorded frames */
+typedef std::chrono::system_clock::time_point tCanvasTimestamp;
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Records canvases to a file
+/*!
+ * Canvases are appended to the file as they are recorded - each with a timestamp.
+ * Timestamps must not decrease (so that frames can be found by binary search).
+ * A frame index is appended when the recording is closed.
+ *
+ * All canvases of a recording must have the same dimension.
+ */
+class tCanvasRecorder : public util::tNoncopyable
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  tCanvasRecorder();
+
+  /*! Closes recording */
+  ~tCanvasRecorder();
+
+  /*!
+   * Writes frame index and closes file.
+   * Does nothing if no file is open.
+   *
+   * \return True if index was written successfully
+   */
+  bool Close();
+
+  /*!
+   * \return Number of frames recorded to current file
+   */
+  size_t GetFrameCount() const;
+
+  /*!
+   * \return Whether a file is open
+   */
+  bool IsOpen() const
+  {
+    return file_descriptor >= 0;
+  }
+
+  /*!
+   * Creates file and starts recording (closes a previously opened file).
+   * An existing file is overwritten.
+   *
+   * \param file_name Name of file
+   * \param dimension Dimension of recorded canvases (2 for tCanvas2D and 3 for tCanvas3D)
+   * \return True if file was created successfully
+   */
+  bool Open(const std::string& file_name, unsigned int dimension);
+
+  /*!
+   * Appends canvas to recording
+   *
+   * \param canvas Canvas to record
+   * \param timestamp Timestamp of canvas (must not be before timestamp of previous frame)
+   * \return True if canvas was recorded (if writing fails, the partially written frame is removed from the file -
+   *         if this is not possible either, the recording is closed)
+   */
+  bool Record(const tCanvas2D& canvas, tCanvasTimestamp timestamp = std::chrono::system_clock::now());
+  bool Record(const tCanvas3D& canvas, tCanvasTimestamp timestamp = std::chrono::system_clock::now());
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Descriptor of file (-1 if no file is open) */
+  int file_descriptor;
+
+  std::string file_name;
+
+  unsigned int dimension;
+
+  /*! Current size of file */
+  uint64_t file_size;
+
+  /*! Frame index in file format */
+  std::vector<char> index;
+
+  /*! Timestamp of last recorded frame (ns since epoch) */
+  int64_t last_timestamp;
+
+  /*!
+   * Implementation of Record()
+   */
+  bool Record(const tCanvas& canvas, unsigned int dimension, tCanvasTimestamp timestamp);
+
+  /*!
+   * Writes data to file
+   *
+   * \return True if all data was written
+   */
+  bool Write(const void* data, size_t size);
+};
+
+//! Plays back files written by tCanvasRecorder
+/*!
+ * The file is mapped into memory: frames are accessed without reading or copying the
+ * file - GetFrame() returns pointers into the mapping that can be decoded with a tCanvasReader.
+ * Frames are found by timestamp via binary search on the frame index.
+ */
+class tCanvasPlayer : public util::tNoncopyable
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Recorded frame (data points into memory-mapped file) */
+  struct tFrame
+  {
+    tCanvasTimestamp timestamp;
+
+    /*! Canvas data (as written by operator << - without leading size) */
+    const char* data;
+
+    /*! Size of canvas data in bytes */
+    size_t size;
+  };
+
+  tCanvasPlayer();
+
+  /*! Closes file */
+  ~tCanvasPlayer();
+
+  /*!
+   * Unmaps and closes file (frames obtained via GetFrame() become invalid)
+   */
+  void Close();
+
+  /*!
+   * \param timestamp Timestamp
+   * \return Index of last frame recorded at or before timestamp (0 if all frames were recorded later)
+   */
+  size_t FindFrame(tCanvasTimestamp timestamp) const;
+
+  /*!
+   * \return Dimension of recorded canvases
+   */
+  unsigned int GetDimension() const
+  {
+    return dimension;
+  }
+
+  /*!
+   * \param frame_index Index of frame (< GetFrameCount())
+   * \return Frame with the specified index
+   */
+  tFrame GetFrame(size_t frame_index) const;
+
+  /*!
+   * \return Number of frames in file
+   */
+  size_t GetFrameCount() const
+  {
+    return frame_count;
+  }
+
+  /*!
+   * \return Whether a file is open
+   */
+  bool IsOpen() const
+  {
+    return mapping != NULL;
+  }
+
+  /*!
+   * Copies frame into canvas
+   *
+   * \param frame_index Index of frame (< GetFrameCount())
+   * \param canvas Canvas to store frame in (its content is replaced - with a single copy from the file mapping)
+   * \return False if frame index or dimension of canvas is invalid
+   */
+  bool Load(size_t frame_index, tCanvas2D& canvas) const;
+  bool Load(size_t frame_index, tCanvas3D& canvas) const;
+
+  /*!
+   * Opens file and maps it into memory (closes a previously opened file)
+   *
+   * \param file_name Name of file
+   * \return True if file was opened successfully (also if index had to be reconstructed)
+   */
+  bool Open(const std::string& file_name);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Memory-mapped file (NULL if no file is open) */
+  const char* mapping;
+  size_t mapping_size;
+
+  unsigned int dimension;
+
+  size_t frame_count;
+
+  /*! Frame index in file format (points into mapping - or to reconstructed_index) */
+  const char* index;
+
+  /*! Index that was reconstructed from frames (if file has none) */
+  std::vector<char> reconstructed_index;
+
+  /*!
+   * Implementation of Load()
+   */
+  bool Load(size_t frame_index, tCanvas& canvas, unsigned int dimension) const;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
@@ -0,0 +1,177 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasShardSet.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tCanvasShardSet
+ *
+ * \b tCanvasShardSet
+ *
+ * Set of canvases that multiple threads draw to concurrently.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tCanvasShardSet_h__
+#define __rrlib__canvas__tCanvasShardSet_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Canvas shards for concurrent drawing
+/*!
+ * tCanvas is not thread-safe. Instead of synchronizing threads that draw to the
+ * same canvas, each thread draws to its own shard (a canvas with its own pre-sized buffer).
+ * Shards are obtained via AcquireShard() (lock-free) or GetShard().
+ *
+ * Publish() gathers all shards into a single canvas - in shard order, with one copy per shard.
+ * The order of commands within each shard is preserved.
+ * Every shard is interpreted independently of the shards before it: it starts with identity
+ * transformation (eRESET_TRANSFORMATION is written before it) and with the drawing state
+ * (colors, alpha, fill, Z, extrusion) that the canvas had before Publish() - state commands
+ * are written to restore state that a preceding shard changed. State that was not set
+ * on the canvas cannot be restored - so shards should set any state they rely on.
+ * After Publish(), the canvas has its previous drawing state again and identity transformation
+ * (or its folded transformation, if transformation folding is enabled).
+ * A shard that is still in path mode has its path ended (ePATH_END_OPEN) - so that
+ * commands of the next shard are not interpreted as part of its path.
+ * Shards that just started path mode (no segment appended yet) cannot be published.
+ *
+ * Publish() and Reset() must not be called while threads are still drawing
+ * (e.g. call them after joining the threads or after a barrier).
+ *
+ * \tparam TCanvas Type of shards (tCanvas2D or tCanvas3D)
+ */
+template <typename TCanvas>
+class tCanvasShardSet : public rrlib::util::tNoncopyable
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param shard_count Number of shards (typically number of threads)
+   * \param shard_size Initial buffer size of each shard in bytes
+   */
+  inline tCanvasShardSet(size_t shard_count, size_t shard_size = serialization::tMemoryBuffer::cDEFAULT_SIZE);
+
+  /*!
+   * Acquires a shard that no other thread has acquired since last Reset() (thread-safe and lock-free)
+   *
+   * \return Acquired shard - or NULL if all shards have been acquired
+   */
+  inline TCanvas* AcquireShard();
+
+  /*!
+   * \return Number of shards
+   */
+  size_t GetShardCount() const
+  {
+    return shards.size();
+  }
+
+  /*!
+   * \param index Index of shard (< GetShardCount())
+   * \return Shard with the specified index (for threads that have a fixed index)
+   */
+  TCanvas& GetShard(size_t index)
+  {
+    return *shards[index];
+  }
+
+  /*!
+   * \return Total size of all shards in bytes
+   */
+  inline size_t GetSize() const;
+
+  /*!
+   * Appends contents of all shards to canvas (in shard order - each shard starting with identity transformation
+   * and the canvas' drawing state - see class documentation)
+   * (has no effect - and logs an error - if canvas or any shard just started path mode)
+   *
+   * \param canvas Canvas to append shards to
+   */
+  inline void Publish(TCanvas& canvas) const;
+
+  /*!
+   * Clears all shards and makes them available for AcquireShard() again
+   */
+  inline void Reset();
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Shards (allocated separately - so that threads do not write to the same cache lines) */
+  std::vector<std::unique_ptr<TCanvas>> shards;
+
+  /*! Index of next shard to be acquired */
+  std::atomic<size_t> next_shard;
+};
+
+typedef tCanvasShardSet<tCanvas2D> tCanvasShardSet2D;
+typedef tCanvasShardSet<tCanvas3D> tCanvasShardSet3D;
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tCanvasShardSet.hpp"
+
+#endif
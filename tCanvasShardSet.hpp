@@ -0,0 +1,202 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tCanvasShardSet.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tCanvasShardSet constructors
+//----------------------------------------------------------------------
+template <typename TCanvas>
+tCanvasShardSet<TCanvas>::tCanvasShardSet(size_t shard_count, size_t shard_size) :
+  shards(),
+  next_shard(0)
+{
+  for (size_t i = 0; i < shard_count; i++)
+  {
+    shards.emplace_back(new TCanvas());
+    shards.back()->Reserve(shard_size);
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasShardSet AcquireShard
+//----------------------------------------------------------------------
+template <typename TCanvas>
+TCanvas* tCanvasShardSet<TCanvas>::AcquireShard()
+{
+  size_t index = next_shard.fetch_add(1, std::memory_order_relaxed);
+  if (index >= shards.size())
+  {
+    RRLIB_LOG_PRINT(ERROR, "All ", shards.size(), " shards have already been acquired.");
+    return NULL;
+  }
+  return shards[index].get();
+}
+
+//----------------------------------------------------------------------
+// tCanvasShardSet GetSize
+//----------------------------------------------------------------------
+template <typename TCanvas>
+size_t tCanvasShardSet<TCanvas>::GetSize() const
+{
+  size_t size = 0;
+  for (const std::unique_ptr<TCanvas> & shard : shards)
+  {
+    size += shard->GetSize();
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------
+// tCanvasShardSet Publish
+//----------------------------------------------------------------------
+template <typename TCanvas>
+void tCanvasShardSet<TCanvas>::Publish(TCanvas& canvas) const
+{
+  tCanvas& target = canvas;
+  if (target.entering_path_mode)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Just started path mode. Command has no effect.");
+    return;
+  }
+  for (size_t i = 0; i < shards.size(); i++)
+  {
+    if (static_cast<const tCanvas&>(*shards[i]).entering_path_mode)
+    {
+      RRLIB_LOG_PRINT(ERROR, "Shard ", i, " just started path mode. Command has no effect.");
+      return;
+    }
+  }
+  if (target.in_path_mode)
+  {
+    target.AppendCommandRaw(ePATH_END_OPEN);
+    target.in_path_mode = false;
+  }
+  target.Reserve(target.GetSize() + GetSize() + shards.size() * 64);
+
+  // Every shard starts with identity transformation and the drawing state the canvas had before - regardless of the shards before it
+  tCanvas::tStateValue initial_state[tCanvas::eSTATE_VARIABLE_COUNT];
+  std::memcpy(initial_state, target.state_values, sizeof(initial_state));
+  bool published = false;
+  for (const std::unique_ptr<TCanvas> & shard_pointer : shards)
+  {
+    const tCanvas& shard = *shard_pointer;
+    size_t shard_size = shard.stream->GetPosition();
+    if (!shard_size)
+    {
+      continue;
+    }
+    if (published)
+    {
+      target.RestoreState(initial_state);
+    }
+    if (target.stream->GetPosition())
+    {
+      target.AppendCommandRaw(eRESET_TRANSFORMATION);
+    }
+    if (shard.default_viewport_offset && (!target.default_viewport_offset))
+    {
+      target.default_viewport_offset = target.stream->GetPosition() + shard.default_viewport_offset;
+    }
+    target.stream->Write(shard.buffer->GetBufferPointer(0), shard_size);
+    target.MergeState(shard);
+    if (shard.in_path_mode)
+    {
+      target.AppendCommandRaw(ePATH_END_OPEN);
+    }
+    published = true;
+  }
+
+  // Commands appended to canvas afterwards are not affected by the shards either
+  if (published)
+  {
+    target.RestoreState(initial_state);
+    if (target.transformation_folding)
+    {
+      target.transformation_pending = true;
+    }
+    else
+    {
+      target.AppendCommandRaw(eRESET_TRANSFORMATION);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tCanvasShardSet Reset
+//----------------------------------------------------------------------
+template <typename TCanvas>
+void tCanvasShardSet<TCanvas>::Reset()
+{
+  for (const std::unique_ptr<TCanvas> & shard_pointer : shards)
+  {
+    tCanvas& shard = *shard_pointer;
+    shard.Clear();
+    shard.entering_path_mode = false;
+    shard.in_path_mode = false;
+  }
+  next_shard.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,235 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tLayeredCanvas.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tLayeredCanvas
+ *
+ * \b tLayeredCanvas
+ *
+ * Canvas that consists of named layers which can be redrawn independently.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tLayeredCanvas_h__
+#define __rrlib__canvas__tLayeredCanvas_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <memory>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Canvas with named layers
+/*!
+ * Each layer is a separate canvas (with its own buffer) that can be cleared
+ * and redrawn independently. So e.g. static map geometry can be drawn once -
+ * and only a dynamic overlay is redrawn in every cycle.
+ *
+ * Layers are drawn in the order they were created.
+ * When serialized, the layers are written one after the other - directly from
+ * their buffers. The result is identical to a single canvas containing all commands
+ * (and it is deserialized as such).
+ *
+ * Note that drawing state (colors, fill, transformation, ...) carries over from one
+ * layer to the next when the data is interpreted. Layers should therefore set
+ * (or reset) any state they rely on before drawing.
+ *
+ * \tparam TCanvas Type of layers (tCanvas2D or tCanvas3D)
+ */
+template <typename TCanvas>
+class tLayeredCanvas : public rrlib::util::tNoncopyable
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  tLayeredCanvas() :
+    layers()
+  {}
+
+  /*!
+   * Clears all layers (layers themselves are kept)
+   */
+  void Clear()
+  {
+    for (tLayer & layer : layers)
+    {
+      layer.canvas->Clear();
+    }
+  }
+
+  /*!
+   * Copies contents of all layers to a single canvas
+   *
+   * \param canvas Canvas to copy layers to (is cleared first)
+   */
+  inline void Flatten(TCanvas& canvas) const;
+
+  /*!
+   * \param name Name of layer
+   * \return Layer with the specified name - or NULL if there is no such layer
+   */
+  inline const TCanvas* FindLayer(const std::string& name) const;
+
+  TCanvas* FindLayer(const std::string& name)
+  {
+    return const_cast<TCanvas*>(static_cast<const tLayeredCanvas&>(*this).FindLayer(name));
+  }
+
+  /*!
+   * Obtains layer with the specified name
+   * If no such layer exists, it is created (and drawn on top of existing layers).
+   * The returned reference remains valid until the layer is removed.
+   *
+   * \param name Name of layer
+   * \return Layer with the specified name
+   */
+  inline TCanvas& GetLayer(const std::string& name);
+
+  /*!
+   * \param index Index of layer (layers are ordered bottom to top)
+   * \return Layer with the specified index
+   */
+  TCanvas& GetLayer(size_t index)
+  {
+    return *layers[index].canvas;
+  }
+
+  const TCanvas& GetLayer(size_t index) const
+  {
+    return *layers[index].canvas;
+  }
+
+  /*!
+   * \return Number of layers
+   */
+  size_t GetLayerCount() const
+  {
+    return layers.size();
+  }
+
+  /*!
+   * \param index Index of layer
+   * \return Name of layer with the specified index
+   */
+  const std::string& GetLayerName(size_t index) const
+  {
+    return layers[index].name;
+  }
+
+  /*!
+   * \return Size of serialized canvas in bytes (without leading size)
+   */
+  inline size_t GetSize() const;
+
+  /*!
+   * Removes layer
+   *
+   * \param name Name of layer
+   * \return True if a layer with the specified name was removed
+   */
+  inline bool RemoveLayer(const std::string& name);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  template <typename T>
+  friend serialization::tOutputStream& operator << (serialization::tOutputStream& stream, const tLayeredCanvas<T>& canvas);
+
+  struct tLayer
+  {
+    std::string name;
+
+    /*! Layers are allocated separately so that references remain valid when layers are added or removed */
+    std::unique_ptr<TCanvas> canvas;
+  };
+
+  /*! Layers - ordered bottom to top */
+  std::vector<tLayer> layers;
+
+  /*!
+   * Determines total size of layers and default viewport offset (of first layer that has a default viewport)
+   *
+   * \param default_viewport_offset Offset of default viewport in concatenated layers (0 if there is none)
+   * \return Total size of layers in bytes
+   */
+  inline size_t GetLayerSize(size_t& default_viewport_offset) const;
+
+  /*!
+   * Writes all layers to stream (as operator << does for a single canvas)
+   */
+  inline void WriteTo(serialization::tOutputStream& stream) const;
+};
+
+template <typename TCanvas>
+serialization::tOutputStream& operator << (serialization::tOutputStream& stream, const tLayeredCanvas<TCanvas>& canvas)
+{
+  canvas.WriteTo(stream);
+  return stream;
+}
+
+typedef tLayeredCanvas<tCanvas2D> tLayeredCanvas2D;
+typedef tLayeredCanvas<tCanvas3D> tLayeredCanvas3D;
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tLayeredCanvas.hpp"
+
+#endif
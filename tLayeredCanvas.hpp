@@ -0,0 +1,188 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tLayeredCanvas.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tLayeredCanvas Flatten
+//----------------------------------------------------------------------
+template <typename TCanvas>
+void tLayeredCanvas<TCanvas>::Flatten(TCanvas& canvas) const
+{
+  canvas.Clear();
+  for (const tLayer & layer : layers)
+  {
+    canvas.AppendCanvas(*layer.canvas);
+  }
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas FindLayer
+//----------------------------------------------------------------------
+template <typename TCanvas>
+const TCanvas* tLayeredCanvas<TCanvas>::FindLayer(const std::string& name) const
+{
+  for (const tLayer & layer : layers)
+  {
+    if (layer.name == name)
+    {
+      return layer.canvas.get();
+    }
+  }
+  return NULL;
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas GetLayer
+//----------------------------------------------------------------------
+template <typename TCanvas>
+TCanvas& tLayeredCanvas<TCanvas>::GetLayer(const std::string& name)
+{
+  TCanvas* layer = FindLayer(name);
+  if (!layer)
+  {
+    layers.push_back(tLayer());
+    layers.back().name = name;
+    layers.back().canvas.reset(new TCanvas());
+    layer = layers.back().canvas.get();
+  }
+  return *layer;
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas GetLayerSize
+//----------------------------------------------------------------------
+template <typename TCanvas>
+size_t tLayeredCanvas<TCanvas>::GetLayerSize(size_t& default_viewport_offset) const
+{
+  size_t size = 0;
+  default_viewport_offset = 0;
+  for (const tLayer & layer : layers)
+  {
+    const tCanvas& canvas = *layer.canvas;
+    canvas.stream->Flush();
+    if (canvas.default_viewport_offset && (!default_viewport_offset))
+    {
+      default_viewport_offset = size + canvas.default_viewport_offset;
+    }
+    size += canvas.buffer->GetSize();
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas GetSize
+//----------------------------------------------------------------------
+template <typename TCanvas>
+size_t tLayeredCanvas<TCanvas>::GetSize() const
+{
+  size_t default_viewport_offset = 0;
+  size_t size = GetLayerSize(default_viewport_offset);
+  return default_viewport_offset ? size + 9 : size;
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas RemoveLayer
+//----------------------------------------------------------------------
+template <typename TCanvas>
+bool tLayeredCanvas<TCanvas>::RemoveLayer(const std::string& name)
+{
+  for (auto it = layers.begin(); it != layers.end(); ++it)
+  {
+    if (it->name == name)
+    {
+      layers.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------
+// tLayeredCanvas WriteTo
+//----------------------------------------------------------------------
+template <typename TCanvas>
+void tLayeredCanvas<TCanvas>::WriteTo(serialization::tOutputStream& stream) const
+{
+  size_t default_viewport_offset = 0;
+  size_t size = GetLayerSize(default_viewport_offset);
+  if (!default_viewport_offset)
+  {
+    stream.WriteLong(size);
+  }
+  else
+  {
+    // Prepend default viewport offset (as operator << of tCanvas does)
+    stream.WriteLong(9 + size);
+    stream << static_cast<uint8_t>(tCanvasOpCode::eDEFAULT_VIEWPORT_OFFSET);
+    stream.WriteLong(default_viewport_offset);
+  }
+  for (const tLayer & layer : layers)
+  {
+    const tCanvas& canvas = *layer.canvas;
+    stream.Write(canvas.buffer->GetBufferPointer(0), canvas.buffer->GetSize());
+  }
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,156 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tPointCloudLODBuilder.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tPointCloudLODBuilder.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cassert>
+#include <mutex>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tPointCloudLODBuilder constructors
+//----------------------------------------------------------------------
+tPointCloudLODBuilder::tPointCloudLODBuilder(unsigned int max_depth, unsigned int thread_count) :
+  max_depth(std::max(1u, std::min(21u, max_depth))),
+  thread_count(std::max(1u, thread_count)),
+  point_count(0),
+  codes(),
+  order(),
+  level_sizes(this->max_depth + 1, 0)
+{}
+
+//----------------------------------------------------------------------
+// tPointCloudLODBuilder SortIntoLevels
+//----------------------------------------------------------------------
+void tPointCloudLODBuilder::SortIntoLevels()
+{
+  // Sort chunks in parallel - then merge them pairwise
+  std::vector<std::pair<size_t, size_t>> chunks;
+  std::mutex chunks_mutex;
+  ParallelFor(codes.size(), [&](size_t first, size_t last)
+  {
+    std::sort(codes.begin() + first, codes.begin() + last);
+    std::lock_guard<std::mutex> lock(chunks_mutex);
+    chunks.push_back(std::make_pair(first, last));
+  });
+  std::sort(chunks.begin(), chunks.end());
+  while (chunks.size() > 1)
+  {
+    std::vector<std::pair<size_t, size_t>> merged;
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i + 1 < chunks.size(); i += 2)
+    {
+      size_t first = chunks[i].first, middle = chunks[i].second, last = chunks[i + 1].second;
+      workers.emplace_back([this, first, middle, last]()
+      {
+        std::inplace_merge(codes.begin() + first, codes.begin() + middle, codes.begin() + last);
+      });
+      merged.push_back(std::make_pair(first, last));
+    }
+    if (chunks.size() % 2)
+    {
+      merged.push_back(chunks.back());
+    }
+    for (std::thread & worker : workers)
+    {
+      worker.join();
+    }
+    chunks.swap(merged);
+  }
+
+  // Points with non-finite coordinates were sorted to the end
+  while ((!codes.empty()) && codes.back().first == std::numeric_limits<uint64_t>::max())
+  {
+    codes.pop_back();
+  }
+
+  // Level of each point follows from common prefix with predecessor's code
+  const unsigned int code_bits = 3 * max_depth;
+  std::vector<uint8_t> levels(codes.size());
+  std::fill(level_sizes.begin(), level_sizes.end(), 0);
+  for (size_t i = 0; i < codes.size(); i++)
+  {
+    unsigned int level = 0;
+    if (i > 0)
+    {
+      uint64_t difference = codes[i].first ^ codes[i - 1].first;
+      if (difference == 0)
+      {
+        level = max_depth;
+      }
+      else
+      {
+        unsigned int highest_bit = 63 - __builtin_clzll(difference);
+        unsigned int common_prefix_cells = (code_bits - 1 - highest_bit) / 3;
+        level = std::min(max_depth, common_prefix_cells + 1);
+      }
+    }
+    levels[i] = level;
+    level_sizes[level]++;
+  }
+
+  // Stable counting sort by level
+  std::vector<size_t> offsets(level_sizes.size(), 0);
+  for (size_t i = 1; i < level_sizes.size(); i++)
+  {
+    offsets[i] = offsets[i - 1] + level_sizes[i - 1];
+  }
+  order.resize(codes.size());
+  for (size_t i = 0; i < codes.size(); i++)
+  {
+    order[offsets[levels[i]]++] = codes[i].second;
+  }
+}
@@ -0,0 +1,184 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tPointCloudLODBuilder.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tPointCloudLODBuilder
+ *
+ * \b tPointCloudLODBuilder
+ *
+ * Sorts point clouds into octree levels of detail for tCanvas3D::DrawPointCloudLOD().
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tPointCloudLODBuilder_h__
+#define __rrlib__canvas__tPointCloudLODBuilder_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Builds octree levels of detail for point clouds
+/*!
+ * An octree is laid over the point cloud's bounding cube.
+ * Level 0 contains one point. Level l (0 < l < max_depth) contains one point
+ * for every octree cell at depth l that contains no point of a coarser level.
+ * The last level contains all remaining points.
+ *
+ * So levels 0 to n together are a uniformly thinned version of the point cloud
+ * and all levels together are the complete point cloud.
+ *
+ * The octree is not stored explicitly: points are sorted by their Morton code
+ * (cell index at maximum depth). The level of a point follows from the length
+ * of the common prefix with the Morton code of its predecessor.
+ *
+ * Computing codes and sorting run on the specified number of threads.
+ * Buffers are kept between calls - so a builder object should be reused.
+ */
+class tPointCloudLODBuilder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param max_depth Maximum depth of octree (1 to 21). There are max_depth + 1 levels.
+   * \param thread_count Number of threads to use
+   */
+  tPointCloudLODBuilder(unsigned int max_depth = 10, unsigned int thread_count = 1);
+
+  /*!
+   * Sorts points into levels
+   *
+   * \param points_begin Random access iterator to first point (e.g. math::tVector<3, TElement>)
+   * \param points_end Random access iterator past last point
+   */
+  template <typename TIterator>
+  void Build(TIterator points_begin, TIterator points_end);
+
+  /*!
+   * \return Number of levels (max_depth + 1)
+   */
+  size_t GetLevelCount() const
+  {
+    return level_sizes.size();
+  }
+
+  /*!
+   * \param level Level index
+   * \return Number of points in specified level
+   */
+  size_t GetLevelSize(size_t level) const
+  {
+    return level_sizes[level];
+  }
+
+  /*!
+   * \return Indices of all points of last call to Build() - sorted by level
+   */
+  const std::vector<uint32_t>& GetOrder() const
+  {
+    return order;
+  }
+
+  /*!
+   * \return Number of points (including non-finite ones) of last call to Build()
+   */
+  size_t GetPointCount() const
+  {
+    return point_count;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  unsigned int max_depth;
+
+  unsigned int thread_count;
+
+  /*! Number of points of last call to Build() */
+  size_t point_count;
+
+  /*! Morton code and index of every point */
+  std::vector<std::pair<uint64_t, uint32_t>> codes;
+
+  /*! Point indices sorted by level */
+  std::vector<uint32_t> order;
+
+  /*! Number of points in each level */
+  std::vector<size_t> level_sizes;
+
+  /*!
+   * Calls function(first, last) for equally sized ranges of [0, count) on multiple threads
+   */
+  template <typename TFunction>
+  void ParallelFor(size_t count, TFunction function);
+
+  /*!
+   * Sorts codes by Morton code and fills order and level sizes
+   */
+  void SortIntoLevels();
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tPointCloudLODBuilder.hpp"
+
+#endif
@@ -0,0 +1,172 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tPointCloudLODBuilder.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace internal
+{
+
+/*!
+ * Spreads lower 21 bits of value so that there are two zero bits between any two bits
+ */
+inline uint64_t SpreadBits(uint64_t value)
+{
+  value &= 0x1FFFFF;
+  value = (value | value << 32) & 0x1F00000000FFFFull;
+  value = (value | value << 16) & 0x1F0000FF0000FFull;
+  value = (value | value << 8) & 0x100F00F00F00F00Full;
+  value = (value | value << 4) & 0x10C30C30C30C30C3ull;
+  value = (value | value << 2) & 0x1249249249249249ull;
+  return value;
+}
+
+}
+
+//----------------------------------------------------------------------
+// tPointCloudLODBuilder ParallelFor
+//----------------------------------------------------------------------
+template <typename TFunction>
+void tPointCloudLODBuilder::ParallelFor(size_t count, TFunction function)
+{
+  const size_t cMIN_ELEMENTS_PER_THREAD = 10000;
+  size_t threads = std::max<size_t>(1, std::min<size_t>(thread_count, count / cMIN_ELEMENTS_PER_THREAD));
+  size_t chunk_size = (count + threads - 1) / std::max<size_t>(1, threads);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; i++)
+  {
+    size_t first = std::min(count, i * chunk_size);
+    size_t last = std::min(count, first + chunk_size);
+    workers.emplace_back(function, first, last);
+  }
+  function(0, std::min(count, chunk_size));
+  for (std::thread & worker : workers)
+  {
+    worker.join();
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudLODBuilder Build
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tPointCloudLODBuilder::Build(TIterator points_begin, TIterator points_end)
+{
+  const size_t count = points_end - points_begin;
+  const uint64_t cINVALID = std::numeric_limits<uint64_t>::max();
+
+  // Bounding box (single pass - parallelizing does not pay off for this memory-bound loop)
+  double min[3] = { 0, 0, 0 };
+  double max[3] = { 0, 0, 0 };
+  bool empty = true;
+  for (TIterator it = points_begin; it != points_end; ++it)
+  {
+    for (size_t i = 0; i < 3; i++)
+    {
+      double value = static_cast<double>((*it)[i]);
+      if (!std::isfinite(value))
+      {
+        break;
+      }
+      min[i] = (empty || value < min[i]) ? value : min[i];
+      max[i] = (empty || value > max[i]) ? value : max[i];
+      empty = empty && i < 2;
+    }
+  }
+  double cube_size = std::max(std::max(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+  const double cells = static_cast<double>(1u << max_depth);
+  const double scale = cube_size > 0 ? cells / cube_size : 0;
+  const uint64_t max_cell = (1u << max_depth) - 1;
+
+  // Morton codes
+  point_count = count;
+  codes.resize(count);
+  ParallelFor(count, [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; i++)
+    {
+      const auto& point = *(points_begin + i);
+      double p[3] = { static_cast<double>(point[0]), static_cast<double>(point[1]), static_cast<double>(point[2]) };
+      if (!(std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2])))
+      {
+        codes[i] = std::make_pair(cINVALID, static_cast<uint32_t>(i));
+        continue;
+      }
+      uint64_t cell[3];
+      for (size_t j = 0; j < 3; j++)
+      {
+        cell[j] = std::min<uint64_t>(max_cell, static_cast<uint64_t>((p[j] - min[j]) * scale));
+      }
+      uint64_t code = (internal::SpreadBits(cell[0]) << 2) | (internal::SpreadBits(cell[1]) << 1) | internal::SpreadBits(cell[2]);
+      codes[i] = std::make_pair(code, static_cast<uint32_t>(i));
+    }
+  });
+
+  SortIntoLevels();
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
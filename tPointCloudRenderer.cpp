@@ -0,0 +1,748 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tPointCloudRenderer.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tPointCloudRenderer.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/internal/tAffineTransformation.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Edge length of (square) image tiles in pixels */
+static const unsigned int cTILE_SIZE = 64;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+uint32_t PackColor(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
+{
+  uint8_t bytes[4] = { r, g, b, alpha };
+  uint32_t color;
+  std::memcpy(&color, bytes, 4);
+  return color;
+}
+
+const uint32_t cALPHA_MASK = PackColor(0, 0, 0, 255);
+
+inline uint8_t ClampColor(double value)
+{
+  return static_cast<uint8_t>(value >= 255 ? 255 : (value > 0 ? value : 0));
+}
+
+/*!
+ * Loads coordinate from (unaligned) canvas buffer
+ */
+template <typename T>
+struct tLoad
+{
+  const char* data;
+
+  double operator()(size_t index) const
+  {
+    T value;
+    std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+    return value;
+  }
+};
+
+/*!
+ * Loads half precision coordinate from (unaligned) canvas buffer
+ */
+struct tLoadHalf
+{
+  const char* data;
+
+  double operator()(size_t index) const
+  {
+    uint16_t value;
+    std::memcpy(&value, data + index * sizeof(uint16_t), sizeof(uint16_t));
+    return internal::HalfToFloat(value);
+  }
+};
+
+/*!
+ * Loads coordinate of any other number type
+ */
+struct tLoadGeneric
+{
+  const tCanvasValues& values;
+
+  double operator()(size_t index) const
+  {
+    return values.Get<double>(index);
+  }
+};
+
+/*!
+ * Projects points [first, last) and calls emit(index, u, v, z) for each point with near <= z <= far
+ *
+ * \param projection Projection to pixel coordinates (3x4 matrix, row-major)
+ * \param stride Number of values per point (coordinates are first three values)
+ */
+template <typename TLoad, typename TEmit>
+inline void ProjectPointRange(const double* projection, TLoad load, size_t stride, size_t first, size_t last, double near, double far, TEmit emit)
+{
+  const double* p = projection;
+  for (size_t i = first; i < last; i++)
+  {
+    double x = load(i * stride), y = load(i * stride + 1), z = load(i * stride + 2);
+    double depth = p[8] * x + p[9] * y + p[10] * z + p[11];
+    if (!(depth >= near && depth <= far))
+    {
+      continue;
+    }
+    double inverse_depth = 1.0 / depth;
+    emit(i, (p[0] * x + p[1] * y + p[2] * z + p[3]) * inverse_depth, (p[4] * x + p[5] * y + p[6] * z + p[7]) * inverse_depth, depth);
+  }
+}
+
+/*!
+ * Dispatches ProjectPointRange with fast loads for common number types
+ */
+template <typename TEmit>
+void ProjectPointRange(const double* projection, const tCanvasValues& values, size_t stride, size_t first, size_t last, double near, double far, TEmit emit)
+{
+  switch (values.NumberType())
+  {
+  case eFLOAT:
+    ProjectPointRange(projection, tLoad<float> { values.Data() }, stride, first, last, near, far, emit);
+    break;
+  case eDOUBLE:
+    ProjectPointRange(projection, tLoad<double> { values.Data() }, stride, first, last, near, far, emit);
+    break;
+  case eUINT16:
+    ProjectPointRange(projection, tLoad<uint16_t> { values.Data() }, stride, first, last, near, far, emit);
+    break;
+  case eHALF:
+    ProjectPointRange(projection, tLoadHalf { values.Data() }, stride, first, last, near, far, emit);
+    break;
+  default:
+    ProjectPointRange(projection, tLoadGeneric { values }, stride, first, last, near, far, emit);
+    break;
+  }
+}
+
+/*!
+ * Multiplies 3x4 matrix with affine 4x4 matrix (result = left * right)
+ */
+void MultiplyAffine(const double (&left)[12], const internal::tAffineTransformation& right, double (&result)[12])
+{
+  for (size_t row = 0; row < 3; row++)
+  {
+    for (size_t column = 0; column < 4; column++)
+    {
+      result[row * 4 + column] = left[row * 4] * right.Get(0, column) + left[row * 4 + 1] * right.Get(1, column) + left[row * 4 + 2] * right.Get(2, column) + (column == 3 ? left[row * 4 + 3] : 0);
+    }
+  }
+}
+
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer constructors
+//----------------------------------------------------------------------
+tPointCloudRenderer::tPointCloudRenderer(unsigned int width, unsigned int height, unsigned int thread_count) :
+  width(0),
+  height(0),
+  thread_count(std::max(1u, thread_count)),
+  tiles_x(0),
+  tiles_y(0),
+  pixels(),
+  depth(),
+  background(PackColor(255, 255, 255, 255)),
+  world_to_camera { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0 },
+  intrinsics { static_cast<double>(width), static_cast<double>(width), width / 2.0, height / 2.0 },
+  near(0.01),
+  far(std::numeric_limits<double>::infinity()),
+  point_size(1),
+  jobs(),
+  bins()
+{
+  SetSize(width, height);
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer AddLineSegment
+//----------------------------------------------------------------------
+void tPointCloudRenderer::AddLineSegment(const double (&transformation)[12], const double* p1, const double* p2, uint32_t color)
+{
+  // Transform to camera frame and clip at near and far plane
+  double c[2][3];
+  for (size_t row = 0; row < 3; row++)
+  {
+    const double* m = &transformation[row * 4];
+    c[0][row] = m[0] * p1[0] + m[1] * p1[1] + m[2] * p1[2] + m[3];
+    c[1][row] = m[0] * p2[0] + m[1] * p2[1] + m[2] * p2[2] + m[3];
+  }
+  double t_min = 0, t_max = 1;
+  const double dz = c[1][2] - c[0][2];
+  const double plane_distances[2][2] = { { c[0][2] - near, dz }, { far - c[0][2], -dz } };  // inside if distance + t * delta >= 0
+  for (auto & plane : plane_distances)
+  {
+    if (plane[1] == 0)
+    {
+      if (!(plane[0] >= 0))
+      {
+        return;
+      }
+      continue;
+    }
+    double t = -plane[0] / plane[1];
+    if (plane[1] > 0)
+    {
+      t_min = std::max(t_min, t);
+    }
+    else
+    {
+      t_max = std::min(t_max, t);
+    }
+  }
+  if (!(t_min <= t_max))
+  {
+    return;
+  }
+
+  // Project end points: (u, v, 1/z) is linear in image space
+  double end_points[2][3];
+  for (size_t i = 0; i < 2; i++)
+  {
+    double t = i ? t_max : t_min;
+    double x = c[0][0] + t * (c[1][0] - c[0][0]), y = c[0][1] + t * (c[1][1] - c[0][1]), z = c[0][2] + t * dz;
+    end_points[i][0] = intrinsics[0] * x / z + intrinsics[2];
+    end_points[i][1] = intrinsics[1] * y / z + intrinsics[3];
+    end_points[i][2] = 1.0 / z;
+  }
+
+  // Clip to image (Liang-Barsky)
+  double delta[3] = { end_points[1][0] - end_points[0][0], end_points[1][1] - end_points[0][1], end_points[1][2] - end_points[0][2] };
+  t_min = 0;
+  t_max = 1;
+  const double limits[2] = { static_cast<double>(width), static_cast<double>(height) };
+  for (size_t axis = 0; axis < 2; axis++)
+  {
+    const double p[2] = { -delta[axis], delta[axis] }, q[2] = { end_points[0][axis], limits[axis] - end_points[0][axis] };
+    for (size_t i = 0; i < 2; i++)
+    {
+      if (p[i] == 0)
+      {
+        if (!(q[i] >= 0))
+        {
+          return;
+        }
+        continue;
+      }
+      double t = q[i] / p[i];
+      if (p[i] < 0)
+      {
+        t_min = std::max(t_min, t);
+      }
+      else
+      {
+        t_max = std::min(t_max, t);
+      }
+    }
+  }
+  if (!(t_min <= t_max))
+  {
+    return;
+  }
+
+  // One pixel per step along major axis
+  double start[3];
+  for (size_t i = 0; i < 3; i++)
+  {
+    start[i] = end_points[0][i] + t_min * delta[i];
+    delta[i] *= (t_max - t_min);
+  }
+  double length = std::max(std::abs(delta[0]), std::abs(delta[1]));
+  size_t steps = static_cast<size_t>(std::ceil(length));
+  double step = steps ? 1.0 / steps : 0;
+  std::vector<tSplat>* line_bins = &bins[static_cast<size_t>(thread_count) * tiles_x * tiles_y];
+  for (size_t i = 0; i <= steps; i++)
+  {
+    double t = i * step;
+    double u = start[0] + t * delta[0], v = start[1] + t * delta[1];
+    if (u >= 0 && u < width && v >= 0 && v < height)
+    {
+      AddSplat(line_bins, static_cast<int>(u), static_cast<int>(v), static_cast<float>(1.0 / (start[2] + t * delta[2])), color, 1);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer AddSplat
+//----------------------------------------------------------------------
+void tPointCloudRenderer::AddSplat(std::vector<tSplat>* tile_bins, int x, int y, float z, uint32_t color, unsigned int size) const
+{
+  tSplat splat;
+  splat.x = static_cast<int16_t>(x);
+  splat.y = static_cast<int16_t>(y);
+  splat.depth = z;
+  splat.color = (color & ~cALPHA_MASK) | (PackColor(0, 0, 0, static_cast<uint8_t>(size)));
+  if (size == 1)
+  {
+    tile_bins[(static_cast<unsigned int>(y) / cTILE_SIZE) * tiles_x + static_cast<unsigned int>(x) / cTILE_SIZE].push_back(splat);
+    return;
+  }
+  unsigned int tile_x_begin = std::max(0, x) / cTILE_SIZE, tile_x_end = std::min<int>(width - 1, x + size - 1) / cTILE_SIZE;
+  unsigned int tile_y_begin = std::max(0, y) / cTILE_SIZE, tile_y_end = std::min<int>(height - 1, y + size - 1) / cTILE_SIZE;
+  for (unsigned int tile_y = tile_y_begin; tile_y <= tile_y_end; tile_y++)
+  {
+    for (unsigned int tile_x = tile_x_begin; tile_x <= tile_x_end; tile_x++)
+    {
+      tile_bins[tile_y * tiles_x + tile_x].push_back(splat);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer ProjectPoints
+//----------------------------------------------------------------------
+void tPointCloudRenderer::ProjectPoints(const tPointJob& job, size_t first, size_t last, std::vector<tSplat>* tile_bins) const
+{
+  // Splats are centered at projected points: pixel x covers [x, x + 1)
+  const unsigned int size = point_size;
+  const double offset = (size - 1) * 0.5, limit = 1.0 - size;
+  const tCanvasCommand& command = job.command;
+  auto emit = [&](double u, double v, float z, uint32_t color)
+  {
+    u -= offset;
+    v -= offset;
+    if (u >= limit && u < width && v >= limit && v < height)
+    {
+      // Values are > -256 here: shift them for truncation to round down
+      this->AddSplat(tile_bins, static_cast<int>(u + 256) - 256, static_cast<int>(v + 256) - 256, z, color, size);
+    }
+  };
+
+  switch (command.opcode)
+  {
+  case eDRAW_COLORED_POINT_CLOUD:
+  {
+    const tCanvasValues& values = command.values;
+    ProjectPointRange(job.projection, values, 6, first, last, near, far, [&](size_t index, double u, double v, double z)
+    {
+      emit(u, v, z, PackColor(ClampColor(values.Get<double>(index * 6 + 3)), ClampColor(values.Get<double>(index * 6 + 4)), ClampColor(values.Get<double>(index * 6 + 5)), 255));
+    });
+    break;
+  }
+  case eDRAW_RGB_POINT_CLOUD:
+  {
+    const uint8_t* colors = reinterpret_cast<const uint8_t*>(command.colors.Data());
+    const size_t color_stride = command.flag ? 4 : 3;
+    ProjectPointRange(job.projection, command.values, 3, first, last, near, far, [&](size_t index, double u, double v, double z)
+    {
+      const uint8_t* color = colors + index * color_stride;
+      emit(u, v, z, PackColor(color[0], color[1], color[2], 255));
+    });
+    break;
+  }
+  default:
+    ProjectPointRange(job.projection, command.values, 3, first, last, near, far, [&](size_t, double u, double v, double z)
+    {
+      emit(u, v, z, job.color);
+    });
+    break;
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer Render
+//----------------------------------------------------------------------
+void tPointCloudRenderer::Render(const tCanvas3D& canvas)
+{
+  for (std::vector<tSplat> & bin : bins)
+  {
+    bin.clear();
+  }
+  jobs.clear();
+
+  // Replay commands: collect point clouds - and add splats of lines
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  internal::tAffineTransformation transformation;
+  double camera_transformation[12];
+  std::copy(world_to_camera, world_to_camera + 12, camera_transformation);
+  uint32_t color = PackColor(0, 0, 0, 255);
+  std::vector<double> points;
+  auto add_job = [&](size_t count)
+  {
+    jobs.emplace_back();
+    tPointJob& job = jobs.back();
+    job.command = command;
+    job.color = color;
+    job.count = count;
+    const double* c = camera_transformation;
+    for (size_t column = 0; column < 4; column++)
+    {
+      job.projection[column] = intrinsics[0] * c[column] + intrinsics[2] * c[8 + column];
+      job.projection[4 + column] = intrinsics[1] * c[4 + column] + intrinsics[3] * c[8 + column];
+      job.projection[8 + column] = c[8 + column];
+    }
+  };
+  auto load_points = [&](size_t count)
+  {
+    points.resize(count * 3);
+    for (size_t i = 0; i < count * 3; i++)
+    {
+      points[i] = command.values.Get<double>(i);
+    }
+  };
+  while (reader.Next(command))
+  {
+    const tCanvasValues& values = command.values;
+    bool transformation_changed = true;
+    switch (command.opcode)
+    {
+    case eSET_TRANSFORMATION:
+    case eTRANSFORM:
+    {
+      internal::tAffineTransformation::tMatrix matrix;
+      for (size_t i = 0; i < 16; i++)
+      {
+        matrix[i] = values.Get<double>(i);
+      }
+      if (command.opcode == eSET_TRANSFORMATION)
+      {
+        transformation.Set(matrix);
+      }
+      else
+      {
+        transformation.Multiply(matrix);
+      }
+      break;
+    }
+    case eTRANSLATE:
+      transformation.Translate(values.Get<double>(0), values.Get<double>(1), values.Get<double>(2));
+      break;
+    case eROTATE:
+      transformation.Rotate(values.Get<double>(0), values.Get<double>(1), values.Get<double>(2));
+      break;
+    case eSCALE:
+      transformation.Scale(values.Get<double>(0), values.Get<double>(1), values.Get<double>(2));
+      break;
+    case eRESET_TRANSFORMATION:
+      transformation.SetIdentity();
+      break;
+    default:
+      transformation_changed = false;
+      break;
+    }
+    if (transformation_changed)
+    {
+      MultiplyAffine(world_to_camera, transformation, camera_transformation);
+      continue;
+    }
+
+    switch (command.opcode)
+    {
+    case eSET_COLOR:
+    case eSET_EDGE_COLOR:
+      color = PackColor(values.Get<uint8_t>(0), values.Get<uint8_t>(1), values.Get<uint8_t>(2), 255);
+      break;
+    case eDRAW_POINT:
+    case eDRAW_POINT_CLOUD:
+    case eDRAW_COLORED_POINT_CLOUD:
+    case eDRAW_RGB_POINT_CLOUD:
+    case eDRAW_POINT_CLOUD_LOD:
+      add_job(command.opcode == eDRAW_POINT ? 1 : command.count);
+      break;
+    case eDRAW_QUANTIZED_POINT_CLOUD:
+    {
+      // Decoding (offset + step * value) is part of projection
+      internal::tAffineTransformation decoding;
+      decoding.Translate(command.parameters.Get<double>(0), command.parameters.Get<double>(1), command.parameters.Get<double>(2));
+      decoding.Scale(command.parameters.Get<double>(3), command.parameters.Get<double>(3), command.parameters.Get<double>(3));
+      double camera_transformation_backup[12];
+      std::copy(camera_transformation, camera_transformation + 12, camera_transformation_backup);
+      MultiplyAffine(camera_transformation_backup, decoding, camera_transformation);
+      add_job(command.count);
+      std::copy(camera_transformation_backup, camera_transformation_backup + 12, camera_transformation);
+      break;
+    }
+    case eDRAW_LINE_SEGMENT:
+    case eDRAW_ARROW:
+      load_points(2);
+      AddLineSegment(camera_transformation, &points[0], &points[3], color);
+      break;
+    case eDRAW_LINE_STRIP:
+    case eDRAW_POLYGON:
+      load_points(command.count);
+      for (size_t i = 1; i < command.count; i++)
+      {
+        AddLineSegment(camera_transformation, &points[i * 3 - 3], &points[i * 3], color);
+      }
+      if (command.opcode == eDRAW_POLYGON && command.count > 2)
+      {
+        AddLineSegment(camera_transformation, &points[command.count * 3 - 3], &points[0], color);
+      }
+      break;
+    case eDRAW_BOX:
+    {
+      load_points(2);
+      double corners[8][3];
+      for (size_t i = 0; i < 8; i++)
+      {
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+          corners[i][axis] = points[axis] + ((i >> axis) & 1) * points[3 + axis];
+        }
+      }
+      for (size_t i = 0; i < 8; i++)
+      {
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+          if (!((i >> axis) & 1))
+          {
+            AddLineSegment(camera_transformation, corners[i], corners[i | (1 << axis)], color);
+          }
+        }
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+  if (reader.IsMalformed())
+  {
+    RRLIB_LOG_PRINT(WARNING, "Canvas contains malformed commands. Rendering commands before them only.");
+  }
+
+  // Project points: each thread projects an equal share of all points
+  size_t point_count = 0;
+  for (const tPointJob & job : jobs)
+  {
+    point_count += job.count;
+  }
+  const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y;
+  auto project = [&](size_t thread_index)
+  {
+    size_t first = point_count * thread_index / thread_count, last = point_count * (thread_index + 1) / thread_count;
+    size_t job_first = 0;
+    for (const tPointJob & job : jobs)
+    {
+      size_t job_last = job_first + job.count;
+      if (job_last > first && job_first < last)
+      {
+        ProjectPoints(job, std::max(first, job_first) - job_first, std::min(last, job_last) - job_first, &bins[thread_index * tile_count]);
+      }
+      job_first = job_last;
+    }
+  };
+  std::vector<std::thread> workers;
+  size_t project_threads = point_count ? thread_count : 1;
+  for (size_t i = 1; i < project_threads; i++)
+  {
+    workers.emplace_back(project, i);
+  }
+  project(0);
+  for (std::thread & thread : workers)
+  {
+    thread.join();
+  }
+  workers.clear();
+
+  // Rasterize tiles
+  std::atomic<size_t> next_tile(0);
+  auto rasterize = [&]()
+  {
+    std::vector<float> tile_depth(cTILE_SIZE * cTILE_SIZE);
+    std::vector<uint32_t> tile_pixels(cTILE_SIZE * cTILE_SIZE);
+    for (size_t tile = next_tile++; tile < tile_count; tile = next_tile++)
+    {
+      RenderTile(tile, tile_depth, tile_pixels);
+    }
+  };
+  for (size_t i = 1; i < std::min<size_t>(thread_count, tile_count); i++)
+  {
+    workers.emplace_back(rasterize);
+  }
+  rasterize();
+  for (std::thread & thread : workers)
+  {
+    thread.join();
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer RenderTile
+//----------------------------------------------------------------------
+void tPointCloudRenderer::RenderTile(size_t tile, std::vector<float>& tile_depth, std::vector<uint32_t>& tile_pixels)
+{
+  const int tile_left = static_cast<int>((tile % tiles_x) * cTILE_SIZE), tile_top = static_cast<int>((tile / tiles_x) * cTILE_SIZE);
+  const int tile_width = std::min<int>(cTILE_SIZE, width - tile_left), tile_height = std::min<int>(cTILE_SIZE, height - tile_top);
+  std::fill(tile_depth.begin(), tile_depth.end(), std::numeric_limits<float>::infinity());
+  std::fill(tile_pixels.begin(), tile_pixels.end(), background);
+
+  // Lines first - then points in drawing order
+  const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y;
+  for (size_t set = 0; set <= thread_count; set++)
+  {
+    const std::vector<tSplat>& bin = bins[((set + thread_count) % (thread_count + 1)) * tile_count + tile];
+    for (const tSplat & splat : bin)
+    {
+      uint32_t color = splat.color | cALPHA_MASK;
+      int size = reinterpret_cast<const uint8_t*>(&splat.color)[3];
+      int x = splat.x - tile_left, y = splat.y - tile_top;
+      if (size == 1)
+      {
+        size_t index = y * cTILE_SIZE + x;
+        if (splat.depth < tile_depth[index])
+        {
+          tile_depth[index] = splat.depth;
+          tile_pixels[index] = color;
+        }
+        continue;
+      }
+      int x_begin = std::max(0, x), x_end = std::min(tile_width, x + size);
+      int y_begin = std::max(0, y), y_end = std::min(tile_height, y + size);
+      for (int row = y_begin; row < y_end; row++)
+      {
+        for (int column = x_begin; column < x_end; column++)
+        {
+          size_t index = row * cTILE_SIZE + column;
+          if (splat.depth < tile_depth[index])
+          {
+            tile_depth[index] = splat.depth;
+            tile_pixels[index] = color;
+          }
+        }
+      }
+    }
+  }
+
+  for (int row = 0; row < tile_height; row++)
+  {
+    size_t image_index = static_cast<size_t>(tile_top + row) * width + tile_left;
+    std::copy(&tile_pixels[row * cTILE_SIZE], &tile_pixels[row * cTILE_SIZE] + tile_width, &pixels[image_index]);
+    std::copy(&tile_depth[row * cTILE_SIZE], &tile_depth[row * cTILE_SIZE] + tile_width, &depth[image_index]);
+  }
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer SetBackground
+//----------------------------------------------------------------------
+void tPointCloudRenderer::SetBackground(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
+{
+  background = PackColor(r, g, b, alpha);
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer SetCamera
+//----------------------------------------------------------------------
+void tPointCloudRenderer::SetCamera(const double (&camera_to_world)[16], double focal_length_x, double focal_length_y, double principal_point_x, double principal_point_y)
+{
+  // Inverse of rigid transformation: transposed rotation - and rotated, negated translation
+  for (size_t row = 0; row < 3; row++)
+  {
+    for (size_t column = 0; column < 3; column++)
+    {
+      world_to_camera[row * 4 + column] = camera_to_world[column * 4 + row];
+    }
+    world_to_camera[row * 4 + 3] = -(camera_to_world[row] * camera_to_world[3] + camera_to_world[4 + row] * camera_to_world[7] + camera_to_world[8 + row] * camera_to_world[11]);
+  }
+  intrinsics[0] = focal_length_x;
+  intrinsics[1] = focal_length_y;
+  intrinsics[2] = principal_point_x;
+  intrinsics[3] = principal_point_y;
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer SetDepthRange
+//----------------------------------------------------------------------
+void tPointCloudRenderer::SetDepthRange(double near, double far)
+{
+  if (!(near > 0 && far >= near))
+  {
+    RRLIB_LOG_PRINT(ERROR, "Invalid depth range [", near, ", ", far, "]. Ignoring it.");
+    return;
+  }
+  this->near = near;
+  this->far = far;
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer SetPointSize
+//----------------------------------------------------------------------
+void tPointCloudRenderer::SetPointSize(unsigned int point_size)
+{
+  this->point_size = std::max(1u, std::min(255u, point_size));
+}
+
+//----------------------------------------------------------------------
+// tPointCloudRenderer SetSize
+//----------------------------------------------------------------------
+void tPointCloudRenderer::SetSize(unsigned int width, unsigned int height)
+{
+  if (width > 32767 || height > 32767)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Image size ", width, "x", height, " exceeds maximum of 32767x32767. Ignoring it.");
+    return;
+  }
+  this->width = width;
+  this->height = height;
+  pixels.assign(static_cast<size_t>(width) * height, background);
+  depth.assign(static_cast<size_t>(width) * height, std::numeric_limits<float>::infinity());
+  tiles_x = (width + cTILE_SIZE - 1) / cTILE_SIZE;
+  tiles_y = (height + cTILE_SIZE - 1) / cTILE_SIZE;
+  bins.clear();
+  bins.resize((thread_count + 1) * static_cast<size_t>(tiles_x) * tiles_y);
+}
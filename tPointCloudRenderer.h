@@ -0,0 +1,291 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tPointCloudRenderer.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tPointCloudRenderer
+ *
+ * \b tPointCloudRenderer
+ *
+ * Renders point clouds and lines of 3D canvases to RGBA images on the CPU.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tPointCloudRenderer_h__
+#define __rrlib__canvas__tPointCloudRenderer_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas3D.h"
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Point-splatting renderer for 3D canvases
+/*!
+ * Renders the content of a tCanvas3D as seen by a pinhole camera into a depth-tested RGBA8 image.
+ *
+ * Points of all point cloud commands (and DrawPoint()) are drawn as squares of SetPointSize() pixels.
+ * Line segments, line strips, arrows (without heads), polygon outlines and box edges are drawn one pixel wide.
+ * Transformations and colors are applied. Other commands (text, ellipsoids, curves, paths, infinite lines) are ignored.
+ *
+ * The camera frame is an optical frame: x points right, y down and z forward (as with OpenCV).
+ *
+ * Rendering works in two steps: First, points are projected by all threads (each projecting a contiguous
+ * part of all points) - and sorted into the image tiles they cover. Then, tiles are rasterized independently
+ * with their own small z-buffers. As tiles process points in drawing order, the result does not depend on
+ * the number of threads. Buffers are kept between calls - so a renderer object should be reused.
+ */
+class tPointCloudRenderer
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param width Width of image in pixels
+   * \param height Height of image in pixels
+   * \param thread_count Number of threads to use
+   */
+  tPointCloudRenderer(unsigned int width, unsigned int height, unsigned int thread_count = 1);
+
+  /*!
+   * \return Depth image of last call to Render(): z coordinate in camera frame of each pixel (infinity where nothing was drawn)
+   */
+  const float* GetDepthImage() const
+  {
+    return depth.data();
+  }
+
+  /*!
+   * \return Height of image in pixels
+   */
+  unsigned int GetHeight() const
+  {
+    return height;
+  }
+
+  /*!
+   * \return Image of last call to Render(): RGBA (one byte per channel), top row first, no padding between rows
+   */
+  const uint8_t* GetImage() const
+  {
+    return reinterpret_cast<const uint8_t*>(pixels.data());
+  }
+
+  /*!
+   * \return Width of image in pixels
+   */
+  unsigned int GetWidth() const
+  {
+    return width;
+  }
+
+  /*!
+   * Renders canvas
+   *
+   * \param canvas Canvas to render
+   */
+  void Render(const tCanvas3D& canvas);
+
+  /*!
+   * \param r Red component of background
+   * \param g Green component of background
+   * \param b Blue component of background
+   * \param alpha Alpha component of background (255 is opaque)
+   */
+  void SetBackground(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha = 255);
+
+  /*!
+   * Sets camera pose and intrinsics
+   *
+   * \param camera_to_world Pose of camera (optical frame) in canvas coordinates
+   * \param focal_length_x Focal length in pixels (x direction)
+   * \param focal_length_y Focal length in pixels (y direction)
+   * \param principal_point_x Principal point in pixels (x coordinate)
+   * \param principal_point_y Principal point in pixels (y coordinate)
+   */
+  template <typename T>
+  void SetCamera(const math::tMatrix<4, 4, T> &camera_to_world, double focal_length_x, double focal_length_y, double principal_point_x, double principal_point_y)
+  {
+    double matrix[16];
+    for (size_t i = 0; i < 16; i++)
+    {
+      matrix[i] = camera_to_world[i / 4][i % 4];
+    }
+    SetCamera(matrix, focal_length_x, focal_length_y, principal_point_x, principal_point_y);
+  }
+
+  void SetCamera(const math::tPose3D &camera_to_world, double focal_length_x, double focal_length_y, double principal_point_x, double principal_point_y)
+  {
+    SetCamera(camera_to_world.GetTransformationMatrix(), focal_length_x, focal_length_y, principal_point_x, principal_point_y);
+  }
+
+  /*!
+   * Only geometry with near <= z <= far (in camera frame) is drawn
+   *
+   * \param near Distance of near clipping plane (> 0)
+   * \param far Distance of far clipping plane
+   */
+  void SetDepthRange(double near, double far);
+
+  /*!
+   * \param point_size Edge length of point splats in pixels (1 to 255)
+   */
+  void SetPointSize(unsigned int point_size);
+
+  /*!
+   * \param width Width of image in pixels
+   * \param height Height of image in pixels
+   */
+  void SetSize(unsigned int width, unsigned int height);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Pixel (or square of pixels) to draw */
+  struct tSplat
+  {
+    /*! Top left pixel */
+    int16_t x, y;
+
+    /*! z coordinate in camera frame */
+    float depth;
+
+    /*! RGB bytes as stored in image - with splat size in last byte */
+    uint32_t color;
+  };
+
+  /*! Point cloud command (or part of it) to project */
+  struct tPointJob
+  {
+    tCanvasCommand command;
+
+    /*! Projection of canvas coordinates to pixel coordinates (3x4 matrix, row-major) */
+    double projection[12];
+
+    /*! Color of points without their own color */
+    uint32_t color;
+
+    /*! Number of points */
+    size_t count;
+  };
+
+  unsigned int width, height;
+
+  unsigned int thread_count;
+
+  /*! Number of tiles in x and y direction */
+  unsigned int tiles_x, tiles_y;
+
+  /*! Image (one RGBA pixel per element) and depth image */
+  std::vector<uint32_t> pixels;
+  std::vector<float> depth;
+
+  uint32_t background;
+
+  /*! Transformation from canvas coordinates to camera frame (3x4 matrix, row-major) */
+  double world_to_camera[12];
+
+  /*! Intrinsics: focal lengths and principal point */
+  double intrinsics[4];
+
+  double near, far;
+
+  unsigned int point_size;
+
+  /*! Point cloud commands of current canvas */
+  std::vector<tPointJob> jobs;
+
+  /*!
+   * Splats of each tile: sets of (tiles_x * tiles_y) vectors - one set per thread (points) - and one for lines (last set)
+   * Splats in each vector are in drawing order.
+   */
+  std::vector<std::vector<tSplat>> bins;
+
+  /*!
+   * Adds splat to bins of all tiles it covers
+   *
+   * \param tile_bins First bin of the respective set
+   */
+  void AddSplat(std::vector<tSplat>* tile_bins, int x, int y, float z, uint32_t color, unsigned int size) const;
+
+  /*!
+   * Adds splats of line segment (in canvas coordinates) to line bins
+   *
+   * \param transformation Transformation from canvas coordinates to camera frame
+   */
+  void AddLineSegment(const double (&transformation)[12], const double* p1, const double* p2, uint32_t color);
+
+  /*!
+   * Projects points [first, last) of job and adds splats to bins
+   */
+  void ProjectPoints(const tPointJob& job, size_t first, size_t last, std::vector<tSplat>* tile_bins) const;
+
+  /*!
+   * Rasterizes tile with the specified index
+   *
+   * \param tile_depth Buffer for z-buffer of tile
+   * \param tile_pixels Buffer for pixels of tile
+   */
+  void RenderTile(size_t tile, std::vector<float>& tile_depth, std::vector<uint32_t>& tile_pixels);
+
+  void SetCamera(const double (&camera_to_world)[16], double focal_length_x, double focal_length_y, double principal_point_x, double principal_point_y);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
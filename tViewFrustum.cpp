@@ -0,0 +1,126 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tViewFrustum.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tViewFrustum.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+
+#include "rrlib/logging/messages.h"
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tViewFrustum constructors
+//----------------------------------------------------------------------
+tViewFrustum::tViewFrustum() :
+  planes(),
+  plane_count(0)
+{}
+
+//----------------------------------------------------------------------
+// tViewFrustum AddPlane
+//----------------------------------------------------------------------
+void tViewFrustum::AddPlane(double a, double b, double c, double d)
+{
+  if (plane_count >= cMAX_PLANES)
+  {
+    RRLIB_LOG_PRINT(ERROR, "Frustum already has ", cMAX_PLANES, " planes. Plane is ignored.");
+    return;
+  }
+  double* p = planes[plane_count];
+  p[0] = a;
+  p[1] = b;
+  p[2] = c;
+  p[3] = d;
+  plane_count++;
+}
+
+//----------------------------------------------------------------------
+// tViewFrustum FromRectangle
+//----------------------------------------------------------------------
+tViewFrustum tViewFrustum::FromRectangle(double bottom_left_x, double bottom_left_y, double width, double height)
+{
+  double left = std::min(bottom_left_x, bottom_left_x + width);
+  double right = std::max(bottom_left_x, bottom_left_x + width);
+  double bottom = std::min(bottom_left_y, bottom_left_y + height);
+  double top = std::max(bottom_left_y, bottom_left_y + height);
+  tViewFrustum result;
+  result.AddPlane(1, 0, 0, -left);
+  result.AddPlane(-1, 0, 0, right);
+  result.AddPlane(0, 1, 0, -bottom);
+  result.AddPlane(0, -1, 0, top);
+  return result;
+}
+
+//----------------------------------------------------------------------
+// tViewFrustum Transformed
+//----------------------------------------------------------------------
+tViewFrustum tViewFrustum::Transformed(const internal::tAffineTransformation& transformation) const
+{
+  // Plane p and transformation M: p * (M * x) = (M^T * p) * x
+  tViewFrustum result;
+  for (size_t i = 0; i < plane_count; i++)
+  {
+    const double* p = planes[i];
+    double transformed[4];
+    for (size_t column = 0; column < 4; column++)
+    {
+      transformed[column] = p[0] * transformation.Get(0, column) + p[1] * transformation.Get(1, column) + p[2] * transformation.Get(2, column);
+    }
+    transformed[3] += p[3];
+    result.AddPlane(transformed[0], transformed[1], transformed[2], transformed[3]);
+  }
+  return result;
+}
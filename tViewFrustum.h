@@ -0,0 +1,189 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tViewFrustum.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tViewFrustum
+ *
+ * \b tViewFrustum
+ *
+ * Convex volume (intersection of half-spaces) that is used for culling.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tViewFrustum_h__
+#define __rrlib__canvas__tViewFrustum_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+
+#include "rrlib/math/tMatrix.h"
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/internal/tAffineTransformation.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! View frustum
+/*!
+ * Intersection of up to six half-spaces a * x + b * y + c * z + d >= 0.
+ * A frustum without planes contains everything.
+ *
+ * Used by tCanvas2D and tCanvas3D to cull primitives that are not visible.
+ * 2D viewports are frustums with four planes that do not depend on z.
+ */
+class tViewFrustum
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Maximum number of planes */
+  static const size_t cMAX_PLANES = 6;
+
+  tViewFrustum();
+
+  /*!
+   * Adds plane - points p with a * p.x + b * p.y + c * p.z + d >= 0 are inside
+   * (planes beyond cMAX_PLANES are ignored)
+   */
+  void AddPlane(double a, double b, double c, double d);
+
+  /*!
+   * \return Whether point is inside frustum
+   */
+  bool Contains(double x, double y, double z) const
+  {
+    for (size_t i = 0; i < plane_count; i++)
+    {
+      const double* p = planes[i];
+      if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * Creates frustum of 2D viewport (rectangle in x-y plane)
+   */
+  static tViewFrustum FromRectangle(double bottom_left_x, double bottom_left_y, double width, double height);
+
+  /*!
+   * Creates frustum from view-projection matrix
+   * (points p are visible if -w <= x, y, z <= w for (x, y, z, w) = matrix * (p, 1) - as in OpenGL clip space)
+   *
+   * \param view_projection Product of projection matrix and view matrix
+   */
+  template <typename T>
+  static tViewFrustum FromViewProjection(const math::tMatrix<4, 4, T> &view_projection)
+  {
+    tViewFrustum result;
+    for (size_t row = 0; row < 3; row++)
+    {
+      for (int sign = 1; sign >= -1; sign -= 2)
+      {
+        result.AddPlane(view_projection[3][0] + sign * view_projection[row][0], view_projection[3][1] + sign * view_projection[row][1],
+                        view_projection[3][2] + sign * view_projection[row][2], view_projection[3][3] + sign * view_projection[row][3]);
+      }
+    }
+    return result;
+  }
+
+  size_t GetPlaneCount() const
+  {
+    return plane_count;
+  }
+
+  /*!
+   * Conservative test whether axis-aligned box intersects frustum
+   * (box is only reported outside if it is completely outside one of the planes)
+   *
+   * \param min Minimum corner of box
+   * \param max Maximum corner of box
+   */
+  bool IntersectsBox(const double(&min)[3], const double(&max)[3]) const
+  {
+    for (size_t i = 0; i < plane_count; i++)
+    {
+      const double* p = planes[i];
+      double distance = p[3] + p[0] * (p[0] >= 0 ? max[0] : min[0]) + p[1] * (p[1] >= 0 ? max[1] : min[1]) + p[2] * (p[2] >= 0 ? max[2] : min[2]);
+      if (distance < 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \param transformation Transformation from local to frustum coordinates
+   * \return Frustum in local coordinates (for testing untransformed points)
+   */
+  tViewFrustum Transformed(const internal::tAffineTransformation& transformation) const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Planes (a, b, c, d) */
+  double planes[cMAX_PLANES][4];
+
+  /*! Number of planes */
+  size_t plane_count;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#endif
@@ -0,0 +1,241 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tVoxelGridFilter.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * \brief Contains tVoxelGridFilter
+ *
+ * \b tVoxelGridFilter
+ *
+ * Downsamples point clouds before they are drawn to a tCanvas3D.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__canvas__tVoxelGridFilter_h__
+#define __rrlib__canvas__tVoxelGridFilter_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "rrlib/math/tVector.h"
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Point that represents all points inside a voxel
+ */
+enum tVoxelRepresentative
+{
+  eVOXEL_CENTROID,    //!< Centroid of all points in voxel
+  eVOXEL_FIRST_POINT  //!< First point (in input order) inside voxel
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Voxel grid filter for point clouds
+/*!
+ * Reduces a point cloud to one representative point per occupied voxel.
+ * Voxels are stored in a hash map - so filtering is a single O(n) pass over
+ * the input and memory usage only depends on the number of occupied voxels.
+ *
+ * With multiple threads, the input is split into one chunk per thread.
+ * The partial voxel maps are merged afterwards. The result contains the same voxels
+ * in the same order as with single-threaded filtering (voxels are ordered by their first point).
+ * Centroids are equal up to rounding (partial sums are added in a different order).
+ *
+ * Hash maps and buffers are kept between calls - so a filter object should be
+ * reused when point clouds are filtered repeatedly.
+ */
+class tVoxelGridFilter
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param voxel_size Edge length of voxels
+   * \param representative Point that represents all points inside a voxel
+   * \param thread_count Number of threads to use (input must be random access for more than one thread)
+   */
+  inline tVoxelGridFilter(double voxel_size, tVoxelRepresentative representative = eVOXEL_CENTROID, unsigned int thread_count = 1);
+
+  /*!
+   * Filters point cloud
+   * Afterwards, representative points can be obtained via GetPoint().
+   *
+   * \param points_begin Iterator to first point (e.g. math::tVector<3, TElement>)
+   * \param points_end Iterator past last point
+   */
+  template <typename TIterator>
+  void Filter(TIterator points_begin, TIterator points_end);
+
+  /*!
+   * Filters point cloud
+   *
+   * \param points_begin Iterator to first point (e.g. math::tVector<3, TElement>)
+   * \param points_end Iterator past last point
+   * \param result Vector to store representative points in (is cleared first)
+   */
+  template <typename TIterator, typename TElement>
+  void Filter(TIterator points_begin, TIterator points_end, std::vector<math::tVector<3, TElement>> &result);
+
+  /*!
+   * \param index Index of occupied voxel (< GetVoxelCount())
+   * \return Representative point of voxel from last call to Filter()
+   */
+  template <typename TElement>
+  inline math::tVector<3, TElement> GetPoint(size_t index) const;
+
+  /*!
+   * \return Number of occupied voxels in last call to Filter()
+   */
+  size_t GetVoxelCount() const
+  {
+    return voxel_maps.empty() ? 0 : voxel_maps[0].voxels.size();
+  }
+
+  tVoxelRepresentative GetRepresentative() const
+  {
+    return representative;
+  }
+
+  unsigned int GetThreadCount() const
+  {
+    return thread_count;
+  }
+
+  double GetVoxelSize() const
+  {
+    return voxel_size;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Integer coordinates of voxel */
+  struct tVoxelKey
+  {
+    int64_t x, y, z;
+
+    bool operator==(const tVoxelKey& other) const
+    {
+      return x == other.x && y == other.y && z == other.z;
+    }
+  };
+
+  struct tVoxelKeyHash
+  {
+    size_t operator()(const tVoxelKey& key) const
+    {
+      return static_cast<size_t>((static_cast<uint64_t>(key.x) * 73856093u) ^ (static_cast<uint64_t>(key.y) * 19349663u) ^ (static_cast<uint64_t>(key.z) * 83492791u));
+    }
+  };
+
+  /*! Accumulated points of a single voxel */
+  struct tVoxel
+  {
+    tVoxelKey key;
+    double sum[3];
+    double first[3];
+    size_t count;
+  };
+
+  /*! Voxels of (part of) point cloud - ordered by first point */
+  struct tVoxelMap
+  {
+    std::unordered_map<tVoxelKey, size_t, tVoxelKeyHash> index;
+    std::vector<tVoxel> voxels;
+
+    void Clear()
+    {
+      index.clear();
+      voxels.clear();
+    }
+  };
+
+  double voxel_size;
+
+  tVoxelRepresentative representative;
+
+  unsigned int thread_count;
+
+  /*! One voxel map per thread */
+  std::vector<tVoxelMap> voxel_maps;
+
+  /*!
+   * Adds points to voxel map
+   */
+  template <typename TIterator>
+  void AddPoints(TIterator points_begin, TIterator points_end, tVoxelMap& voxel_map) const;
+
+  /*!
+   * Adds voxel to voxel map (merging it with any existing voxel)
+   */
+  inline void AddVoxel(const tVoxel& voxel, tVoxelMap& voxel_map) const;
+
+  template <typename TIterator>
+  void FillVoxelMaps(TIterator points_begin, TIterator points_end, std::random_access_iterator_tag);
+
+  template <typename TIterator>
+  void FillVoxelMaps(TIterator points_begin, TIterator points_end, std::forward_iterator_tag);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+#include "rrlib/canvas/tVoxelGridFilter.hpp"
+
+#endif
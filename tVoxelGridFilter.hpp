@@ -0,0 +1,230 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tVoxelGridFilter.hpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <thread>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace canvas
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter constructors
+//----------------------------------------------------------------------
+tVoxelGridFilter::tVoxelGridFilter(double voxel_size, tVoxelRepresentative representative, unsigned int thread_count) :
+  voxel_size(voxel_size),
+  representative(representative),
+  thread_count(std::max(1u, thread_count)),
+  voxel_maps()
+{
+  assert(voxel_size > 0);
+}
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter AddPoints
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tVoxelGridFilter::AddPoints(TIterator points_begin, TIterator points_end, tVoxelMap& voxel_map) const
+{
+  const double inverse_voxel_size = 1.0 / voxel_size;
+  for (TIterator it = points_begin; it != points_end; ++it)
+  {
+    double point[3] = { static_cast<double>((*it)[0]), static_cast<double>((*it)[1]), static_cast<double>((*it)[2]) };
+    if (!(std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])))
+    {
+      continue;
+    }
+    tVoxelKey key =
+    {
+      static_cast<int64_t>(std::floor(point[0] * inverse_voxel_size)),
+      static_cast<int64_t>(std::floor(point[1] * inverse_voxel_size)),
+      static_cast<int64_t>(std::floor(point[2] * inverse_voxel_size))
+    };
+    auto insertion = voxel_map.index.insert(std::make_pair(key, voxel_map.voxels.size()));
+    if (insertion.second)
+    {
+      tVoxel voxel = { key, { point[0], point[1], point[2] }, { point[0], point[1], point[2] }, 1 };
+      voxel_map.voxels.push_back(voxel);
+    }
+    else
+    {
+      tVoxel& voxel = voxel_map.voxels[insertion.first->second];
+      voxel.sum[0] += point[0];
+      voxel.sum[1] += point[1];
+      voxel.sum[2] += point[2];
+      voxel.count++;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter AddVoxel
+//----------------------------------------------------------------------
+void tVoxelGridFilter::AddVoxel(const tVoxel& voxel, tVoxelMap& voxel_map) const
+{
+  auto insertion = voxel_map.index.insert(std::make_pair(voxel.key, voxel_map.voxels.size()));
+  if (insertion.second)
+  {
+    voxel_map.voxels.push_back(voxel);
+  }
+  else
+  {
+    tVoxel& existing = voxel_map.voxels[insertion.first->second];
+    existing.sum[0] += voxel.sum[0];
+    existing.sum[1] += voxel.sum[1];
+    existing.sum[2] += voxel.sum[2];
+    existing.count += voxel.count;
+  }
+}
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter FillVoxelMaps
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tVoxelGridFilter::FillVoxelMaps(TIterator points_begin, TIterator points_end, std::random_access_iterator_tag)
+{
+  const size_t cMIN_POINTS_PER_THREAD = 10000;
+  size_t point_count = points_end - points_begin;
+  size_t threads = std::max<size_t>(1, std::min<size_t>(thread_count, point_count / cMIN_POINTS_PER_THREAD));
+  voxel_maps.resize(std::max<size_t>(voxel_maps.size(), threads));
+  if (threads == 1)
+  {
+    AddPoints(points_begin, points_end, voxel_maps[0]);
+    return;
+  }
+
+  // Fill one voxel map per chunk (the calling thread processes the first chunk)
+  size_t chunk_size = (point_count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; i++)
+  {
+    size_t first = std::min(point_count, i * chunk_size);
+    size_t last = std::min(point_count, first + chunk_size);
+    workers.emplace_back([this, points_begin, first, last, i]()
+    {
+      AddPoints(points_begin + first, points_begin + last, voxel_maps[i]);
+    });
+  }
+  AddPoints(points_begin, points_begin + std::min(point_count, chunk_size), voxel_maps[0]);
+  for (std::thread & worker : workers)
+  {
+    worker.join();
+  }
+
+  // Merge voxel maps in chunk order (keeps voxels ordered by their first point)
+  for (size_t i = 1; i < threads; i++)
+  {
+    for (const tVoxel & voxel : voxel_maps[i].voxels)
+    {
+      AddVoxel(voxel, voxel_maps[0]);
+    }
+  }
+}
+
+template <typename TIterator>
+void tVoxelGridFilter::FillVoxelMaps(TIterator points_begin, TIterator points_end, std::forward_iterator_tag)
+{
+  voxel_maps.resize(std::max<size_t>(voxel_maps.size(), 1));
+  AddPoints(points_begin, points_end, voxel_maps[0]);
+}
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter Filter
+//----------------------------------------------------------------------
+template <typename TIterator>
+void tVoxelGridFilter::Filter(TIterator points_begin, TIterator points_end)
+{
+  for (tVoxelMap & voxel_map : voxel_maps)
+  {
+    voxel_map.Clear();
+  }
+  FillVoxelMaps(points_begin, points_end, typename std::iterator_traits<TIterator>::iterator_category());
+}
+
+template <typename TIterator, typename TElement>
+void tVoxelGridFilter::Filter(TIterator points_begin, TIterator points_end, std::vector<math::tVector<3, TElement>> &result)
+{
+  Filter(points_begin, points_end);
+  result.clear();
+  result.reserve(GetVoxelCount());
+  for (size_t i = 0; i < GetVoxelCount(); i++)
+  {
+    result.push_back(GetPoint<TElement>(i));
+  }
+}
+
+//----------------------------------------------------------------------
+// tVoxelGridFilter GetPoint
+//----------------------------------------------------------------------
+template <typename TElement>
+math::tVector<3, TElement> tVoxelGridFilter::GetPoint(size_t index) const
+{
+  const tVoxel& voxel = voxel_maps[0].voxels[index];
+  if (representative == eVOXEL_CENTROID)
+  {
+    return math::tVector<3, TElement>(voxel.sum[0] / voxel.count, voxel.sum[1] / voxel.count, voxel.sum[2] / voxel.count);
+  }
+  return math::tVector<3, TElement>(voxel.first[0], voxel.first[1], voxel.first[2]);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,237 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/canvas_compression.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of compressed canvas serialization (tCanvas::SetCompression()).
+ *
+ * Canvases are serialized with each codec, deserialized again - and serialized
+ * without compression. This must yield the same bytes as serializing the original
+ * canvas without compression (including the default viewport offset).
+ * Covered are an empty canvas, a 2D canvas with default viewport that spans several
+ * compression blocks and a 3D point cloud. Codecs that are not available in this build
+ * must be rejected by SetCompression() - the canvas is then serialized uncompressed.
+ * Truncated compressed data must yield an empty canvas.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * \return Serialized canvas (including leading size)
+ */
+std::string Serialize(const tCanvas& canvas)
+{
+  rrlib::serialization::tMemoryBuffer buffer;
+  rrlib::serialization::tOutputStream stream(buffer);
+  stream << canvas;
+  stream.Flush();
+  return std::string(buffer.GetBufferPointer(0), buffer.GetSize());
+}
+
+/*!
+ * Deserializes canvas
+ */
+void Deserialize(const std::string& data, tCanvas& canvas)
+{
+  rrlib::serialization::tInputStream input(data.data(), data.size());
+  input >> canvas;
+}
+
+/*!
+ * Draws a point (so that canvas is not empty)
+ */
+void DrawPoint(tCanvas2D& canvas)
+{
+  canvas.DrawPoint(1.0, 1.0);
+}
+
+void DrawPoint(tCanvas3D& canvas)
+{
+  canvas.DrawPoint(1.0, 1.0, 1.0);
+}
+
+/*!
+ * Serializes canvas with each codec, deserializes it and compares it with original
+ */
+template <typename TCanvas>
+void TestRoundTrip(const char* test, TCanvas& canvas)
+{
+  const tCompression cCODECS[] = { eNO_COMPRESSION, eLZ4, eZSTD };
+  const char* cCODEC_NAMES[] = { "none", "LZ4", "zstd" };
+  bool cAVAILABLE[] = { true, false, false };
+#ifdef _LIB_LZ4_PRESENT_
+  cAVAILABLE[1] = true;
+#endif
+#ifdef _LIB_ZSTD_PRESENT_
+  cAVAILABLE[2] = true;
+#endif
+
+  canvas.SetCompression(eNO_COMPRESSION);
+  const std::string uncompressed = Serialize(canvas);
+  for (size_t i = 0; i < 3; i++)
+  {
+    std::string name = std::string(test) + " (" + cCODEC_NAMES[i] + ")";
+    bool available = canvas.SetCompression(cCODECS[i]);
+    Check(available == cAVAILABLE[i], name.c_str(), "unexpected availability of codec");
+    Check(canvas.GetCompression() == (available ? cCODECS[i] : eNO_COMPRESSION), name.c_str(), "unexpected codec");
+    const std::string serialized = Serialize(canvas);
+    canvas.SetCompression(eNO_COMPRESSION);
+    if (available && i > 0)
+    {
+      Check(serialized.size() > 8 && serialized[8] == static_cast<char>(eCOMPRESSED), name.c_str(), "canvas is not compressed");
+    }
+    else
+    {
+      Check(serialized == uncompressed, name.c_str(), "canvas is not serialized uncompressed");
+    }
+
+    TCanvas decoded;
+    Deserialize(serialized, decoded);
+    Check(Serialize(decoded) == uncompressed, name.c_str(), "decoded canvas differs from original");
+
+    // Decoded canvas can be serialized with compression again
+    if (available)
+    {
+      decoded.SetCompression(cCODECS[i]);
+      Check(Serialize(decoded) == serialized, name.c_str(), "serializing decoded canvas yields different data");
+    }
+
+    // Truncated compressed data
+    if (available && i > 0 && serialized.size() > 40)
+    {
+      std::string truncated = serialized.substr(0, serialized.size() - 20);
+      uint64_t size = truncated.size() - 8;
+      for (size_t j = 0; j < 8; j++)
+      {
+        truncated[j] = static_cast<char>(size >> (8 * j));
+      }
+      TCanvas truncated_canvas;
+      DrawPoint(truncated_canvas);
+      Deserialize(truncated, truncated_canvas);
+      Check(truncated_canvas.GetSize() == 0, name.c_str(), "truncated data does not yield empty canvas");
+    }
+  }
+}
+
+}
+
+int main()
+{
+  tCanvas2D empty;
+  TestRoundTrip("empty canvas", empty);
+
+  // Occupancy grid map with trajectory (more than one compression block)
+  tCanvas2D map;
+  map.SetDefaultViewport(0.0, 0.0, 50.0, 50.0);
+  map.SetFill(true);
+  for (size_t y = 0; y < 300; y++)
+  {
+    for (size_t x = 0; x < 300; x++)
+    {
+      if ((x / 7 + y / 5) % 3 == 0)
+      {
+        map.SetColor((x * y) % 2 ? 0 : 128, 0, 0);
+        map.DrawBox(x * 0.2f, y * 0.2f, 0.2f, 0.2f);
+      }
+    }
+  }
+  std::vector<tVector<2, float>> trajectory;
+  for (size_t i = 0; i < 5000; i++)
+  {
+    trajectory.push_back(tVector<2, float>(25 + 20 * std::cos(i * 0.001f), 25 + 20 * std::sin(i * 0.0013f)));
+  }
+  map.DrawLineStrip(trajectory.begin(), trajectory.end());
+  Check(map.GetSize() > 2 * 128 * 1024, "2D map", "canvas does not span several compression blocks");
+  TestRoundTrip("2D map", map);
+
+  // Point cloud
+  tCanvas3D cloud;
+  std::vector<tVector<3, float>> points;
+  for (size_t i = 0; i < 20000; i++)
+  {
+    points.push_back(tVector<3, float>(std::cos(i * 0.01f) * 5, std::sin(i * 0.01f) * 5, i * 0.0001f));
+  }
+  cloud.DrawPointCloud(points.begin(), points.end());
+  TestRoundTrip("3D point cloud", cloud);
+
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
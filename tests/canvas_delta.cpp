@@ -0,0 +1,300 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/canvas_delta.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of tCanvasDeltaEncoder and tCanvasDeltaDecoder.
+ *
+ * A sequence of frames (a static scene with a few moving objects) is delta encoded
+ * and decoded again. Every decoded frame must contain exactly the commands of the
+ * original frame. Checked are keyframes, delta frames with eDELTA_COPY commands
+ * (they must be much smaller than the frame), forced keyframes, frames that differ
+ * completely from their predecessor, 3D canvases - and that a delta frame is rejected
+ * if its previous frame was not decoded (until the next keyframe arrives).
+ * Decoded canvases with transformation folding must draw subsequent commands with
+ * their own transformation.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasDelta.h"
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * \return Bytes of all commands in canvas (checks that canvas is well-formed)
+ */
+template <typename TCanvas>
+std::string CommandBytes(const char* test, const TCanvas& canvas)
+{
+  std::string bytes;
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  while (reader.Next(command))
+  {
+    bytes.append(command.begin, command.end);
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  return bytes;
+}
+
+/*!
+ * Draws frame of 2D scene: static boxes and polygon - and a robot that moves with frame number
+ */
+void DrawFrame(tCanvas2D& canvas, size_t frame)
+{
+  canvas.Clear();
+  canvas.SetFill(true);
+  for (size_t i = 0; i < 200; i++)
+  {
+    canvas.SetColor(i % 7 * 30, 100, 200);
+    canvas.DrawBox(i * 0.5, (i % 13) * 0.5, 0.4, 0.4);
+  }
+  canvas.DrawPolygon(tVector<2, double>(0, 0), tVector<2, double>(10, 0), tVector<2, double>(10, 10));
+
+  canvas.SetColor(255, 0, 0);
+  canvas.DrawPoint(std::cos(frame * 0.1), std::sin(frame * 0.1));
+  if (frame % 3 == 0)
+  {
+    canvas.DrawText(1.0, 2.0, "every third frame");
+  }
+  for (size_t i = 0; i < 100; i++)
+  {
+    canvas.DrawLine(i * 0.1, 0.0, i * 0.1, 5.0);
+  }
+}
+
+/*!
+ * Encodes frame, decodes it and compares decoded frame with original
+ *
+ * \return Size of encoded frame
+ */
+template <typename TCanvas>
+size_t RoundTrip(const char* test, tCanvasDeltaEncoder& encoder, tCanvasDeltaDecoder& decoder, const TCanvas& canvas, bool expect_keyframe)
+{
+  rrlib::serialization::tMemoryBuffer buffer;
+  rrlib::serialization::tOutputStream stream(buffer);
+  size_t size = encoder.Encode(stream, canvas);
+  stream.Flush();
+  Check(encoder.LastFrameWasKeyframe() == expect_keyframe, test, expect_keyframe ? "expected keyframe" : "expected delta frame");
+
+  TCanvas decoded;
+  rrlib::serialization::tInputStream input(buffer);
+  Check(decoder.Decode(input, decoded), test, "frame could not be decoded");
+  Check(CommandBytes(test, decoded) == CommandBytes(test, canvas), test, "decoded frame differs from original");
+  return size;
+}
+
+void TestSequence()
+{
+  const char* test = "frame sequence";
+  tCanvasDeltaEncoder encoder(10);
+  tCanvasDeltaDecoder decoder;
+  tCanvas2D canvas;
+  for (size_t frame = 0; frame < 25; frame++)
+  {
+    DrawFrame(canvas, frame);
+    if (frame == 15)
+    {
+      encoder.ForceKeyframe();
+    }
+    bool keyframe = frame == 0 || frame == 10 || frame == 15;
+    size_t size = RoundTrip(test, encoder, decoder, canvas, keyframe);
+    if (!keyframe)
+    {
+      Check(size * 10 < canvas.GetSize(), test, "delta frame is not much smaller than frame");
+    }
+  }
+
+  // Frame that has nothing in common with previous frame
+  canvas.Clear();
+  canvas.DrawPoint(100.0, 100.0);
+  RoundTrip("completely different frame", encoder, decoder, canvas, true);
+
+  // Empty frame (delta frame header is larger than frame)
+  canvas.Clear();
+  RoundTrip("empty frame", encoder, decoder, canvas, true);
+}
+
+void TestMissingFrame()
+{
+  const char* test = "missing frame";
+  tCanvasDeltaEncoder encoder(10);
+  tCanvasDeltaDecoder decoder;
+  tCanvas2D canvas;
+  DrawFrame(canvas, 0);
+  RoundTrip(test, encoder, decoder, canvas, true);
+
+  // Frame 1 is lost - so frame 2 cannot be decoded
+  rrlib::serialization::tMemoryBuffer buffer;
+  rrlib::serialization::tOutputStream stream(buffer);
+  DrawFrame(canvas, 1);
+  encoder.Encode(stream, canvas);
+  stream.Reset(buffer);
+  DrawFrame(canvas, 2);
+  encoder.Encode(stream, canvas);
+  stream.Flush();
+  tCanvas2D decoded;
+  rrlib::serialization::tInputStream input(buffer);
+  Check(!decoder.Decode(input, decoded), test, "delta frame to missing frame was decoded");
+
+  // Decoder waits for next keyframe
+  DrawFrame(canvas, 3);
+  encoder.ForceKeyframe();
+  RoundTrip(test, encoder, decoder, canvas, true);
+  DrawFrame(canvas, 4);
+  RoundTrip(test, encoder, decoder, canvas, false);
+}
+
+void Test3D()
+{
+  const char* test = "3D canvas";
+  tCanvasDeltaEncoder encoder(10);
+  tCanvasDeltaDecoder decoder;
+  tCanvas3D canvas;
+  std::vector<tVector<3, float>> points;
+  for (size_t i = 0; i < 1000; i++)
+  {
+    points.push_back(tVector<3, float>(i * 0.01f, std::sin(i * 0.01f), 1.0f));
+  }
+  for (size_t frame = 0; frame < 5; frame++)
+  {
+    canvas.Clear();
+    canvas.DrawPointCloud(points.begin(), points.end());
+    canvas.SetColor(0, 255, 0);
+    canvas.DrawBox(frame * 1.0, 0.0, 0.0, 1.0, 1.0, 1.0);
+    RoundTrip(test, encoder, decoder, canvas, frame == 0);
+  }
+}
+
+void TestTransformationFolding()
+{
+  const char* test = "transformation folding";
+  tCanvasDeltaEncoder encoder(10);
+  tCanvasDeltaDecoder decoder;
+  tCanvas2D canvas;
+  canvas.Translate(5.0, 5.0);
+  canvas.DrawPoint(1.0, 1.0);
+  canvas.SetColor(255, 0, 0);
+
+  rrlib::serialization::tMemoryBuffer buffer;
+  rrlib::serialization::tOutputStream stream(buffer);
+  encoder.Encode(stream, canvas);
+  stream.Flush();
+  tCanvas2D decoded;
+  decoded.SetTransformationFolding(true);
+  rrlib::serialization::tInputStream input(buffer);
+  Check(decoder.Decode(input, decoded), test, "frame could not be decoded");
+
+  // Decoded commands leave translation and color behind: canvas must not rely on its own state
+  decoded.SetColor(255, 0, 0);
+  decoded.DrawPoint(2.0, 2.0);
+  tCanvasReader reader(decoded);
+  tCanvasCommand command;
+  bool reset_transformation = false, color_set = false;
+  size_t points = 0;
+  while (reader.Next(command))
+  {
+    if (command.opcode == eDRAW_POINT)
+    {
+      points++;
+    }
+    if (points == 1 && command.opcode == eRESET_TRANSFORMATION)
+    {
+      reset_transformation = true;
+    }
+    if (points == 1 && command.opcode == eSET_COLOR)
+    {
+      color_set = true;
+    }
+  }
+  Check(points == 2, test, "expected two points");
+  Check(reset_transformation, test, "transformation of decoded frame is not reset before appended commands");
+  Check(color_set, test, "color of decoded frame is assumed to be known");
+}
+
+}
+
+int main()
+{
+  TestSequence();
+  TestMissingFrame();
+  Test3D();
+  TestTransformationFolding();
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,222 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/canvas_shard_set.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Test of tCanvasShardSet::Publish().
+ *
+ * Two shards draw points with different transformations (and one of them with its own
+ * color and Z). The published canvas is interpreted with tCanvasReader - and every point
+ * is checked to be drawn with the transformation, color and Z of its own shard (or of
+ * the canvas, if the shard did not set them). The result must not depend on the order
+ * of the shards - and commands appended to the canvas after Publish() must not be
+ * affected by the shards. This is tested with and without transformation folding.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <tuple>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvasShardSet.h"
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*! Point as drawn: x, y (transformed), red, green, blue, z */
+typedef std::tuple<double, double, int, int, int, double> tDrawnPoint;
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * Interprets canvas (translations, colors, Z and points only)
+ *
+ * \return Drawn points in canvas order
+ */
+std::vector<tDrawnPoint> Interpret(const char* test, const tCanvas2D& canvas)
+{
+  std::vector<tDrawnPoint> points;
+  double translation[2] = { 0, 0 };
+  int color[3] = { 0, 0, 0 };
+  double z = 0;
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  while (reader.Next(command))
+  {
+    switch (command.opcode)
+    {
+    case eTRANSLATE:
+      translation[0] += command.values.Get<double>(0);
+      translation[1] += command.values.Get<double>(1);
+      break;
+    case eSET_TRANSFORMATION:
+      translation[0] = command.values.Get<double>(4);
+      translation[1] = command.values.Get<double>(5);
+      break;
+    case eRESET_TRANSFORMATION:
+      translation[0] = translation[1] = 0;
+      break;
+    case eSET_COLOR:
+    case eSET_EDGE_COLOR:
+      for (size_t i = 0; i < 3; i++)
+      {
+        color[i] = command.values.Get<uint8_t>(i);
+      }
+      break;
+    case eSET_FILL_COLOR:
+      break;
+    case eSET_Z:
+      z = command.values.Get<double>(0);
+      break;
+    case eDRAW_POINT:
+      points.push_back(tDrawnPoint(command.values.Get<double>(0) + translation[0], command.values.Get<double>(1) + translation[1], color[0], color[1], color[2], z));
+      break;
+    default:
+      Check(false, test, "unexpected command");
+    }
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  return points;
+}
+
+/*!
+ * Draws shard with its own transformation, color and Z
+ */
+void DrawRedShard(tCanvas2D& shard)
+{
+  shard.SetColor(255, 0, 0);
+  shard.SetZ(1.0);
+  shard.Translate(10.0, 0.0);
+  shard.DrawPoint(1.0, 1.0);
+}
+
+/*!
+ * Draws shard with its own transformation - but with color and Z of canvas
+ */
+void DrawPlainShard(tCanvas2D& shard)
+{
+  shard.Translate(0.0, 20.0);
+  shard.DrawPoint(1.0, 1.0);
+}
+
+/*!
+ * Draws to canvas, publishes shards and draws to canvas again
+ *
+ * \param red_shard_first Whether red shard is the first shard
+ * \param folding Whether transformation folding is enabled on canvas
+ * \return Drawn points in canvas order
+ */
+std::vector<tDrawnPoint> Publish(const char* test, bool red_shard_first, bool folding)
+{
+  tCanvas2D canvas;
+  canvas.SetTransformationFolding(folding);
+  canvas.SetColor(0, 0, 255);
+  canvas.SetZ(0.5);
+  canvas.Translate(100.0, 100.0);
+  canvas.DrawPoint(0.0, 0.0);
+
+  tCanvasShardSet2D shards(2, 1024);
+  DrawRedShard(shards.GetShard(red_shard_first ? 0 : 1));
+  DrawPlainShard(shards.GetShard(red_shard_first ? 1 : 0));
+  shards.Publish(canvas);
+  canvas.DrawPoint(2.0, 2.0);
+  return Interpret(test, canvas);
+}
+
+void RunTests(bool folding)
+{
+  const char* test = folding ? "transformation folding" : "no transformation folding";
+  std::vector<tDrawnPoint> points = Publish(test, true, folding);
+  std::vector<tDrawnPoint> swapped_points = Publish(test, false, folding);
+  Check(points.size() == 4 && swapped_points.size() == 4, test, "expected four points");
+  if (points.size() != 4 || swapped_points.size() != 4)
+  {
+    return;
+  }
+
+  Check(points[0] == tDrawnPoint(100, 100, 0, 0, 255, 0.5), test, "point drawn before Publish() changed");
+  Check(points[1] == tDrawnPoint(11, 1, 255, 0, 0, 1.0), test, "first shard is not drawn with its own transformation, color and Z");
+  Check(points[2] == tDrawnPoint(1, 21, 0, 0, 255, 0.5), test, "second shard is affected by first shard");
+  Check(swapped_points[1] == points[2] && swapped_points[2] == points[1], test, "result depends on order of shards");
+
+  // Without folding, the canvas' transformation cannot be restored (it is reset)
+  tDrawnPoint after_publish = folding ? tDrawnPoint(102, 102, 0, 0, 255, 0.5) : tDrawnPoint(2, 2, 0, 0, 255, 0.5);
+  Check(points[3] == after_publish && swapped_points[3] == after_publish, test, "point drawn after Publish() is affected by shards");
+}
+
+}
+
+int main()
+{
+  RunTests(false);
+  RunTests(true);
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,242 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/delta_encoded_points.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of delta encoded line strips, polygons and splines (eDRAW_DELTA_ENCODED_POINTS).
+ *
+ * Zigzag encoding and varints are checked with boundary values. Paths are drawn with
+ * tCanvas2D::DrawDeltaEncodedLineStrip() etc., decoded with tCanvasCommand::DecodeDeltaEncodedPoints() -
+ * and every decoded coordinate is checked to be within resolution/2 of the original coordinate.
+ * Covered are random walks (1-2 bytes per coordinate), paths with large jumps (multi-byte varints),
+ * empty paths, single points, float points and paths with more than 65535 points.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvasReader.h"
+#include "rrlib/canvas/internal/delta_encoding.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+void TestVarints()
+{
+  const char* test = "zigzag varints";
+  const int64_t cVALUES[] = { 0, 1, -1, 63, -64, 64, -65, 8191, -8192, 1ll << 52, -(1ll << 52), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() };
+  const size_t cBYTES[] = { 1, 1, 1, 1, 1, 2, 2, 2, 2, 8, 8, 10, 10 };
+  for (size_t i = 0; i < sizeof(cVALUES) / sizeof(cVALUES[0]); i++)
+  {
+    uint64_t encoded = internal::ZigZagEncode(cVALUES[i]);
+    Check(static_cast<int64_t>(internal::ZigZagDecode(encoded)) == cVALUES[i], test, "zigzag decoding does not restore value");
+    uint8_t buffer[internal::cMAX_VARINT_BYTES + 1];
+    buffer[internal::cMAX_VARINT_BYTES] = 0xAA;
+    size_t bytes = internal::WriteVarint(encoded, buffer);
+    Check(bytes == cBYTES[i], test, "unexpected size of varint");
+    const uint8_t* data = buffer;
+    Check(internal::ReadVarint(data) == encoded && data == buffer + bytes, test, "varint is not read back");
+    Check(buffer[internal::cMAX_VARINT_BYTES] == 0xAA, test, "varint exceeds maximum size");
+  }
+  Check(internal::Quantize(2.5) == 3 && internal::Quantize(-2.5) == -3 && internal::Quantize(-2.4) == -2, test, "unexpected rounding");
+  Check(internal::Quantize(1e300) == (1ll << 52) && internal::Quantize(-1e300) == -(1ll << 52), test, "quantized values are not clamped");
+}
+
+/*!
+ * Draws path with delta encoded points, decodes it and checks error bound
+ *
+ * \param primitive Primitive to draw (eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE)
+ * \return Size of command in bytes
+ */
+template <typename T>
+size_t TestRoundTrip(const char* test, const std::vector<tVector<2, T>>& points, double resolution, tCanvasOpCode primitive)
+{
+  tCanvas2D canvas;
+  if (primitive == eDRAW_LINE_STRIP)
+  {
+    canvas.DrawDeltaEncodedLineStrip(points.begin(), points.end(), resolution);
+  }
+  else if (primitive == eDRAW_POLYGON)
+  {
+    canvas.DrawDeltaEncodedPolygon(points.begin(), points.end(), resolution);
+  }
+  else
+  {
+    canvas.DrawDeltaEncodedSpline(points.begin(), points.end(), resolution, 0.75f);
+  }
+
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  size_t command_count = 0;
+  while (reader.Next(command))
+  {
+    command_count++;
+    Check(command.opcode == eDRAW_DELTA_ENCODED_POINTS, test, "unexpected command");
+    Check(command.primitive == primitive, test, "unexpected primitive");
+    Check(command.count == points.size(), test, "unexpected number of points");
+    Check(primitive != eDRAW_SPLINE || command.tension == 0.75f, test, "unexpected tension");
+    Check(command.parameters.Size() == 3 && command.parameters.NumberType() == eDOUBLE && command.parameters.Get<double>(2) == resolution, test, "unexpected parameters");
+    if (command.count != points.size() || points.empty())
+    {
+      continue;
+    }
+
+    std::vector<double> decoded(command.count * 2);
+    command.DecodeDeltaEncodedPoints(decoded.data());
+    std::vector<float> decoded_float(command.count * 2);
+    command.DecodeDeltaEncodedPoints(decoded_float.data());
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      for (size_t j = 0; j < 2; j++)
+      {
+        double original = static_cast<double>(points[i][j]);
+        double error = std::fabs(decoded[i * 2 + j] - original);
+
+        // allow rounding errors of the decoding arithmetic
+        double bound = resolution / 2 + 4 * std::numeric_limits<double>::epsilon() * (std::fabs(original) + std::fabs(original - static_cast<double>(points[0][j])));
+        if (error > bound || decoded_float[i * 2 + j] != static_cast<float>(decoded[i * 2 + j]))
+        {
+          printf("FAILED %s: point %zu, coordinate %zu: error %g exceeds resolution/2 = %g\n", test, i, j, error, resolution / 2);
+          failures++;
+          return canvas.GetSize();
+        }
+      }
+    }
+    Check(decoded[0] == static_cast<double>(points[0][0]) && decoded[1] == static_cast<double>(points[0][1]), test, "first point is not exact");
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  Check(command_count == 1, test, "expected exactly one command");
+  return canvas.GetSize();
+}
+
+void RunTests()
+{
+  typedef tVector<2, double> tPoint;
+  std::mt19937 generator(42);
+  std::normal_distribution<double> step(0, 0.02);
+  const double cRESOLUTION = 0.001;
+
+  // Random walk (e.g. planned path)
+  std::vector<tPoint> walk(1, tPoint(1234.5678, -98.7654321));
+  for (size_t i = 1; i < 10000; i++)
+  {
+    walk.push_back(tPoint(walk.back()[0] + step(generator), walk.back()[1] + step(generator)));
+  }
+  size_t size = TestRoundTrip("random walk", walk, cRESOLUTION, eDRAW_LINE_STRIP);
+  Check(size < walk.size() * 2 * 2 + 64, "random walk", "more than 2 bytes per coordinate");
+  TestRoundTrip("random walk polygon", walk, cRESOLUTION, eDRAW_POLYGON);
+  TestRoundTrip("random walk spline", walk, cRESOLUTION, eDRAW_SPLINE);
+
+  // Large jumps and coarse resolution
+  std::uniform_real_distribution<double> jump(-1e6, 1e6);
+  std::vector<tPoint> jumps;
+  for (size_t i = 0; i < 1000; i++)
+  {
+    jumps.push_back(tPoint(jump(generator), jump(generator)));
+  }
+  TestRoundTrip("large jumps", jumps, cRESOLUTION, eDRAW_LINE_STRIP);
+  TestRoundTrip("coarse resolution", jumps, 1000.0, eDRAW_POLYGON);
+
+  // Float points
+  std::vector<tVector<2, float>> float_walk;
+  for (const tPoint& point : walk)
+  {
+    float_walk.push_back(tVector<2, float>(static_cast<float>(point[0] - 1234), static_cast<float>(point[1])));
+  }
+  TestRoundTrip("float points", float_walk, cRESOLUTION, eDRAW_LINE_STRIP);
+
+  // Special cases
+  TestRoundTrip("no points", std::vector<tPoint>(), cRESOLUTION, eDRAW_LINE_STRIP);
+  TestRoundTrip("single point", std::vector<tPoint>(1, tPoint(-3.25, 7)), cRESOLUTION, eDRAW_SPLINE);
+  TestRoundTrip("identical points", std::vector<tPoint>(100, tPoint(-3.25, 7)), cRESOLUTION, eDRAW_POLYGON);
+
+  std::vector<tPoint> long_path;
+  for (size_t i = 0; i < 70000; i++)
+  {
+    long_path.push_back(tPoint(std::cos(i * 0.0001) * 50, std::sin(i * 0.0001) * 50));
+  }
+  TestRoundTrip("more than 65535 points", long_path, cRESOLUTION, eDRAW_LINE_STRIP);
+}
+
+}
+
+int main()
+{
+  TestVarints();
+  RunTests();
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
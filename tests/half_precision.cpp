@@ -0,0 +1,274 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/half_precision.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of half precision coordinates (eHALF number type - see tCanvas::SetCoordinatePrecision()).
+ *
+ * Conversion: every half precision value must be converted to float and back without change -
+ * and batch conversion (F16C, if available) must yield the same results as scalar conversion.
+ * Canvases: primitives and point clouds are drawn with eHALF_PRECISION and decoded with tCanvasReader.
+ * Every decoded coordinate must be within half precision rounding error of the original coordinate -
+ * coordinates beyond +-65504 must become infinity. Z values must be written with full precision.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvas3D.h"
+#include "rrlib/canvas/tCanvasReader.h"
+#include "rrlib/canvas/internal/half_precision.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * \return Whether decoded value is original value with half precision
+ *         (relative error of 2^-11 - plus rounding of double values to float - and absolute error of 2^-25 for subnormal values)
+ */
+bool IsHalfPrecision(double original, double decoded)
+{
+  if (std::fabs(original) > 65520)
+  {
+    return std::isinf(decoded) && (decoded > 0) == (original > 0);
+  }
+  return std::fabs(decoded - original) <= std::fabs(original) * (std::ldexp(1.0, -11) + std::ldexp(1.0, -23)) + std::ldexp(1.0, -25);
+}
+
+void TestConversion()
+{
+  const char* test = "conversion";
+  size_t errors = 0;
+  for (uint32_t half = 0; half <= 0xFFFF; half++)
+  {
+    float value = internal::HalfToFloat(static_cast<uint16_t>(half));
+    bool nan = (half & 0x7C00) == 0x7C00 && (half & 0x3FF);
+    if ((!nan) && internal::FloatToHalf(value) != half)
+    {
+      errors++;
+    }
+  }
+  Check(errors == 0, test, "half precision values change when converted to float and back");
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> exponent(-30, 17);
+  std::vector<float> values;
+  for (size_t i = 0; i < 10000; i++)
+  {
+    values.push_back((i % 2 ? -1 : 1) * std::exp2(exponent(generator)));
+  }
+  std::vector<double> double_values(values.begin(), values.end());
+  std::vector<uint16_t> batch(values.size()), double_batch(values.size());
+  internal::ConvertToHalf(values.data(), values.size(), batch.data());
+  internal::ConvertToHalf(double_values.data(), double_values.size(), double_batch.data());
+  std::vector<float> converted_back(values.size());
+  internal::ConvertFromHalf(reinterpret_cast<const char*>(batch.data()), batch.size(), converted_back.data());
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (batch[i] != internal::FloatToHalf(values[i]) || double_batch[i] != batch[i] || converted_back[i] != internal::HalfToFloat(batch[i]) ||
+        (!IsHalfPrecision(values[i], converted_back[i])))
+    {
+      printf("FAILED %s: value %g: batch conversion differs from scalar conversion or exceeds error bound\n", test, values[i]);
+      failures++;
+      return;
+    }
+  }
+}
+
+/*!
+ * Checks that command's values are written with half precision - and are close to expected values
+ */
+void CheckValues(const char* test, const tCanvasCommand& command, const std::vector<double>& expected)
+{
+  Check(command.values.NumberType() == eHALF, test, "values are not written with half precision");
+  Check(command.values.Size() == expected.size(), test, "unexpected number of values");
+  std::vector<double> decoded(command.values.Size());
+  command.values.CopyTo(decoded.data());
+  for (size_t i = 0; i < std::min(decoded.size(), expected.size()); i++)
+  {
+    if (command.values.Get<double>(i) != decoded[i] || (!IsHalfPrecision(expected[i], decoded[i])))
+    {
+      printf("FAILED %s: value %zu: %g decoded as %g\n", test, i, expected[i], decoded[i]);
+      failures++;
+      return;
+    }
+  }
+}
+
+void Test2D()
+{
+  const char* test = "2D canvas";
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> distribution(-100, 100);
+  std::vector<tVector<2, double>> strip;
+  std::vector<double> strip_values;
+  for (size_t i = 0; i < 1000; i++)
+  {
+    strip.push_back(tVector<2, double>(distribution(generator), distribution(generator) * 0.001));
+    strip_values.push_back(strip.back()[0]);
+    strip_values.push_back(strip.back()[1]);
+  }
+
+  tCanvas2D canvas;
+  canvas.SetCoordinatePrecision(eHALF_PRECISION);
+  canvas.SetZ(1234.56789);
+  canvas.DrawPoint(0.1, -70000.0);
+  canvas.DrawLineStrip(strip.begin(), strip.end());
+  canvas.DrawBox(1.0f / 3, 65504.0f, 0.25f, 1e-6f);
+
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  size_t command_count = 0;
+  while (reader.Next(command))
+  {
+    switch (command_count++)
+    {
+    case 0:
+      Check(command.opcode == eSET_Z && command.values.NumberType() == eDOUBLE && command.values.Get<double>(0) == 1234.56789, test, "Z is not written with full precision");
+      break;
+    case 1:
+      CheckValues(test, command, std::vector<double> { 0.1, -70000.0 });
+      break;
+    case 2:
+      Check(command.count == strip.size(), test, "unexpected number of points in line strip");
+      CheckValues(test, command, strip_values);
+      break;
+    case 3:
+      CheckValues(test, command, std::vector<double> { 1.0f / 3, 65504.0f, 0.25f, 1e-6f });
+      break;
+    }
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  Check(command_count == 4, test, "expected four commands");
+}
+
+void Test3D()
+{
+  const char* test = "3D point clouds";
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<float> distribution(-20, 20);
+  std::vector<tVector<3, float>> points;
+  std::list<tVector<3, double>> point_list;
+  std::vector<tVector<6, float>> colored_points;
+  std::vector<float> x, y, z;
+  std::vector<double> values, colored_values;
+  for (size_t i = 0; i < 3000; i++)
+  {
+    points.push_back(tVector<3, float>(distribution(generator), distribution(generator), distribution(generator)));
+    point_list.push_back(tVector<3, double>(points.back()[0], points.back()[1], points.back()[2]));
+    colored_points.push_back(tVector<6, float>(points.back()[0], points.back()[1], points.back()[2], i % 256, 255, 0));
+    x.push_back(points.back()[0]);
+    y.push_back(points.back()[1]);
+    z.push_back(points.back()[2]);
+    for (size_t j = 0; j < 6; j++)
+    {
+      if (j < 3)
+      {
+        values.push_back(points.back()[j]);
+      }
+      colored_values.push_back(colored_points.back()[j]);
+    }
+  }
+
+  tCanvas3D canvas;
+  canvas.SetCoordinatePrecision(eHALF_PRECISION);
+  canvas.DrawPointCloud(points.begin(), points.end());
+  canvas.DrawPointCloud(point_list.begin(), point_list.end());
+  canvas.DrawPointCloud(x.data(), y.data(), z.data(), x.size());
+  canvas.DrawColoredPointCloud(colored_points.begin(), colored_points.end());
+
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  size_t command_count = 0;
+  while (reader.Next(command))
+  {
+    Check(command.count == points.size(), test, "unexpected number of points");
+    CheckValues(test, command, command_count++ < 3 ? values : colored_values);
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  Check(command_count == 4, test, "expected four commands");
+}
+
+}
+
+int main()
+{
+  TestConversion();
+  Test2D();
+  Test3D();
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,222 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/long_point_lists.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of 2D line strips, polygons and splines with more than 65535 points.
+ *
+ * By default, they must be written as single commands with 32 bit point count
+ * (eDRAW_LINE_STRIP_LONG, eDRAW_POLYGON_LONG and eDRAW_SPLINE_LONG) - primitives with
+ * up to 65535 points with the original opcodes. With legacy point counts (tCanvas::SetLegacyPointCounts()),
+ * line strips and splines must be split into commands with at most 65535 points that share their
+ * end points - polygons must be written as shapes. In all cases, the points decoded with tCanvasReader
+ * must be the original points.
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas2D.h"
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Maximum number of points of commands with 16 bit point count */
+const size_t cMAX_SHORT_COUNT = 65535;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * \return Opcode with 32 bit point count that corresponds to primitive
+ */
+tCanvasOpCode GetLongOpcode(tCanvasOpCode primitive)
+{
+  return primitive == eDRAW_LINE_STRIP ? eDRAW_LINE_STRIP_LONG : (primitive == eDRAW_POLYGON ? eDRAW_POLYGON_LONG : eDRAW_SPLINE_LONG);
+}
+
+/*!
+ * Appends points of command to vector
+ */
+void AppendPoints(const tCanvasCommand& command, std::vector<float>& points)
+{
+  size_t offset = points.size();
+  points.resize(offset + command.values.Size());
+  command.values.CopyTo(points.data() + offset);
+}
+
+/*!
+ * Draws primitive, decodes it and compares decoded points with original points
+ *
+ * \param primitive Primitive to draw (eDRAW_LINE_STRIP, eDRAW_POLYGON or eDRAW_SPLINE)
+ * \param legacy Whether legacy point counts are enabled
+ * \param arrays Whether line strip is drawn from separate coordinate arrays
+ */
+void TestRoundTrip(const char* test, tCanvasOpCode primitive, size_t count, bool legacy, bool arrays = false)
+{
+  std::vector<tVector<2, float>> points;
+  std::vector<float> x, y, expected;
+  for (size_t i = 0; i < count; i++)
+  {
+    points.push_back(tVector<2, float>(std::cos(i * 0.001f) * i, std::sin(i * 0.001f)));
+    x.push_back(points.back()[0]);
+    y.push_back(points.back()[1]);
+    expected.push_back(points.back()[0]);
+    expected.push_back(points.back()[1]);
+  }
+
+  tCanvas2D canvas;
+  canvas.SetLegacyPointCounts(legacy);
+  if (arrays)
+  {
+    canvas.DrawLineStrip(x.data(), y.data(), count);
+  }
+  else if (primitive == eDRAW_LINE_STRIP)
+  {
+    canvas.DrawLineStrip(points.begin(), points.end());
+  }
+  else if (primitive == eDRAW_POLYGON)
+  {
+    canvas.DrawPolygon(points.begin(), points.end());
+  }
+  else
+  {
+    canvas.DrawSpline(points.begin(), points.end(), 0.25f);
+  }
+
+  // Points of all commands (end points shared by consecutive commands are only added once)
+  std::vector<float> decoded;
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  std::vector<tCanvasOpCode> opcodes;
+  while (reader.Next(command))
+  {
+    opcodes.push_back(command.opcode);
+    if (command.opcode == primitive || command.opcode == GetLongOpcode(primitive))
+    {
+      Check(command.count * 2 == command.values.Size(), test, "point count does not match number of values");
+      Check(primitive != eDRAW_SPLINE || command.tension == 0.25f, test, "unexpected tension");
+      if (decoded.size())
+      {
+        Check(decoded[decoded.size() - 2] == command.values.Get<float>(0) && decoded.back() == command.values.Get<float>(1), test, "commands do not share end points");
+        decoded.resize(decoded.size() - 2);
+      }
+    }
+    if (command.opcode != ePATH_END_CLOSED)
+    {
+      AppendPoints(command, decoded);
+    }
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  Check(decoded == expected, test, "decoded points differ from original points");
+
+  if (!legacy || count <= cMAX_SHORT_COUNT)
+  {
+    Check(opcodes.size() == 1, test, "expected exactly one command");
+    Check(opcodes[0] == (count > cMAX_SHORT_COUNT ? GetLongOpcode(primitive) : primitive), test, "unexpected opcode");
+  }
+  else if (primitive == eDRAW_POLYGON)
+  {
+    Check(opcodes.size() == count + 1 && opcodes[0] == ePATH_START && opcodes[1] == ePATH_LINE && opcodes.back() == ePATH_END_CLOSED, test, "polygon is not written as shape");
+  }
+  else
+  {
+    Check(opcodes.size() == (count - 2) / (cMAX_SHORT_COUNT - 1) + 1, test, "unexpected number of commands");
+    for (tCanvasOpCode opcode : opcodes)
+    {
+      Check(opcode == primitive, test, "commands with 32 bit point count are written with legacy point counts");
+    }
+  }
+}
+
+}
+
+int main()
+{
+  const tCanvasOpCode cPRIMITIVES[] = { eDRAW_LINE_STRIP, eDRAW_POLYGON, eDRAW_SPLINE };
+  const size_t cCOUNTS[] = { 2, cMAX_SHORT_COUNT, cMAX_SHORT_COUNT + 1, 2 * cMAX_SHORT_COUNT - 1, 200000 };
+  for (tCanvasOpCode primitive : cPRIMITIVES)
+  {
+    for (size_t count : cCOUNTS)
+    {
+      TestRoundTrip("32 bit point counts", primitive, count, false);
+      TestRoundTrip("legacy point counts", primitive, count, true);
+    }
+  }
+  for (size_t count : cCOUNTS)
+  {
+    TestRoundTrip("line strip from arrays", eDRAW_LINE_STRIP, count, false, true);
+    TestRoundTrip("line strip from arrays - legacy point counts", eDRAW_LINE_STRIP, count, true, true);
+  }
+
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,199 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    tests/quantized_point_cloud.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-16
+ *
+ * Round-trip test of tCanvas3D::DrawQuantizedPointCloud().
+ *
+ * Point clouds are quantized, decoded with tCanvasReader - and every decoded
+ * coordinate is checked to be within step/2 of the original coordinate.
+ * Covered are random clouds, a single point, clouds with zero extent, clouds whose
+ * extent exceeds 65535 * resolution (step is increased) and clouds with NaN points
+ * (which are omitted).
+ *
+ * Returns 0 if all checks pass.
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/canvas/tCanvas3D.h"
+#include "rrlib/canvas/tCanvasReader.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::canvas;
+using rrlib::math::tVector;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+size_t failures = 0;
+
+void Check(bool condition, const char* test, const char* message)
+{
+  if (!condition)
+  {
+    printf("FAILED %s: %s\n", test, message);
+    failures++;
+  }
+}
+
+/*!
+ * Quantizes points, decodes them and checks error bound
+ *
+ * \param expected_step Step that quantization must use (0 if it is not checked)
+ */
+template <typename T>
+void TestRoundTrip(const char* test, const std::vector<tVector<3, T>>& points, double resolution, double expected_step = 0)
+{
+  tCanvas3D canvas;
+  double step = canvas.DrawQuantizedPointCloud(points.begin(), points.end(), resolution);
+  Check(step >= resolution, test, "step is smaller than resolution");
+  if (expected_step > 0)
+  {
+    Check(std::fabs(step - expected_step) <= expected_step * 1e-12, test, "unexpected step");
+  }
+
+  std::vector<tVector<3, T>> finite_points;
+  for (const tVector<3, T>& point : points)
+  {
+    if (std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2]))
+    {
+      finite_points.push_back(point);
+    }
+  }
+
+  tCanvasReader reader(canvas);
+  tCanvasCommand command;
+  size_t command_count = 0;
+  while (reader.Next(command))
+  {
+    command_count++;
+    Check(command.opcode == eDRAW_QUANTIZED_POINT_CLOUD, test, "unexpected command");
+    Check(command.count == finite_points.size(), test, "point count does not match number of finite points");
+    Check(command.parameters.Get<double>(3) == step, test, "serialized step differs from returned step");
+    for (size_t i = 0; i < std::min<size_t>(command.count, finite_points.size()); i++)
+    {
+      for (size_t j = 0; j < 3; j++)
+      {
+        double original = static_cast<double>(finite_points[i][j]);
+        double error = std::fabs(command.GetQuantizedPointCoordinate(i, j) - original);
+
+        // allow rounding errors of the decoding arithmetic
+        double bound = step / 2 + 4 * std::numeric_limits<double>::epsilon() * (std::fabs(original) + 65535 * step);
+        if (error > bound)
+        {
+          printf("FAILED %s: point %zu, coordinate %zu: error %g exceeds step/2 = %g\n", test, i, j, error, step / 2);
+          failures++;
+          return;
+        }
+      }
+    }
+  }
+  Check(!reader.IsMalformed(), test, "canvas data is malformed");
+  Check(command_count == 1, test, "expected exactly one command");
+}
+
+template <typename T>
+void RunTests()
+{
+  typedef tVector<3, T> tPoint;
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(-5, 5);
+  const double cRESOLUTION = 0.001;
+
+  std::vector<tPoint> random_points;
+  for (size_t i = 0; i < 10000; i++)
+  {
+    random_points.push_back(tPoint(distribution(generator), distribution(generator), distribution(generator)));
+  }
+  TestRoundTrip("random points", random_points, 0.05, 0.05);
+  TestRoundTrip("random points - extent larger than 65535 * resolution", random_points, 1e-6);
+
+  TestRoundTrip("single point", std::vector<tPoint>(1, tPoint(1.5, -2.25, 1000)), cRESOLUTION, cRESOLUTION);
+  TestRoundTrip("zero extent", std::vector<tPoint>(100, tPoint(-3, 7, 0.125)), cRESOLUTION, cRESOLUTION);
+  TestRoundTrip("no points", std::vector<tPoint>(), cRESOLUTION, cRESOLUTION);
+
+  std::vector<tPoint> line;
+  for (size_t i = 0; i <= 1000; i++)
+  {
+    line.push_back(tPoint(i * 100.0, 0, -(i * 0.5)));
+  }
+  TestRoundTrip("extent larger than 65535 * resolution", line, cRESOLUTION, 100000.0 / 65535);
+
+  const T cNAN = std::numeric_limits<T>::quiet_NaN();
+  std::vector<tPoint> points_with_nan = random_points;
+  for (size_t i = 0; i < points_with_nan.size(); i += 7)
+  {
+    points_with_nan[i][i % 3] = cNAN;
+  }
+  points_with_nan[1] = tPoint(cNAN, cNAN, cNAN);
+  points_with_nan[2][0] = std::numeric_limits<T>::infinity();
+  TestRoundTrip("NaN points", points_with_nan, cRESOLUTION);
+  TestRoundTrip("NaN points only", std::vector<tPoint>(10, tPoint(cNAN, cNAN, cNAN)), cRESOLUTION, cRESOLUTION);
+}
+
+}
+
+int main()
+{
+  RunTests<float>();
+  RunTests<double>();
+  if (failures)
+  {
+    printf("%zu checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}